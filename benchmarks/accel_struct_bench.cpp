@@ -0,0 +1,209 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/aabb_utils.h>
+#include <photon/accel_struct.h>
+#include <photon/device_context.h>
+#include "bench_utils.h"
+
+/*********************************************************************************
+****************************    accel_struct_bench    ****************************
+*********************************************************************************/
+
+//!	Build (fast trace, updatable), refit and rebuild of one GAS.
+template<typename AccelStruct, typename BuildInput> static void measureGas(bench::Report & report, ns::Stream & stream, ns::AllocPtr allocator,
+																		   AccelStruct & accelStruct, const BuildInput & buildInput, const char * type, size_t count)
+{
+	const std::string suffix = std::string("/") + type;
+
+	bench::measureDevice(report, stream, "gas/build" + suffix, count, [&]() { accelStruct.build(stream, allocator, buildInput, 0, true, true); });
+
+	if (accelStruct.empty())
+	{
+		accelStruct.build(stream, allocator, buildInput, 0, true, true);
+	}
+
+	bench::measureDevice(report, stream, "gas/refit" + suffix, count, [&]() { accelStruct.refit(stream); });
+	bench::measureDevice(report, stream, "gas/rebuild" + suffix, count, [&]() { accelStruct.rebuild(stream); });
+}
+
+
+void accel_struct_bench(bench::Report & report)
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	const size_t sizes[] = { 1 << 14, 1 << 17, 1 << 20 };
+
+	for (size_t count : sizes)
+	{
+		std::vector<ns::float3_16a> vertices;
+		std::vector<ns::int3_16a> triangles;
+		bench::makeTriangleMesh(count, vertices, triangles);
+
+		ns::Array<ns::float3_16a>		devVertices(allocator, vertices.size());
+		ns::Array<ns::int3_16a>			devTriangles(allocator, triangles.size());
+		stream.memcpy(devVertices.data(), vertices.data(), vertices.size());
+		stream.memcpy(devTriangles.data(), triangles.data(), triangles.size());
+
+		pt::AccelStructTriangle::BuildInput buildInput;
+		buildInput.vertexBuffer = devVertices;
+		buildInput.indexBuffer = devTriangles;
+		buildInput.numVertices = static_cast<unsigned int>(vertices.size());
+		buildInput.numIndexTriplets = static_cast<unsigned int>(triangles.size());
+
+		auto accelStruct = deviceContext->createAccelStructTriangle();
+
+		measureGas(report, stream, allocator, *accelStruct, buildInput, "triangle", triangles.size());
+	}
+
+	for (size_t count : sizes)
+	{
+		auto points = bench::makePointCloud(count);
+
+		ns::Array<ns::float3_16a>		devPoints(allocator, count);
+		ns::Array<pt::Aabb>				devAabbs(allocator, count);
+		stream.memcpy(devPoints.data(), points.data(), count);
+
+		pt::AabbSource aabbSource;
+		aabbSource.type = pt::AabbSource::Points;
+		aabbSource.vertexBuffer = devPoints;
+		aabbSource.radius = 1e-3f;
+		aabbSource.numPrimitives = static_cast<unsigned int>(count);
+		pt::computeAabbs(stream, devAabbs, aabbSource);
+
+		pt::AccelStructAabb::BuildInput buildInput;
+		buildInput.aabbBuffer = devAabbs;
+		buildInput.numPrimitives = static_cast<unsigned int>(count);
+
+		auto accelStruct = deviceContext->createAccelStructAabb();
+
+		measureGas(report, stream, allocator, *accelStruct, buildInput, "aabb", count);
+	}
+
+#if OPTIX_VERSION >= 70500
+	for (size_t count : sizes)
+	{
+		auto points = bench::makePointCloud(count);
+		const float radius = 1e-3f;
+
+		ns::Array<ns::float3_16a>		devPoints(allocator, count);
+		ns::Array<float>				devRadius(allocator, 1);
+		stream.memcpy(devPoints.data(), points.data(), count);
+		stream.memcpy(devRadius.data(), &radius, 1);
+
+		pt::AccelStructSphere::BuildInput buildInput;
+		buildInput.vertexBuffer = devPoints;
+		buildInput.radiusBuffer = devRadius;
+		buildInput.numVertices = static_cast<unsigned int>(count);
+		buildInput.singleRadius = true;
+
+		auto accelStruct = deviceContext->createAccelStructSphere();
+
+		measureGas(report, stream, allocator, *accelStruct, buildInput, "sphere", count);
+	}
+#endif
+
+#if OPTIX_VERSION >= 70100
+	for (size_t count : sizes)
+	{
+		std::vector<ns::float3_16a> vertices;
+		std::vector<uint32_t> segments;
+		bench::makeStrands(count, 8, vertices, segments);
+		std::vector<float> widths(vertices.size(), 2e-4f);
+
+		ns::Array<ns::float3_16a>		devVertices(allocator, vertices.size());
+		ns::Array<uint32_t>				devSegments(allocator, segments.size());
+		ns::Array<float>				devWidths(allocator, widths.size());
+		stream.memcpy(devVertices.data(), vertices.data(), vertices.size());
+		stream.memcpy(devSegments.data(), segments.data(), segments.size());
+		stream.memcpy(devWidths.data(), widths.data(), widths.size());
+
+		pt::AccelStructCurve::BuildInput buildInput;
+		buildInput.vertexBuffer = devVertices;
+		buildInput.indexBuffer = devSegments;
+		buildInput.widthBuffer = devWidths;
+		buildInput.numVertices = static_cast<unsigned int>(vertices.size());
+		buildInput.numPrimitives = static_cast<unsigned int>(segments.size());
+
+		auto accelStruct = deviceContext->createAccelStructCurve();
+
+		measureGas(report, stream, allocator, *accelStruct, buildInput, "curve", count);
+	}
+#endif
+
+	//	IAS over a shared triangle GAS: updates include the transform gather of all instances.
+	{
+		std::vector<ns::float3_16a> vertices;
+		std::vector<ns::int3_16a> triangles;
+		bench::makeTriangleMesh(1 << 10, vertices, triangles);
+
+		ns::Array<ns::float3_16a>		devVertices(allocator, vertices.size());
+		ns::Array<ns::int3_16a>			devTriangles(allocator, triangles.size());
+		stream.memcpy(devVertices.data(), vertices.data(), vertices.size());
+		stream.memcpy(devTriangles.data(), triangles.data(), triangles.size());
+
+		pt::AccelStructTriangle::BuildInput gasInput;
+		gasInput.vertexBuffer = devVertices;
+		gasInput.indexBuffer = devTriangles;
+		gasInput.numVertices = static_cast<unsigned int>(vertices.size());
+		gasInput.numIndexTriplets = static_cast<unsigned int>(triangles.size());
+
+		std::shared_ptr<pt::AccelStructTriangle> geomAccelStruct = deviceContext->createAccelStructTriangle();
+		geomAccelStruct->build(stream, allocator, gasInput, 0, true, false);
+
+		for (size_t count : { size_t(1) << 8, size_t(1) << 12, size_t(1) << 16 })
+		{
+			auto transforms = bench::makeInstanceTransforms(count);
+
+			ns::Array<pt::Mat4x4> devTransforms(allocator, count);
+			stream.memcpy(devTransforms.data(), transforms.data(), count);
+
+			std::vector<pt::InstAccelStruct::BuildInput> buildInputs(count);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				buildInputs[i].geomAccelStruct = geomAccelStruct;
+				buildInputs[i].transform = dev::Ptr<const pt::Mat4x4>(devTransforms.data() + i, 1);
+				buildInputs[i].instanceId = static_cast<unsigned int>(i);
+			}
+
+			auto instAccelStruct = deviceContext->createInstAccelStruct();
+
+			bench::measureDevice(report, stream, "ias/build", count, [&]() { instAccelStruct->build(stream, allocator, buildInputs, true, true); });
+
+			if (instAccelStruct->empty())
+			{
+				instAccelStruct->build(stream, allocator, buildInputs, true, true);
+			}
+
+			bench::measureDevice(report, stream, "ias/update", count, [&]() { instAccelStruct->refit(stream); });
+		}
+	}
+}
\ No newline at end of file
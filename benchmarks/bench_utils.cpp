@@ -0,0 +1,195 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "bench_utils.h"
+#include <optix.h>
+#include <stdio.h>
+#include <math.h>
+
+/*********************************************************************************
+**********************************    Report    **********************************
+*********************************************************************************/
+
+void bench::Report::add(const std::string & name, size_t size, std::vector<double> durationsMs)
+{
+	if (durationsMs.empty())
+	{
+		return;
+	}
+
+	std::sort(durationsMs.begin(), durationsMs.end());
+
+	Result result;
+	result.name = name;
+	result.size = size;
+	result.iterations = static_cast<unsigned int>(durationsMs.size());
+	result.minMs = durationsMs.front();
+	result.medianMs = durationsMs[durationsMs.size() / 2];
+
+	for (double duration : durationsMs)
+	{
+		result.meanMs += duration / durationsMs.size();
+	}
+
+	printf("%-40s %10zu %12.4f ms (min %.4f ms)\n", name.c_str(), size, result.medianMs, result.minMs);
+
+	m_results.push_back(result);
+}
+
+
+bool bench::Report::write(const std::string & device) const
+{
+	FILE * file = fopen(m_options.output.c_str(), "w");
+
+	if (file == nullptr)
+	{
+		printf("Failed to open %s.\n", m_options.output.c_str());
+
+		return false;
+	}
+
+	//	Names and device strings never contain characters to be escaped.
+	fprintf(file, "{\n\"context\":{\"optixVersion\":%d,\"device\":\"%s\",\"hostOnly\":%s,\"iterations\":%u,\"warmup\":%u},\n\"benchmarks\":[",
+			OPTIX_VERSION, device.c_str(), device.empty() ? "true" : "false", m_options.iterations, m_options.warmup);
+
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		const Result & result = m_results[i];
+
+		fprintf(file, "%s\n{\"name\":\"%s\",\"size\":%zu,\"iterations\":%u,\"minMs\":%.6f,\"medianMs\":%.6f,\"meanMs\":%.6f,\"itemsPerSecond\":%.1f}",
+				(i == 0) ? "" : ",", result.name.c_str(), result.size, result.iterations, result.minMs, result.medianMs, result.meanMs,
+				(result.medianMs > 0.0) ? 1e3 * result.size / result.medianMs : 0.0);
+	}
+
+	fprintf(file, "\n]}\n");
+
+	return fclose(file) == 0;
+}
+
+/*********************************************************************************
+*********************************    Datasets    *********************************
+*********************************************************************************/
+
+std::vector<ns::float3_16a> bench::makePointCloud(size_t count, uint64_t seed)
+{
+	Random random(seed);
+
+	std::vector<ns::float3_16a> points(count);
+
+	for (auto & point : points)
+	{
+		point.x = random.uniform();
+		point.y = random.uniform();
+		point.z = random.uniform();
+	}
+
+	return points;
+}
+
+
+void bench::makeTriangleMesh(size_t numTriangles, std::vector<ns::float3_16a> & vertices, std::vector<ns::int3_16a> & triangles, uint64_t seed)
+{
+	Random random(seed);
+
+	const int resolution = NS_MAX(1, static_cast<int>(sqrt(0.5 * numTriangles)));
+	const float cellSize = 1.0f / resolution;
+
+	vertices.resize(size_t(resolution + 1) * (resolution + 1));
+	triangles.resize(2 * size_t(resolution) * resolution);
+
+	for (int y = 0; y <= resolution; y++)
+	{
+		for (int x = 0; x <= resolution; x++)
+		{
+			vertices[y * (resolution + 1) + x] = ns::float3_16a{ x * cellSize, 0.1f * random.uniform(), y * cellSize };
+		}
+	}
+
+	for (int y = 0; y < resolution; y++)
+	{
+		for (int x = 0; x < resolution; x++)
+		{
+			const int v0 = y * (resolution + 1) + x;
+			const int v1 = v0 + 1;
+			const int v2 = v0 + resolution + 1;
+			const int v3 = v2 + 1;
+
+			triangles[2 * (y * resolution + x) + 0] = ns::int3_16a{ v0, v2, v1 };
+			triangles[2 * (y * resolution + x) + 1] = ns::int3_16a{ v1, v2, v3 };
+		}
+	}
+}
+
+
+void bench::makeStrands(size_t numSegments, unsigned int segmentsPerStrand, std::vector<ns::float3_16a> & vertices, std::vector<uint32_t> & segments, uint64_t seed)
+{
+	Random random(seed);
+
+	const size_t numStrands = (numSegments + segmentsPerStrand - 1) / segmentsPerStrand;
+	const float segmentLength = 0.05f / segmentsPerStrand;
+
+	vertices.clear();
+	segments.clear();
+	vertices.reserve(numStrands * (segmentsPerStrand + 1));
+	segments.reserve(numStrands * segmentsPerStrand);
+
+	for (size_t s = 0; s < numStrands; s++)
+	{
+		ns::float3_16a root = { random.uniform(), 0.0f, random.uniform() };
+
+		for (unsigned int i = 0; i <= segmentsPerStrand; i++)
+		{
+			if (i < segmentsPerStrand)
+			{
+				segments.push_back(static_cast<uint32_t>(vertices.size()));
+			}
+
+			vertices.push_back(ns::float3_16a{ root.x + 0.01f * (random.uniform() - 0.5f), i * segmentLength, root.z + 0.01f * (random.uniform() - 0.5f) });
+		}
+	}
+
+	segments.resize(numSegments);
+}
+
+
+std::vector<pt::Mat4x4> bench::makeInstanceTransforms(size_t count, uint64_t seed)
+{
+	Random random(seed);
+
+	const float extent = static_cast<float>(cbrt(double(count)));
+
+	std::vector<pt::Mat4x4> transforms(count);
+
+	for (auto & transform : transforms)
+	{
+		//	Rotation about the y axis followed by a translation.
+		const float angle = 6.2831853f * random.uniform();
+		const float c = cosf(angle), s = sinf(angle);
+
+		transform.rows[0] = ns::float4{ c, 0.0f, s, extent * random.uniform() };
+		transform.rows[1] = ns::float4{ 0.0f, 1.0f, 0.0f, extent * random.uniform() };
+		transform.rows[2] = ns::float4{ -s, 0.0f, c, extent * random.uniform() };
+		transform.rows[3] = ns::float4{ 0.0f, 0.0f, 0.0f, 1.0f };
+	}
+
+	return transforms;
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include <nucleus/stream.h>
+#include <nucleus/scoped_timer.h>
+#include <nucleus/vector_types.h>
+#include <photon/fwd.h>
+#include <algorithm>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace bench
+{
+	/*****************************************************************************
+	*******************************    Options    ********************************
+	*****************************************************************************/
+
+	//!	Command line options, see `main.cpp`.
+	struct Options
+	{
+		std::string							output = "photon_bench.json";	//!	Path of the JSON report.
+		std::string							filter;							//!	Only run benchmarks whose name contains this string.
+		unsigned int						iterations = 10;				//!	Measured iterations per configuration.
+		unsigned int						warmup = 2;						//!	Unmeasured iterations per configuration.
+		bool								hostOnly = false;				//!	Skip the GPU benchmarks.
+	};
+
+	/*****************************************************************************
+	********************************    Report    ********************************
+	*****************************************************************************/
+
+	//!	Timings of one benchmark configuration.
+	struct Result
+	{
+		std::string							name;							//!	Benchmark name, e.g. `gas/build/triangle`.
+		size_t								size = 0;						//!	Problem size (primitives, instances, records, pixels...).
+		unsigned int						iterations = 0;					//!	Number of measured iterations.
+		double								minMs = 0.0;					//!	Fastest iteration.
+		double								medianMs = 0.0;					//!	Median iteration.
+		double								meanMs = 0.0;					//!	Average iteration.
+	};
+
+
+	//!	Collects the results and writes them as JSON.
+	class Report
+	{
+
+	public:
+
+		explicit Report(const Options & options) : m_options(options) {}
+
+		const Options & options() const { return m_options; }
+
+		//!	Whether the benchmark `name` is selected by the filter.
+		bool selected(const std::string & name) const { return m_options.filter.empty() || (name.find(m_options.filter) != std::string::npos); }
+
+		//!	Add a result computed from per-iteration durations, and print it.
+		void add(const std::string & name, size_t size, std::vector<double> durationsMs);
+
+		//!	Write the report, `device` is empty for host-only runs.
+		bool write(const std::string & device) const;
+
+	private:
+
+		const Options						m_options;
+		std::vector<Result>					m_results;
+	};
+
+
+	//!	Keeps a value computed by a benchmark alive, so that the compiler can not drop the work producing it.
+	template<typename Type> inline void doNotOptimize(const Type & value)
+	{
+	#if defined(_MSC_VER)
+		static const void * volatile sink = nullptr;
+
+		sink = &value;
+
+		_ReadWriteBarrier();
+	#else
+		asm volatile("" : : "r,m"(value) : "memory");
+	#endif
+	}
+
+
+	/**
+	 *	@brief		Measure a host function, `func()` is called `warmup + iterations` times.
+	 */
+	template<typename Func> void measureHost(Report & report, const std::string & name, size_t size, Func && func)
+	{
+		if (!report.selected(name))		return;
+
+		std::vector<double> durations;
+
+		for (unsigned int i = 0; i < report.options().warmup + report.options().iterations; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			func();
+
+			auto stop = std::chrono::steady_clock::now();
+
+			if (i >= report.options().warmup)
+			{
+				durations.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+			}
+		}
+
+		report.add(name, size, std::move(durations));
+	}
+
+
+	/**
+	 *	@brief		Measure the GPU work enqueued on `stream` by `func()`, the stream is synchronized after each iteration.
+	 */
+	template<typename Func> void measureDevice(Report & report, ns::Stream & stream, const std::string & name, size_t size, Func && func)
+	{
+		if (!report.selected(name))		return;
+
+		std::vector<double> durations;
+
+		for (unsigned int i = 0; i < report.options().warmup + report.options().iterations; i++)
+		{
+			double duration = 0.0;
+			{
+				ns::ScopedTimer scopedTimer(stream, [&](std::chrono::nanoseconds ns) { duration = ns.count() * 1e-6; });
+
+				func();
+			}
+
+			if (i >= report.options().warmup)
+			{
+				durations.push_back(duration);
+			}
+		}
+
+		report.add(name, size, std::move(durations));
+	}
+
+	/*****************************************************************************
+	*******************************    Datasets    *******************************
+	*****************************************************************************/
+
+	//!	Deterministic generator (SplitMix64), independent of the standard library implementation.
+	class Random
+	{
+
+	public:
+
+		explicit Random(uint64_t seed) : m_state(seed) {}
+
+		uint64_t next()
+		{
+			uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		//!	Uniform in [0, 1).
+		float uniform() { return static_cast<float>(this->next() >> 40) * (1.0f / 16777216.0f); }
+
+	private:
+
+		uint64_t							m_state;
+	};
+
+
+	//!	`count` points uniformly distributed in the unit cube.
+	std::vector<ns::float3_16a> makePointCloud(size_t count, uint64_t seed = 1);
+
+	//!	Height field of about `numTriangles` triangles over the unit square.
+	void makeTriangleMesh(size_t numTriangles, std::vector<ns::float3_16a> & vertices, std::vector<ns::int3_16a> & triangles, uint64_t seed = 2);
+
+	//!	Linear strands of `segmentsPerStrand` segments, `numSegments` in total, returns the index of the first vertex of each segment.
+	void makeStrands(size_t numSegments, unsigned int segmentsPerStrand, std::vector<ns::float3_16a> & vertices, std::vector<uint32_t> & segments, uint64_t seed = 3);
+
+	//!	Random rigid placements of `count` instances in a cube of side `count^(1/3)`.
+	std::vector<pt::Mat4x4> makeInstanceTransforms(size_t count, uint64_t seed = 4);
+}
+
+/*********************************************************************************
+*****************************    Benchmark suites    *****************************
+*********************************************************************************/
+
+//!	Host-only suites, also run on machines without a GPU.
+extern void host_bench(bench::Report & report);
+
+//!	GPU suites.
+extern void accel_struct_bench(bench::Report & report);
+extern void pipeline_bench(bench::Report & report);
+extern void denoiser_bench(bench::Report & report);
+extern void ray_query_bench(bench::Report & report);
\ No newline at end of file
@@ -0,0 +1,107 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_2d.h>
+
+#include <photon/denoiser.h>
+#include <photon/device_context.h>
+#include "bench_utils.h"
+
+/*********************************************************************************
+******************************    denoiser_bench    ******************************
+*********************************************************************************/
+
+void denoiser_bench(bench::Report & report)
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	struct Resolution { const char * name; unsigned int width, height; };
+	struct Model { const char * name; pt::Denoiser::ModelKind kind; unsigned int outputScale; };
+
+	const Resolution resolutions[] = { { "720p", 1280, 720 }, { "1080p", 1920, 1080 }, { "2160p", 3840, 2160 } };
+
+	const Model models[] =
+	{
+		{ "normal", pt::Denoiser::Normal, 1 },
+	#if OPTIX_VERSION >= 70400
+		{ "temporal", pt::Denoiser::Temporal, 1 },
+	#endif
+	#if OPTIX_VERSION >= 70500
+		{ "upscale2x", pt::Denoiser::Upscale2x, 2 },
+	#endif
+	};
+
+	auto denoiser = deviceContext->createDenoiser();
+
+	for (const Resolution & resolution : resolutions)
+	{
+		const unsigned int width = resolution.width;
+		const unsigned int height = resolution.height;
+
+		//	Image contents do not affect the cost of the network, zeros are deterministic.
+		ns::Array2D<ns::float4>			color(allocator, width, height);
+		ns::Array2D<ns::float4>			albedo(allocator, width, height);
+		ns::Array2D<ns::float4>			normal(allocator, width, height);
+	#if OPTIX_VERSION >= 70400
+		ns::Array2D<ns::float2>			flow(allocator, width, height);
+		stream.memset(flow.data(), 0, flow.pitch() * height);
+	#endif
+		stream.memset(color.data(), 0, color.pitch() * height);
+		stream.memset(albedo.data(), 0, albedo.pitch() * height);
+		stream.memset(normal.data(), 0, normal.pitch() * height);
+
+		for (const Model & model : models)
+		{
+			ns::Array2D<ns::float4> output(allocator, model.outputScale * width, model.outputScale * height);
+			ns::Array2D<ns::float4> previousOutput(allocator, model.outputScale * width, model.outputScale * height);
+			stream.memset(previousOutput.data(), 0, previousOutput.pitch() * previousOutput.height());
+
+			denoiser->preallocate(allocator, model.kind, width, height);
+
+			pt::Denoiser::Layer layer;
+			layer.input = color.ptr();
+			layer.output = output.ptr();
+
+			pt::Denoiser::GuideLayer guideLayer;
+			guideLayer.albedo = albedo.ptr();
+			guideLayer.normal = normal.ptr();
+
+		#if OPTIX_VERSION >= 70400
+			if (model.kind == pt::Denoiser::Temporal)
+			{
+				layer.previousOutput = previousOutput.ptr();
+				guideLayer.flow = flow.ptr();
+			}
+		#endif
+
+			const std::string name = std::string("denoiser/") + model.name + "/" + resolution.name;
+
+			bench::measureDevice(report, stream, name, size_t(width) * height, [&]() { denoiser->launch(stream, layer, guideLayer, 0.0f); });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <photon/aabb_utils.h>
+#include <photon/payload_codec.h>
+#include "bench_utils.h"
+#include <vector>
+
+/*********************************************************************************
+********************************    host_bench    ********************************
+*********************************************************************************/
+
+void host_bench(bench::Report & report)
+{
+	const size_t sizes[] = { 1 << 14, 1 << 17, 1 << 20 };
+
+	for (size_t count : sizes)
+	{
+		auto points = bench::makePointCloud(count);
+		std::vector<pt::Aabb> aabbs(count);
+
+		bench::measureHost(report, "host/aabb/points", count, [&]() { pt::computePointAabbs(aabbs.data(), points.data(), nullptr, 1e-3f, count); });
+	}
+
+	for (size_t count : sizes)
+	{
+		std::vector<ns::float3_16a> vertices;
+		std::vector<ns::int3_16a> triangles;
+		bench::makeTriangleMesh(count, vertices, triangles);
+		std::vector<pt::Aabb> aabbs(triangles.size());
+
+		bench::measureHost(report, "host/aabb/triangles", triangles.size(), [&]() { pt::computeTriangleAabbs(aabbs.data(), vertices.data(), triangles.data(), 0.0f, triangles.size()); });
+	}
+
+	//	Encode and decode round trip of the packed payload codecs.
+	{
+		const size_t count = 1 << 20;
+
+		auto directions = bench::makePointCloud(count);
+		std::vector<unsigned int> slots(count);
+
+		bench::measureHost(report, "host/payload/oct_normal", count, [&]()
+		{
+			float checksum = 0.0f;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				pt::PayloadCodec<pt::OctNormal>::encode(float3{ directions[i].x - 0.5f, directions[i].y - 0.5f, directions[i].z - 0.5f }, &slots[i]);
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				checksum += pt::PayloadCodec<pt::OctNormal>::decode(&slots[i]).x;
+			}
+
+			bench::doNotOptimize(checksum);
+		});
+
+		bench::measureHost(report, "host/payload/half2", count, [&]()
+		{
+			float checksum = 0.0f;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				pt::PayloadCodec<pt::Half2>::encode(float2{ directions[i].x, directions[i].y }, &slots[i]);
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				checksum += pt::PayloadCodec<pt::Half2>::decode(&slots[i]).y;
+			}
+
+			bench::doNotOptimize(checksum);
+		});
+	}
+}
\ No newline at end of file
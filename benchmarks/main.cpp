@@ -0,0 +1,91 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <cuda_runtime.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "bench_utils.h"
+
+/*********************************************************************************
+***********************************    main    ***********************************
+*********************************************************************************/
+
+/**
+ *	Usage: photon-bench [--output <file>] [--filter <substring>] [--iterations <n>] [--warmup <n>] [--host-only]
+ *
+ *	Results are printed and written as JSON (default `photon_bench.json`). Datasets are generated
+ *	procedurally from fixed seeds, so reports of different Photon versions can be compared directly.
+ *	The GPU suites are skipped when no CUDA device is available.
+ */
+int main(int argc, char ** argv)
+{
+	bench::Options options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const bool hasValue = (i + 1 < argc);
+
+		if ((strcmp(argv[i], "--output") == 0) && hasValue)				options.output = argv[++i];
+		else if ((strcmp(argv[i], "--filter") == 0) && hasValue)		options.filter = argv[++i];
+		else if ((strcmp(argv[i], "--iterations") == 0) && hasValue)	options.iterations = NS_MAX(atoi(argv[++i]), 1);
+		else if ((strcmp(argv[i], "--warmup") == 0) && hasValue)		options.warmup = NS_MAX(atoi(argv[++i]), 0);
+		else if (strcmp(argv[i], "--host-only") == 0)					options.hostOnly = true;
+		else
+		{
+			printf("Usage: %s [--output <file>] [--filter <substring>] [--iterations <n>] [--warmup <n>] [--host-only]\n", argv[0]);
+
+			return EXIT_FAILURE;
+		}
+	}
+
+	int numDevices = 0;
+	std::string deviceName;
+
+	if (!options.hostOnly && ((cudaGetDeviceCount(&numDevices) != cudaSuccess) || (numDevices == 0)))
+	{
+		printf("No CUDA device found, running host benchmarks only.\n");
+
+		options.hostOnly = true;
+	}
+
+	if (!options.hostOnly)
+	{
+		cudaDeviceProp deviceProp = {};
+		cudaGetDeviceProperties(&deviceProp, 0);
+		deviceName = deviceProp.name;
+	}
+
+	bench::Report report(options);
+
+	host_bench(report);
+
+	if (!options.hostOnly)
+	{
+		accel_struct_bench(report);
+		pipeline_bench(report);
+		denoiser_bench(report);
+		ray_query_bench(report);
+	}
+
+	return report.write(deviceName) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/pipeline.h>
+#include <photon/device_context.h>
+#include "bench_program.optixir.h"
+#include "bench_params.h"
+#include "bench_utils.h"
+
+/*********************************************************************************
+******************************    pipeline_bench    ******************************
+*********************************************************************************/
+
+void pipeline_bench(bench::Report & report)
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "benchParams";
+	pipelineCompileOptions.traversableGraphFlags = OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_GAS;
+
+	auto module = deviceContext->createModule(bench_program_optixir, pipelineCompileOptions);
+	auto raygenProg = module->at("__raygen__empty");
+	auto closesthitProg = module->at("__closesthit__");
+	auto missProg = module->at("__miss__");
+
+	//	Cached lookups, as done when SBT records are rebuilt every frame.
+	{
+		constexpr size_t numLookups = 1000;
+
+		bench::measureHost(report, "program/lookup", numLookups, [&]()
+		{
+			for (size_t i = 0; i < numLookups; i++)
+			{
+				module->at((i % 2) ? "__miss__" : "__closesthit__");
+			}
+		});
+	}
+
+	pt::Pipeline pipeline(deviceContext, { raygenProg, closesthitProg, missProg }, pipelineCompileOptions);
+
+	ns::Array<BenchParams>			devParams(allocator, 1);
+	ns::Array<pt::EmptyRecord>		devRaygenRecord(allocator, 1);
+	ns::Array<pt::EmptyRecord>		devMissRecord(allocator, 1);
+	ns::Array<pt::EmptyRecord>		devHitRecord(allocator, 1);
+
+	BenchParams hostParams = {};
+	stream.memcpy(devParams.data(), &hostParams, 1);
+	stream.memcpy(&devRaygenRecord.data()->header, &raygenProg->header(), 1);
+	stream.memcpy(&devMissRecord.data()->header, &missProg->header(), 1);
+	stream.memcpy(&devHitRecord.data()->header, &closesthitProg->header(), 1);
+
+	OptixShaderBindingTable sbt = {};
+	sbt.raygenRecord = (CUdeviceptr)devRaygenRecord.data();
+	sbt.missRecordBase = (CUdeviceptr)devMissRecord.data();
+	sbt.missRecordStrideInBytes = sizeof(pt::EmptyRecord);
+	sbt.missRecordCount = 1;
+	sbt.hitgroupRecordBase = (CUdeviceptr)devHitRecord.data();
+	sbt.hitgroupRecordStrideInBytes = sizeof(pt::EmptyRecord);
+	sbt.hitgroupRecordCount = 1;
+
+	//	Launch overhead: back-to-back launches of a single thread.
+	{
+		constexpr size_t numLaunches = 100;
+
+		bench::measureDevice(report, stream, "pipeline/launch/1x1", numLaunches, [&]()
+		{
+			for (size_t i = 0; i < numLaunches; i++)
+			{
+				pipeline.launch<BenchParams>(stream, devParams, sbt, 1, 1);
+			}
+		});
+	}
+
+	bench::measureDevice(report, stream, "pipeline/launch/1920x1080", 1920 * 1080, [&]() { pipeline.launch<BenchParams>(stream, devParams, sbt, 1920, 1080); });
+
+	//	Upload of hit group records with per-record data from pageable host memory.
+	{
+		struct HitData { const void * vertices; const void * indices; unsigned int materialId; };
+
+		for (size_t count : { size_t(1), size_t(1) << 10, size_t(1) << 16 })
+		{
+			std::vector<pt::SbtRecord<HitData>> records(count);
+			ns::Array<pt::SbtRecord<HitData>> devRecords(allocator, count);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				records[i].header = closesthitProg->header();
+				records[i].data.materialId = static_cast<unsigned int>(i);
+			}
+
+			bench::measureDevice(report, stream, "sbt/upload", count, [&]() { stream.memcpy(devRecords.data(), records.data(), count); });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/ray_query.h>
+#include <photon/accel_struct.h>
+#include <photon/device_context.h>
+#include "bench_utils.h"
+
+/*********************************************************************************
+*****************************    ray_query_bench    ******************************
+*********************************************************************************/
+
+void ray_query_bench(bench::Report & report)
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	std::vector<ns::float3_16a> vertices;
+	std::vector<ns::int3_16a> triangles;
+	bench::makeTriangleMesh(1 << 20, vertices, triangles);
+
+	ns::Array<ns::float3_16a>		devVertices(allocator, vertices.size());
+	ns::Array<ns::int3_16a>			devTriangles(allocator, triangles.size());
+	stream.memcpy(devVertices.data(), vertices.data(), vertices.size());
+	stream.memcpy(devTriangles.data(), triangles.data(), triangles.size());
+
+	pt::AccelStructTriangle::BuildInput buildInput;
+	buildInput.vertexBuffer = devVertices;
+	buildInput.indexBuffer = devTriangles;
+	buildInput.numVertices = static_cast<unsigned int>(vertices.size());
+	buildInput.numIndexTriplets = static_cast<unsigned int>(triangles.size());
+
+	auto accelStruct = deviceContext->createAccelStructTriangle();
+	accelStruct->build(stream, allocator, buildInput, 0, true, false);
+
+	auto rayQueryEngine = deviceContext->createRayQueryEngine();
+
+	for (size_t count : { size_t(1) << 16, size_t(1) << 20, size_t(1) << 22 })
+	{
+		//	Rays cast down onto the height field from random points above it, all hit.
+		auto points = bench::makePointCloud(count, 5);
+
+		std::vector<ns::float3> origins(count), directions(count, ns::float3{ 0.0f, -1.0f, 0.0f });
+		std::vector<float> t(count);
+		std::vector<unsigned int> primIndices(count);
+		std::vector<ns::float2> barycentrics(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			origins[i] = ns::float3{ points[i].x, 1.0f, points[i].z };
+		}
+
+		ns::Array<ns::float3>			devOrigins(allocator, count);
+		ns::Array<ns::float3>			devDirections(allocator, count);
+		ns::Array<float>				devT(allocator, count);
+		ns::Array<unsigned int>			devPrimIndices(allocator, count);
+		ns::Array<ns::float2>			devBarycentrics(allocator, count);
+		stream.memcpy(devOrigins.data(), origins.data(), count);
+		stream.memcpy(devDirections.data(), directions.data(), count);
+
+		pt::RayQueryEngine::Rays rays;
+		rays.origins = devOrigins;
+		rays.directions = devDirections;
+		rays.count = count;
+
+		pt::RayQueryEngine::Hits hits;
+		hits.t = devT;
+		hits.primIndices = devPrimIndices;
+		hits.barycentrics = devBarycentrics;
+
+		bench::measureDevice(report, stream, "rayquery/device", count, [&]() { rayQueryEngine->query(stream, accelStruct->handle(), rays, hits); });
+
+		//	End-to-end from pageable host memory, including the staging copies.
+		pt::RayQueryEngine::HostRays hostRays;
+		hostRays.origins = origins.data();
+		hostRays.directions = directions.data();
+		hostRays.count = count;
+
+		pt::RayQueryEngine::HostHits hostHits;
+		hostHits.t = t.data();
+		hostHits.primIndices = primIndices.data();
+		hostHits.barycentrics = barycentrics.data();
+
+		bench::measureHost(report, "rayquery/host", count, [&]() { rayQueryEngine->queryHost(stream, accelStruct->handle(), hostRays, hostHits); });
+	}
+}
\ No newline at end of file
@@ -31,6 +31,8 @@
 #include <nucleus/scoped_timer.h>
 
 #include <photon/pipeline.h>
+#include <photon/aabb_utils.h>
+#include <photon/broad_phase.h>
 #include <photon/accel_struct.h>
 #include <photon/device_context.h>
 #include "collision_pipeline.optixir.h"
@@ -48,18 +50,10 @@ int main()
 	std::default_random_engine	e;
 	std::uniform_real_distribution<float> d;
 	std::vector<ns::float3_16a>		leafPos(count);
-	std::vector<pt::Aabb>			leafAabb(count);
 
 	for (size_t i = 0; i < leafPos.size(); i++)
 	{
-		auto p = ns::float3_16a{ d(e), d(e), d(e) };
-		leafPos[i] = p;
-		leafAabb[i].lower.x = p.x - radius;
-		leafAabb[i].lower.y = p.y - radius;
-		leafAabb[i].lower.z = p.z - radius;
-		leafAabb[i].upper.x = p.x + radius;
-		leafAabb[i].upper.y = p.y + radius;
-		leafAabb[i].upper.z = p.z + radius;
+		leafPos[i] = ns::float3_16a{ d(e), d(e), d(e) };
 	}
 	
 	//	context
@@ -87,10 +81,17 @@ int main()
 	ns::Array<pt::EmptyRecord>		devRaygenRecord(allocator, 1);
 	ns::Array<LaunchParams>			devLaunchParams(allocator, 1);
 	ns::Array<ns::float3_16a>		vertPos(allocator, leafPos.size());
-	ns::Array<pt::Aabb>				aabbBuffer(allocator, leafAabb.size());
-	stream.memcpy(aabbBuffer.data(), leafAabb.data(), leafAabb.size());
+	ns::Array<pt::Aabb>				aabbBuffer(allocator, leafPos.size());
 	stream.memcpy(vertPos.data(), leafPos.data(), leafPos.size());
 
+	//	AABBs are generated on device, no host loop and no extra upload.
+	pt::AabbSource aabbSource;
+	aabbSource.type = pt::AabbSource::Points;
+	aabbSource.vertexBuffer = vertPos;
+	aabbSource.radius = radius;
+	aabbSource.numPrimitives = static_cast<unsigned int>(count);
+	pt::computeAabbs(stream, aabbBuffer, aabbSource);
+
 	//	accel-struct
 	auto accelStruct = deviceContext->createAccelStructAabb();
 	pt::AccelStructAabb::BuildInput buildInput;
@@ -121,21 +122,59 @@ int main()
 	sbt.missRecordStrideInBytes = sizeof(pt::EmptyRecord);
 	sbt.missRecordCount = 1;
 
+	//	Benchmark: average over several launches, as the broad-phase runs every substep.
+	constexpr int numIterations = 20;
+
+	//	Baseline: global atomic counter per contact, no pairs.
 	double timeCost = 0.0;
-	stream.memset(devCount.data(), 0, devCount.bytes()).sync();
+	int hostCount = 0;
 	{
-		ns::ScopedTimer scopedTimer(stream, [&](std::chrono::nanoseconds ns) { timeCost = ns.count() * 1e-3; });
+		ns::ScopedTimer scopedTimer(stream, [&](std::chrono::nanoseconds ns) { timeCost = ns.count() * 1e-3 / numIterations; });
 
-		pipeline.launch<LaunchParams>(stream, devLaunchParams, sbt, count);
-	}
+		for (int i = 0; i < numIterations; i++)
+		{
+			stream.memset(devCount.data(), 0, devCount.bytes());
 
-	//	Download data
-	int hostCount = 0;
+			pipeline.launch<LaunchParams>(stream, devLaunchParams, sbt, count);
+		}
+	}
 	stream.memcpy(&hostCount, devCount.data(), devCount.size()).sync();
 
+	//	Library broad-phase: deduplicated pairs, warp-aggregated append (includes the count read-back).
+	auto broadPhase = deviceContext->createBroadPhase();
+	pt::BroadPhase::BuildInput broadPhaseInput;
+	broadPhaseInput.positions = vertPos;
+	broadPhaseInput.radius = 0.5f * radius;
+	broadPhaseInput.numParticles = static_cast<unsigned int>(count);
+	broadPhaseInput.shape = pt::BroadPhase::Sphere;
+	broadPhase->build(stream, allocator, broadPhaseInput);
+	broadPhase->detect(stream);
+
+	double detectTimeCost = 0.0;
+	{
+		ns::ScopedTimer scopedTimer(stream, [&](std::chrono::nanoseconds ns) { detectTimeCost = ns.count() * 1e-3 / numIterations; });
+
+		for (int i = 0; i < numIterations; i++)
+		{
+			broadPhase->detect(stream);
+		}
+	}
+
+	double substepTimeCost = 0.0;
+	{
+		ns::ScopedTimer scopedTimer(stream, [&](std::chrono::nanoseconds ns) { substepTimeCost = ns.count() * 1e-3 / numIterations; });
+
+		for (int i = 0; i < numIterations; i++)
+		{
+			broadPhase->refit(stream);
+			broadPhase->detect(stream);
+		}
+	}
+
 	//	Print result
 	float guess = 2.0f / 3.0f * 3.14159f * (count * radius) * (count * radius) * radius;
-	printf("\n guess count = %d, count = %d, ratio = %f, time = %fus.\n\n", (int)guess, hostCount, hostCount / float(guess), timeCost);
+	printf("\n guess count = %d, count = %d, ratio = %f, time = %fus.", (int)guess, hostCount, hostCount / float(guess), timeCost);
+	printf("\n broad-phase pairs = %u, capacity = %u, detect = %fus, refit + detect = %fus.\n\n", broadPhase->numContacts(), broadPhase->capacity(), detectTimeCost, substepTimeCost);
 
 	system("pause");
 
@@ -0,0 +1,100 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include <nucleus/vector_types.h>
+#include <nucleus/device_pointer.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	******************************    AabbSource    ******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Describes the primitives from which a buffer of `Aabb` is generated.
+	 *	@note		Primitive `i` always writes `Aabb[i]`, so the output buffer can be passed
+	 *				to `AccelStructAabb::BuildInput::aabbBuffer` without any remapping.
+	 */
+	struct AabbSource
+	{
+		//!	Kind of primitives to be bounded.
+		enum Type
+		{
+			Points,			//!	Points with a uniform radius: `vertexBuffer[i] ± radius`.
+			Spheres,		//!	Spheres with per-primitive radius: `vertexBuffer[i] ± (radiusBuffer[i] + radius)`.
+			Triangles,		//!	Triangles: `indexBuffer[i]` (or vertices `3i, 3i+1, 3i+2` if no index buffer), padded by `radius`.
+			Segments,		//!	Round linear segments (as `AccelStructCurve::RoundLinear`): vertices `segmentBuffer[i]` and `segmentBuffer[i] + 1`.
+		};
+
+		Type								type = Points;						//!	Kind of primitives.
+		dev::Ptr<const ns::float3_16a>		vertexBuffer = nullptr;				//!	Positions (points, sphere centers, triangle or segment vertices).
+		dev::Ptr<const ns::int3_16a>		indexBuffer = nullptr;				//!	[optional] Triangle index triplets, only used with `Triangles`.
+		dev::Ptr<const uint32_t>			segmentBuffer = nullptr;			//!	Index of the first vertex of each segment, only used with `Segments`.
+		dev::Ptr<const float>				radiusBuffer = nullptr;				//!	Per-vertex radius for `Spheres` and `Segments` (may be nullptr for `Segments`).
+		float								radius = 0.0f;						//!	Uniform radius (points) or additional padding (others).
+		unsigned int						numPrimitives = 0;					//!	Number of primitives, i.e. number of output AABBs.
+	};
+
+	/*****************************************************************************
+	*****************************    computeAabbs    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Compute AABBs of primitives on the device.
+	 *	@param[in]	stream - CUDA stream to enqueue the kernel on.
+	 *	@param[out]	aabbs - Output buffer, must hold at least `source.numPrimitives` elements.
+	 *	@param[in]	source - Primitives to be bounded.
+	 */
+	PHOTON_API void computeAabbs(ns::Stream & stream, dev::Ptr<Aabb> aabbs, const AabbSource & source);
+
+
+	/**
+	 *	@brief		Compute AABBs on the device and refit the acceleration structure in the same stream.
+	 *	@details	The kernel writes directly into the AABB buffer registered in the build input of
+	 *				`accelStruct`, followed by `refit` without any host synchronization in-between.
+	 *	@param[in]	aabbs - Must be the buffer referenced by the build input of `accelStruct`.
+	 *	@note		Falls back to `rebuild()` if `accelStruct` was built without `allowUpdate`.
+	 */
+	PHOTON_API void refitAabbs(ns::Stream & stream, AccelStructAabb & accelStruct, dev::Ptr<Aabb> aabbs, const AabbSource & source);
+
+
+	/**
+	 *	@brief		Compute AABBs of points on the host (AVX2 if available, split across threads).
+	 *	@param[out]	aabbs - Output array, must hold at least `count` elements.
+	 *	@param[in]	points - Point positions.
+	 *	@param[in]	radii - [optional] Per-point radius, may be nullptr.
+	 *	@param[in]	radius - Uniform radius, added to `radii[i]` if given.
+	 *	@param[in]	count - Number of points.
+	 *	@param[in]	numThreads - Number of worker threads, 0 for `std::thread::hardware_concurrency()`.
+	 */
+	PHOTON_API void computePointAabbs(Aabb * aabbs, const ns::float3_16a * points, const float * radii, float radius, size_t count, unsigned int numThreads = 0);
+
+
+	/**
+	 *	@brief		Compute AABBs of indexed triangles on the host (split across threads).
+	 *	@param[in]	triangles - [optional] Index triplets, may be nullptr for non-indexed triangles.
+	 *	@param[in]	padding - Extra padding added on each side.
+	 */
+	PHOTON_API void computeTriangleAabbs(Aabb * aabbs, const ns::float3_16a * vertices, const ns::int3_16a * triangles, float padding, size_t count, unsigned int numThreads = 0);
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "macros.h"
+#include <nucleus/logger.h>
+#include <optix.h>
+#include <type_traits>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if OPTIX_VERSION >= 70200
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*****************************    BoundValues    ******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Launch parameter fields fixed at module compile time.
+	 *	@details	Bound fields are constant-folded by the OptiX compiler: reads of them are replaced by the value
+	 *				and branches on them are eliminated. Modules compiled with different values are specialized
+	 *				variants of the same source, the values passed at launch for bound fields are ignored.
+	 *	@example	BoundValues<LaunchParams> boundValues;
+	 *				boundValues.bind(&LaunchParams::radius, 0.01f).bind(&LaunchParams::enableShadows, false);
+	 *				auto module = context->createModule(ptx, pipelineCompileOptions, boundValues.apply());
+	 *	@note		The options returned by `apply()` point into this object, which must outlive `createModule()`.
+	 */
+	template<typename Params> class BoundValues
+	{
+		static_assert(std::is_standard_layout_v<Params>, "Launch parameters must have standard layout");
+
+	public:
+
+		//!	Bind the field `member` to `value` (converted to the field type), replacing a previous binding of the same field.
+		template<typename Field> BoundValues & bind(Field Params::*member, const std::type_identity_t<Field> & value, const char * annotation = nullptr)
+		{
+			return this->bind(offsetOf(member), value, annotation);
+		}
+
+
+		//!	Bind the bytes of `value` at `offset` in `Params`, for nested fields, e.g. `offsetof(Params, shading.flags)`.
+		template<typename Field> BoundValues & bind(size_t offset, const Field & value, const char * annotation = nullptr)
+		{
+			static_assert(std::is_trivially_copyable_v<Field>, "Bound values must be trivially copyable");
+
+			NS_ASSERT(offset + sizeof(Field) <= sizeof(Params));
+
+			Entry & entry = this->find(offset, sizeof(Field));
+			entry.bytes.resize(sizeof(Field));
+			entry.annotation = (annotation != nullptr) ? annotation : "";
+
+			memcpy(entry.bytes.data(), &value, sizeof(Field));
+
+			return *this;
+		}
+
+
+		//!	Remove all bindings.
+		void clear() { m_entries.clear(); m_optixEntries.clear(); }
+
+		//!	Number of bound fields.
+		size_t size() const { return m_entries.size(); }
+
+		//!	Whether no field is bound.
+		bool empty() const { return m_entries.empty(); }
+
+
+		//!	Return `moduleCompileOptions` with the bound values set.
+		OptixModuleCompileOptions apply(OptixModuleCompileOptions moduleCompileOptions = OptixModuleCompileOptions{})
+		{
+			m_optixEntries.resize(m_entries.size());
+
+			for (size_t i = 0; i < m_entries.size(); i++)
+			{
+				m_optixEntries[i] = OptixModuleCompileBoundValueEntry{};
+				m_optixEntries[i].pipelineParamOffsetInBytes = m_entries[i].offset;
+				m_optixEntries[i].sizeInBytes = m_entries[i].bytes.size();
+				m_optixEntries[i].boundValuePtr = m_entries[i].bytes.data();
+				m_optixEntries[i].annotation = m_entries[i].annotation.empty() ? nullptr : m_entries[i].annotation.c_str();
+			}
+
+			moduleCompileOptions.boundValues = m_optixEntries.empty() ? nullptr : m_optixEntries.data();
+			moduleCompileOptions.numBoundValues = static_cast<unsigned int>(m_optixEntries.size());
+
+			return moduleCompileOptions;
+		}
+
+	private:
+
+		struct Entry
+		{
+			size_t								offset;
+			std::vector<unsigned char>			bytes;
+			std::string							annotation;
+		};
+
+
+		//!	Byte offset of `member`, the member pointer is applied to storage that is never read.
+		template<typename Field> static size_t offsetOf(Field Params::*member)
+		{
+			alignas(Params) static const unsigned char storage[sizeof(Params)] = {};
+
+			const Params * object = reinterpret_cast<const Params*>(storage);
+
+			return static_cast<size_t>(reinterpret_cast<const unsigned char*>(&(object->*member)) - storage);
+		}
+
+
+		//!	Entry of the field at `offset`, bindings of different fields must not overlap.
+		Entry & find(size_t offset, size_t size)
+		{
+			for (Entry & entry : m_entries)
+			{
+				if (entry.offset == offset)
+				{
+					NS_ASSERT(entry.bytes.size() == size);
+
+					return entry;
+				}
+
+				NS_ASSERT((offset + size <= entry.offset) || (entry.offset + entry.bytes.size() <= offset));
+			}
+
+			m_entries.push_back(Entry{ offset, {}, {} });
+
+			return m_entries.back();
+		}
+
+	private:
+
+		std::vector<Entry>									m_entries;
+		std::vector<OptixModuleCompileBoundValueEntry>		m_optixEntries;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include <nucleus/vector_types.h>
+#include <nucleus/device_pointer.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	******************************    BroadPhase    ******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Abstract interface for ray-traced particle broad-phase collision detection.
+	 *	@details	An AABB GAS is built over all particles, and a zero-length ray is traced from each
+	 *				particle center. Every overlapping pair is reported exactly once as `(i, j)` with `i < j`.
+	 *				Pairs are appended with one atomic per warp, and the output buffer is grown and the
+	 *				launch retried automatically if it overflows.
+	 *	@note		The particle radius is `radii[i] + radius` (or just `radius` if `radii` is nullptr),
+	 *				two particles collide if their boxes (or spheres) of this radius overlap.
+	 */
+	class BroadPhase
+	{
+
+	public:
+
+		//!	@brief		Virtual destructor.
+		virtual ~BroadPhase() {}
+
+	public:
+
+		//!	Overlap test between two particles.
+		enum Shape
+		{
+			Box,			//!	Axis-aligned cubes: `max(|pi - pj|) < ri + rj`.
+			Sphere,			//!	Spheres: `|pi - pj| < ri + rj`.
+		};
+
+		//!	A pair of overlapping particles, `i < j`.
+		struct ContactPair
+		{
+			unsigned int		i;
+			unsigned int		j;
+		};
+
+		//!	Description of the particle set.
+		struct BuildInput
+		{
+			dev::Ptr<const ns::float3_16a>		positions = nullptr;			//!	Particle centers on device memory.
+			dev::Ptr<const float>				radii = nullptr;				//!	[optional] Per-particle radius on device memory.
+			float								radius = 0.0f;					//!	Uniform radius, added to `radii[i]` if given.
+			unsigned int						numParticles = 0;				//!	Number of particles.
+			Shape								shape = Sphere;					//!	Overlap test.
+			bool								reorder = true;					//!	Sort particles along a Hilbert curve internally (pairs still use input indices).
+		};
+
+		//!	@brief		Return the current build input.
+		virtual const BuildInput & buildInput() const = 0;
+
+		//!	@brief		Return number of contact pairs found by the last `detect()`.
+		virtual unsigned int numContacts() const = 0;
+
+		//!	@brief		Return capacity of the contact-pair buffer.
+		virtual unsigned int capacity() const = 0;
+
+		//!	@brief		Retrieve the device context associated with.
+		virtual std::shared_ptr<class DeviceContext> deviceContext() const = 0;
+
+	public:
+
+		/**
+		 *	@brief		Build the acceleration structure over the particles.
+		 *	@param[in]	stream - CUDA stream to enqueue the work on.
+		 *	@param[in]	allocator - Allocator for the GAS, AABBs and contact-pair buffers.
+		 *	@param[in]	buildInput - Particle set, the buffers must stay valid until the next `build()`.
+		 *	@param[in]	initialCapacity - Initial size of the contact-pair buffer (0 for `4 * numParticles`).
+		 */
+		virtual void build(ns::Stream & stream, ns::AllocPtr allocator, const BuildInput & buildInput, unsigned int initialCapacity = 0) = 0;
+
+
+		/**
+		 *	@brief		Refit the acceleration structure after particles moved (positions or radii updated in-place).
+		 *	@note		Cheap compared to `build()`, intended to be called every simulation substep.
+		 */
+		virtual void refit(ns::Stream & stream) = 0;
+
+
+		/**
+		 *	@brief		Find all overlapping pairs.
+		 *	@details	The stream is synchronized once to read back the pair count. If the pair buffer
+		 *				overflowed, it is grown to fit and the launch is repeated.
+		 *	@return		Device pointer to `numContacts()` pairs, valid until the next call.
+		 */
+		virtual dev::Ptr<const ContactPair> detect(ns::Stream & stream) = 0;
+	};
+}
\ No newline at end of file
@@ -23,11 +23,33 @@
 
 #include "fwd.h"
 #include <optix.h>
+#include <nucleus/array_proxy.h>
 #include <nucleus/vector_types.h>
 #include <nucleus/device_pointer.h>
 
 namespace PHOTON_NAMESPACE
 {
+	/*****************************************************************************
+	*************************    DenoiserPixelFormat    **************************
+	*****************************************************************************/
+
+	//!	Maps a pixel type to the `OptixPixelFormat` accepted by the denoiser.
+	template<typename Type> struct DenoiserPixelFormat;
+	template<> struct DenoiserPixelFormat<Color4f>		{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_FLOAT4; };
+	template<> struct DenoiserPixelFormat<ns::float4>	{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_FLOAT4; };
+	template<> struct DenoiserPixelFormat<ns::float3>	{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_FLOAT3; };
+	template<> struct DenoiserPixelFormat<Color4h>		{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_HALF4; };
+	template<> struct DenoiserPixelFormat<Color3h>		{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_HALF3; };
+	template<> struct DenoiserPixelFormat<Color4ub>		{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_UCHAR4; };
+#if OPTIX_VERSION >= 70400
+	template<> struct DenoiserPixelFormat<ns::float2>	{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_FLOAT2; };
+	template<> struct DenoiserPixelFormat<Color2h>		{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_HALF2; };
+#endif
+#if OPTIX_VERSION >= 70700
+	template<> struct DenoiserPixelFormat<float>		{ static constexpr OptixPixelFormat value = OPTIX_PIXEL_FORMAT_FLOAT1; };
+#endif
+	template<typename Type> struct DenoiserPixelFormat<const Type> : DenoiserPixelFormat<Type> {};
+
 	/*****************************************************************************
 	*******************************    Denoiser    *******************************
 	*****************************************************************************/
@@ -62,18 +84,97 @@ namespace PHOTON_NAMESPACE
 		#endif
 		};
 
+		//	Kind of an AOV layer, used by the AOV models (requires Optix 7.7, ignored otherwise).
+		enum AovType
+		{
+			AovNone,
+			AovBeauty,
+			AovSpecular,
+			AovReflection,
+			AovRefraction,
+			AovDiffuse,
+		};
+
+		//	Guide layers used by the denoiser, unused guides are neither read nor allocated.
+		enum GuideSet
+		{
+			GuideNone,				//	Beauty (and AOV) layers only, e.g. for preview.
+			GuideAlbedo,			//	Albedo guide.
+			GuideAlbedoNormal,		//	Albedo and normal guides, best quality.
+		};
+
+
+		/**
+		 *	@brief		Type-erased pitched device image, with its pixel format deduced from `dev::Ptr2<Type>`.
+		 *	@details	Half-precision (`Color4h`, `Color3h`, `Color2h`) and 8-bit (`Color4ub`) images are passed to
+		 *				OptiX as they are, so the caller does not have to convert its buffers to RGBA32F first.
+		 *				8-bit images are only accepted as beauty/AOV layers, not as guides.
+		 */
+		struct Image
+		{
+			Image() = default;
+
+			Image(std::nullptr_t) {}
+
+			template<typename Type> Image(dev::Ptr2<Type> image) : data(image.data()), width(image.width()), height(image.height()),
+				rowStrideInBytes(static_cast<unsigned int>(image.pitch())), pixelStrideInBytes(sizeof(Type)), format(DenoiserPixelFormat<Type>::value) {}
+
+			bool empty() const { return data == nullptr; }
+
+			bool operator==(const Image &) const = default;
+
+			const void *						data = nullptr;
+			unsigned int						width = 0;
+			unsigned int						height = 0;
+			unsigned int						rowStrideInBytes = 0;
+			unsigned int						pixelStrideInBytes = 0;
+			OptixPixelFormat					format = OPTIX_PIXEL_FORMAT_FLOAT4;
+		};
+
+
+		//!	Input and output of one layer (beauty or AOV).
+		struct Layer
+		{
+			Image								output;						//!	Denoised output image (any of FLOAT4, HALF4 or UCHAR4).
+			Image								input;						//!	Noisy input image.
+			Image								previousOutput;				//!	[optional] Previous frame's denoised result of this layer (temporal models).
+			AovType								type = AovNone;				//!	Kind of the layer.
+		};
+
+
+		//!	Guide images, shared by all layers.
+		struct GuideLayer
+		{
+			Image								albedo;						//!	Albedo buffer (float or half RGB, the 4th channel of RGBA images is ignored).
+			Image								normal;						//!	Normal buffer (float or half RGB, the 4th channel of RGBA images is ignored).
+			Image								flow;						//!	[optional] 2D motion vectors (XY32F or XY16F), temporal models only.
+			Image								flowTrustworthiness;		//!	[optional] Motion vector confidence map (F32), Range 0..1.
+		};
+
 		//!	@brief		Releases allocated resources.
 		virtual void release() = 0;
 
 		//!	@brief		Return model kind used by the denoiser.
 		virtual ModelKind modelKind() const = 0;
 
-		//!	@brief		Return maximum input width of the image.
+		//!	@brief		Return guide layers used by the denoiser.
+		virtual GuideSet guideSet() const = 0;
+
+		//!	@brief		Return maximum input width of the image (0 in tiled mode).
 		virtual unsigned int maxInputWidth() const = 0;
 
-		//!	@brief		Return maximum input height of the image.
+		//!	@brief		Return maximum input height of the image (0 in tiled mode).
 		virtual unsigned int maxInputHeight() const = 0;
 
+		//!	@brief		Return tile width of the tiled mode, 0 if tiling is disabled.
+		virtual unsigned int tileWidth() const = 0;
+
+		//!	@brief		Return tile height of the tiled mode, 0 if tiling is disabled.
+		virtual unsigned int tileHeight() const = 0;
+
+		//!	@brief		Return device memory held by the denoiser (state, scratch and internal guide layers) in bytes.
+		virtual size_t memoryUsage() const = 0;
+
 		//!	@brief		Retrieve the device context associated with.
 		virtual std::shared_ptr<class DeviceContext> deviceContext() = 0;
 
@@ -85,24 +186,79 @@ namespace PHOTON_NAMESPACE
 		 *	@param[in]	modeKind - Model kind used by the desnoiser.
 		 *	@param[in]	maxInputWidth - Maximum width of the input image in pixels.
 		 *	@param[in]	maxInputHeight - Maximum height of the input image in pixels.
+		 *	@param[in]	guideSet - Guide layers read by `launch()`, the others may be left empty.
+		 */
+		virtual void preallocate(ns::AllocPtr pAlloc, ModelKind modeKind, unsigned int maxInputWidth, unsigned int maxInputHeight, GuideSet guideSet = GuideAlbedoNormal) = 0;
+
+
+		/**
+		 *	@brief		Pre-allocates GPU memory resources for tiled denoising.
+		 *	@details	State and scratch memory are sized for one tile plus its overlap window, so images
+		 *				of any resolution can be denoised with a fixed memory budget. `launch()` splits the
+		 *				image into overlapping tiles and invokes the denoiser once per tile.
+		 *	@param[in]	pAlloc - Custom memory allocator.
+		 *	@param[in]	modeKind - Model kind used by the desnoiser.
+		 *	@param[in]	tileWidth - Width of a tile in pixels, without overlap.
+		 *	@param[in]	tileHeight - Height of a tile in pixels, without overlap.
+		 *	@param[in]	guideSet - Guide layers read by `launch()`, the others may be left empty.
+		 *	@note		Temporal models still keep their internal guide layers at full resolution, they are
+		 *				(re)allocated by `launch()` from `pAlloc` when the image size changes.
+		 *	@note		Requires OptiX 7.3 or newer.
+		 */
+		virtual void preallocateTiled(ns::AllocPtr pAlloc, ModelKind modeKind, unsigned int tileWidth, unsigned int tileHeight, GuideSet guideSet = GuideAlbedoNormal) = 0;
+
+
+		/**
+		 *	@brief		Set up the denoiser state for inputs up to the given size ahead of `launch()`.
+		 *	@details	`launch()` runs the setup itself whenever the input grows, calling it beforehand moves
+		 *				that cost out of the first launch. Tiled denoisers are set up for one tile with overlap.
+		 *	@param[in]	stream - CUDA stream for asynchronous execution.
+		 *	@param[in]	inputWidth - Width of the input image in pixels, at most `maxInputWidth()`.
+		 *	@param[in]	inputHeight - Height of the input image in pixels, at most `maxInputHeight()`.
 		 */
-		virtual void preallocate(ns::AllocPtr pAlloc, ModelKind modeKind, unsigned int maxInputWidth, unsigned int maxInputHeight) = 0;
+		virtual void setup(ns::Stream & stream, unsigned int inputWidth, unsigned int inputHeight) = 0;
+
+
+		/**
+		 *	@brief		Denoise several layers (beauty and AOVs) in a single invoke.
+		 *	@details	All layers share the guide images, the intensity and the average color, which are computed
+		 *				once from the first layer. The first layer must be the beauty layer.
+		 *	@param[in]	stream - CUDA stream for asynchronous execution.
+		 *	@param[in]	layers - Input/output pairs, all with the size of the first input.
+		 *	@param[in]	guideLayer - Albedo, normal (as selected by `guideSet()`) and (temporal models) flow images.
+		 *	@param[in]	blendFactor - Field specifies an interpolation weight [0.0-1.0] between the noisy input image.
+		 *	@note		Several layers require Optix 7.3 or newer.
+		 */
+		virtual void launch(ns::Stream & stream, ns::ArrayProxy<Layer> layers, const GuideLayer & guideLayer, float blendFactor) = 0;
 
 
 		/**
 		 *	@brief		Execute temporal denoising pass.
 		 *	@param[in]	stream - CUDA stream for asynchronous execution.
-		 *	@param[out]	output - Denoised output image (RGBA32F).
-		 *	@param[in]	input - Current noisy input image.
-		 *	@param[in]	albedo - Current albedo buffer.
-		 *	@param[in]	normal - Current normal buffer.
+		 *	@param[out]	output - Denoised output image (RGBA32F, RGBA16F or RGBA8).
+		 *	@param[in]	input - Current noisy input image, any `dev::Ptr2` with a `DenoiserPixelFormat`.
+		 *	@param[in]	albedo - Current albedo buffer, may be empty with `GuideNone`.
+		 *	@param[in]	normal - Current normal buffer, may be empty without `GuideAlbedoNormal`.
 		 *	@param[in]	previousOutput - [optional] Previous frame's denoised result. 
-		 *	@param[in]	flow - [optional] 2D motion vectors (XY32F). In the first frame, `flowImg` must be set to zero (no motion).
+		 *	@param[in]	flow - [optional] 2D motion vectors (XY32F or XY16F). In the first frame, `flowImg` must be set to zero (no motion).
 		 *	@param[in]	flowTrustworthiness - [optional] Motion vector confidence map (F32), Range 0..1 (low->high trustworthiness). Ignored if data pointer in the image is zero.
 		 *	@param[in]	blendFactor - Field specifies an interpolation weight [0.0-1.0] between the noisy input image.
 		 */
-		virtual void launch(ns::Stream & stream, dev::Ptr2<Color4f> output, dev::Ptr2<const Color4f> input, dev::Ptr2<const Color4f> albedo, dev::Ptr2<const Color4f> normal,
-							dev::Ptr2<const Color4f> previousOutput, dev::Ptr2<const ns::float2> flow, dev::Ptr2<const float> flowTrustworthiness, float blendFactor) = 0;
+		void launch(ns::Stream & stream, Image output, Image input, Image albedo, Image normal, Image previousOutput, Image flow, Image flowTrustworthiness, float blendFactor)
+		{
+			Layer layer;
+			layer.output = output;
+			layer.input = input;
+			layer.previousOutput = previousOutput;
+
+			GuideLayer guideLayer;
+			guideLayer.albedo = albedo;
+			guideLayer.normal = normal;
+			guideLayer.flow = flow;
+			guideLayer.flowTrustworthiness = flowTrustworthiness;
+
+			this->launch(stream, layer, guideLayer, blendFactor);
+		}
 
 
 		/**
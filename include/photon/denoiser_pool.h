@@ -0,0 +1,152 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "denoiser.h"
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*****************************    DenoiserPool    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Abstract interface for a pool of set-up denoisers, shared by concurrent streams.
+	 *	@details	Denoisers are keyed by model kind, guide set and resolution bucket (the input size rounded up to a
+	 *				multiple of the bucket size), so jobs with mixed models and resolutions reuse an existing
+	 *				denoiser instead of recreating its state on every call. A denoiser is handed out to one
+	 *				`Lease` at a time; leases acquired on different streams get different denoisers and can be
+	 *				launched concurrently. Idle denoisers are released in LRU order once the memory used by the
+	 *				pool exceeds its budget.
+	 *	@example	auto lease = denoiserPool->acquire(stream, pt::Denoiser::Normal, width, height);
+	 *				lease.launch(stream, output, input, albedo, normal, nullptr, nullptr, nullptr, 0.0f);
+	 *	@note		All methods are thread-safe. The work enqueued through a lease must be on the stream it was
+	 *				acquired with, since the next user of the denoiser only waits for that stream.
+	 */
+	class DenoiserPool
+	{
+
+	public:
+
+		//!	@brief		Virtual destructor.
+		virtual ~DenoiserPool() {}
+
+	public:
+
+		/**
+		 *	@brief		Exclusive access to a pooled denoiser, returned to the pool on destruction.
+		 *	@details	Only launches are forwarded, the denoiser itself is read-only through the lease since
+		 *				the pool owns its allocation (`preallocate()` or `release()` would corrupt the bucket).
+		 *	@note		Must not outlive the pool.
+		 */
+		class Lease
+		{
+			NS_NONCOPYABLE(Lease)
+
+		public:
+
+			Lease() : m_pool(nullptr), m_denoiser(nullptr) {}
+
+			Lease(DenoiserPool * pool, Denoiser * denoiser) : m_pool(pool), m_denoiser(denoiser) {}
+
+			Lease(Lease && rhs) : m_pool(rhs.m_pool), m_denoiser(rhs.m_denoiser) { rhs.m_denoiser = nullptr; }
+
+			Lease & operator=(Lease && rhs) { this->reset();	m_pool = rhs.m_pool;	m_denoiser = rhs.m_denoiser;	rhs.m_denoiser = nullptr;	return *this; }
+
+			~Lease() { this->reset(); }
+
+		public:
+
+			//!	@brief		Return the denoiser to the pool.
+			void reset() { if (m_denoiser != nullptr) { m_pool->recycle(m_denoiser);	m_denoiser = nullptr; } }
+
+			//!	@brief		Denoise several layers, see `Denoiser::launch()`.
+			void launch(ns::Stream & stream, ns::ArrayProxy<Denoiser::Layer> layers, const Denoiser::GuideLayer & guideLayer, float blendFactor) { m_denoiser->launch(stream, layers, guideLayer, blendFactor); }
+
+			//!	@brief		Denoise a single layer, see `Denoiser::launch()`.
+			void launch(ns::Stream & stream, Denoiser::Image output, Denoiser::Image input, Denoiser::Image albedo, Denoiser::Image normal,
+						Denoiser::Image previousOutput, Denoiser::Image flow, Denoiser::Image flowTrustworthiness, float blendFactor)
+			{
+				m_denoiser->launch(stream, output, input, albedo, normal, previousOutput, flow, flowTrustworthiness, blendFactor);
+			}
+
+			//!	@brief		Advance to next temporal frame.
+			void nextFrame() { m_denoiser->nextFrame(); }
+
+			const Denoiser * get() const { return m_denoiser; }
+
+			const Denoiser & operator*() const { return *m_denoiser; }
+
+			const Denoiser * operator->() const { return m_denoiser; }
+
+			explicit operator bool() const { return m_denoiser != nullptr; }
+
+		private:
+
+			DenoiserPool *		m_pool;
+			Denoiser *			m_denoiser;
+		};
+
+	public:
+
+		/**
+		 *	@brief		Acquire a denoiser set up for the given model kind and input size.
+		 *	@details	An idle denoiser of the same model kind, guide set and resolution bucket is reused if any, preferably
+		 *				one last used on `stream` (otherwise `stream` waits for the stream it was last used on).
+		 *				A new denoiser is created and set up on `stream` for the whole bucket if none is available,
+		 *				releasing idle ones beyond the budget.
+		 *	@param[in]	stream - Stream on which the denoiser will be launched.
+		 *	@param[in]	modelKind - Model kind used by the denoiser.
+		 *	@param[in]	inputWidth - Width of the input image in pixels.
+		 *	@param[in]	inputHeight - Height of the input image in pixels.
+		 *	@param[in]	guideSet - Guide layers read by the denoiser.
+		 *	@note		Temporal models keep their frame history in the denoiser, a sequence should hold its lease
+		 *				across frames (or restart with an empty `previousOutput`).
+		 *	@throw		OptixResult - Throw `OptixResult` in case of failure.
+		 */
+		virtual Lease acquire(ns::Stream & stream, Denoiser::ModelKind modelKind, unsigned int inputWidth, unsigned int inputHeight,
+							  Denoiser::GuideSet guideSet = Denoiser::GuideAlbedoNormal) = 0;
+
+		//!	@brief		Set the memory budget in bytes (leased denoisers are never released).
+		virtual void setMemoryBudget(size_t bytes) = 0;
+
+		//!	@brief		Return the memory budget in bytes.
+		virtual size_t memoryBudget() const = 0;
+
+		//!	@brief		Return device memory held by all pooled denoisers in bytes.
+		virtual size_t memoryUsage() const = 0;
+
+		//!	@brief		Return number of pooled denoisers (idle and leased).
+		virtual size_t numDenoisers() const = 0;
+
+		//!	@brief		Release all idle denoisers.
+		virtual void trim() = 0;
+
+		//!	@brief		Retrieve the device context associated with.
+		virtual std::shared_ptr<class DeviceContext> deviceContext() = 0;
+
+	protected:
+
+		//!	@brief		Called by `Lease` to return a denoiser to the pool.
+		virtual void recycle(Denoiser * denoiser) = 0;
+	};
+}
\ No newline at end of file
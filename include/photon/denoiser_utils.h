@@ -0,0 +1,131 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "denoiser.h"
+#include "payload_codec.h"
+#include <math.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*************************    DenoiserGuideSource    **************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Render outputs converted into the denoiser inputs by `prepareDenoiserInputs()`.
+	 *	@note		Source images may use any `DenoiserPixelFormat` with 3 or 4 channels.
+	 */
+	struct DenoiserGuideSource
+	{
+		Denoiser::Image						color;							//!	Noisy beauty image.
+		Denoiser::Image						albedo;							//!	[optional] Albedo image, left untouched in the output if empty.
+		Denoiser::Image						normal;							//!	[optional] World-space normals, left untouched in the output if empty.
+		Mat4x4								worldToCamera = {};				//!	Normals are multiplied by its upper 3x3 block (inverse transpose for non-rigid transforms).
+		bool								transformNormals = false;		//!	Whether normals are transformed into camera space (as expected by the denoiser).
+	};
+
+	/*****************************************************************************
+	****************************    TonemapParams    *****************************
+	*****************************************************************************/
+
+	//!	Parameters of the fused output pass, see `tonemapDenoiserOutput()`.
+	struct TonemapParams
+	{
+		//!	Tone mapping operator applied after exposure.
+		enum Operator
+		{
+			Clamp,				//!	No curve, values are clamped to [0, 1].
+			Reinhard,			//!	x / (1 + x).
+			Aces,				//!	Narkowicz's fit of the ACES filmic curve.
+		};
+
+		Operator							tonemapOperator = Aces;			//!	Tone mapping operator.
+		float								exposure = 1.0f;				//!	Linear scale applied before tone mapping.
+		bool								srgb = true;					//!	Apply the sRGB transfer function before 8-bit quantization.
+		bool								downsample2x = false;			//!	Average 2x2 input pixels (in linear space) into one output pixel.
+	};
+
+	/*****************************************************************************
+	******************************    Pixel math    ******************************
+	*****************************************************************************/
+
+	namespace details
+	{
+		//!	Tone map one linear channel to [0, 1].
+		__RT_HOST_DEVICE__ inline float tonemap(float value, TonemapParams::Operator op)
+		{
+			value = fmaxf(value, 0.0f);
+
+			if (op == TonemapParams::Reinhard)
+			{
+				value = value / (1.0f + value);
+			}
+			else if (op == TonemapParams::Aces)
+			{
+				value = (value * (2.51f * value + 0.03f)) / (value * (2.43f * value + 0.59f) + 0.14f);
+			}
+
+			return fminf(value, 1.0f);
+		}
+
+
+		//!	sRGB transfer function (OETF) of a channel in [0, 1].
+		__RT_HOST_DEVICE__ inline float linearToSrgb(float value)
+		{
+			return (value <= 0.0031308f) ? 12.92f * value : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+		}
+
+
+		//!	Quantize a channel in [0, 1] to 8 bits, round to nearest.
+		__RT_HOST_DEVICE__ inline unsigned char toUnorm8(float value)
+		{
+			return static_cast<unsigned char>(fminf(fmaxf(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+		}
+	}
+
+	/*****************************************************************************
+	*****************************    Fused passes    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Convert render outputs into the denoiser input and guide layers in a single pass.
+	 *	@details	Reads color, albedo and normal of each pixel once, converts them to the format of the
+	 *				destination images (RGBA32F or RGBA16F), and optionally rotates normals into camera space,
+	 *				instead of one full-frame pass per image.
+	 *	@param[in]	stream - CUDA stream to enqueue the kernel on.
+	 *	@param[out]	input - Noisy input of the denoiser, with the size of `source.color`.
+	 *	@param[out]	guideLayer - Albedo and normal guides of the denoiser (flow is ignored).
+	 *	@param[in]	source - Render outputs.
+	 */
+	PHOTON_API void prepareDenoiserInputs(ns::Stream & stream, const Denoiser::Image & input, const Denoiser::GuideLayer & guideLayer, const DenoiserGuideSource & source);
+
+
+	/**
+	 *	@brief		Tone map, encode and quantize the denoised image into RGBA8 in a single pass.
+	 *	@param[in]	stream - CUDA stream to enqueue the kernel on.
+	 *	@param[out]	output - 8-bit image, half the size of `input` (rounded down) if `params.downsample2x`.
+	 *	@param[in]	input - Denoised image (any `DenoiserPixelFormat` with 3 or 4 channels), alpha is kept linear.
+	 *	@param[in]	params - Exposure, tone mapping and encoding parameters.
+	 */
+	PHOTON_API void tonemapDenoiserOutput(ns::Stream & stream, dev::Ptr2<Color4ub> output, const Denoiser::Image & input, const TonemapParams & params = TonemapParams());
+}
\ No newline at end of file
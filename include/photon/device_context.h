@@ -23,9 +23,15 @@
 
 #include "fwd.h"
 #include <optix.h>
+#include <nucleus/array_proxy.h>
+#include <string>
+#include <mutex>
+#include <map>
 
 namespace PHOTON_NAMESPACE
 {
+	class LinkedPipeline;
+
 	/*****************************************************************************
 	******************************    DeviceProp    ******************************
 	*****************************************************************************/
@@ -63,6 +69,11 @@ namespace PHOTON_NAMESPACE
 	 *	It provides access to device-specific properties and the underlying device itself.
 	 *	Derived implementations are responsible for managing the actual OptiX context and
 	 *	associated resources such as modules, pipelines, and acceleration structures.
+	 *
+	 *	Thread safety: creating modules, programs (`Module::at()`), built-in intersection programs,
+	 *	acceleration structures, pipelines and denoisers may be done concurrently from any thread.
+	 *	Each created object is then used by one thread at a time, except `DenoiserPool` and `Profiler`,
+	 *	which are thread-safe themselves.
 	 */
 	class DeviceContext : public std::enable_shared_from_this<DeviceContext>
 	{
@@ -102,6 +113,12 @@ namespace PHOTON_NAMESPACE
 		//!	@brief		Return pointer to the properties.
 		const DeviceProp & properties() const { return m_devProp; }
 
+		//!	@brief		Return the built-in GPU profiler (disabled unless `PHOTON_PROFILE` is set, see `Profiler`).
+		Profiler * profiler() const { return m_profiler.get(); }
+
+		//!	@brief		Whether `optixReorder()` reorders threads on this device (see `reorder.cuh`), to be forwarded to `trace_reordered()`.
+		bool supportsShaderExecutionReordering() const { return m_devProp.shaderExecutionReordering != 0; }
+
 		//!	@brief		Create a module from a PTX string.
 		PHOTON_API std::shared_ptr<Module> createModule(const unsigned char * ptxStr, size_t ptxSize,
 														const OptixPipelineCompileOptions & pipelineCompileOptions,
@@ -116,11 +133,35 @@ namespace PHOTON_NAMESPACE
 			return this->createModule(ptx, ptxSize, pipelineCompileOptions, moduleCompileOptions);
 		}
 
+	#if OPTIX_VERSION >= 70400
+		/**
+		 *	@brief		Create a module with explicit payload types (see `PayloadLayout`).
+		 *	@details	With payload types, the compiler knows which payload slots are read or written by each
+		 *				program kind and can drop dead payload registers. Programs pick their type with
+		 *				`Module::at(funcName, payloadTypeIndex)`.
+		 *	@note		`pipelineCompileOptions.numPayloadValues` must be 0 (in the pipeline as well).
+		 */
+		PHOTON_API std::shared_ptr<Module> createModule(const unsigned char * ptxStr, size_t ptxSize,
+														const OptixPipelineCompileOptions & pipelineCompileOptions,
+														ns::ArrayProxy<OptixPayloadType> payloadTypes,
+														OptixModuleCompileOptions moduleCompileOptions = OptixModuleCompileOptions{});
+
+		//! @brief  Create a module with explicit payload types (array overload).
+		template<size_t ptxSize> std::shared_ptr<Module> createModule(const unsigned char(&ptx)[ptxSize],
+																	  const OptixPipelineCompileOptions & pipelineCompileOptions,
+																	  ns::ArrayProxy<OptixPayloadType> payloadTypes,
+																	  const OptixModuleCompileOptions & moduleCompileOptions = OptixModuleCompileOptions{})
+		{
+			return this->createModule(ptx, ptxSize, pipelineCompileOptions, payloadTypes, moduleCompileOptions);
+		}
+	#endif
+
 		/**
 		 *	@brief		Get a built-in intersection program for the given primitive type.
 		 *	@param[in]	builtinISOptions - Built-in intersection module options (primitive type, motion blur, etc.).
 		 *	@param[in]	pipelineCompileOptions - Pipeline compile options (must match the pipeline).
 		 *	@return		A program of type BuiltinIntersection, ready to be combined into a hit group.
+		 *	@note		Cached: the same program is returned for equal options while it is alive.
 		 */
 		PHOTON_API std::shared_ptr<Program> getBuiltinISProgram(OptixBuiltinISOptions builtinISOptions, const OptixPipelineCompileOptions & pipelineCompileOptions);
 
@@ -138,10 +179,44 @@ namespace PHOTON_NAMESPACE
 		//! @brief		Create a denoiser.
 		PHOTON_API std::unique_ptr<Denoiser> createDenoiser();
 
+		/**
+		 *	@brief		Create a pool of denoisers shared by concurrent streams (see `DenoiserPool`).
+		 *	@param[in]	pAlloc - Allocator of the pooled denoisers.
+		 *	@param[in]	memoryBudget - Idle denoisers are released in LRU order beyond this many bytes.
+		 *	@param[in]	resolutionBucket - Input sizes are rounded up to a multiple of it to share denoisers.
+		 */
+		PHOTON_API std::unique_ptr<DenoiserPool> createDenoiserPool(ns::AllocPtr pAlloc, size_t memoryBudget, unsigned int resolutionBucket = 256);
+
+		//! @brief		Create a broad-phase collision detector (built-in programs, no module required).
+		PHOTON_API std::unique_ptr<BroadPhase> createBroadPhase();
+
+		//! @brief		Create a fixed-radius neighbor search (built-in programs, no module required).
+		PHOTON_API std::unique_ptr<NeighborSearch> createNeighborSearch();
+
+		//! @brief		Create a batched closest-hit ray query engine (built-in programs, no module required).
+		PHOTON_API std::unique_ptr<RayQueryEngine> createRayQueryEngine();
+
+		//! @brief		Create a Morton/Hilbert sorter for primitives and query points.
+		PHOTON_API std::unique_ptr<SpatialSort> createSpatialSort();
+
+	private:
+
+		friend class Pipeline;
+
+		//!	Link the programs, or return the pipeline already linked from the same programs and options (see `Pipeline`).
+		std::shared_ptr<LinkedPipeline> linkPipeline(ns::ArrayProxy<std::shared_ptr<Program>> programs,
+													 const OptixPipelineCompileOptions & pipelineCompileOptions,
+													 const OptixPipelineLinkOptions & pipelineLinkOptions);
+
 	private:
 
-		ns::Device * const			m_device;
-		OptixDeviceContext			m_hContext;
-		DeviceProp					m_devProp;
+		ns::Device * const											m_device;
+		OptixDeviceContext											m_hContext;
+		DeviceProp													m_devProp;
+		std::unique_ptr<Profiler>									m_profiler;
+
+		std::mutex													m_cacheMutex;
+		std::map<std::string, std::weak_ptr<Program>>				m_builtinISPrograms;		//!	Keyed by built-in IS and pipeline compile options.
+		std::map<std::string, std::weak_ptr<LinkedPipeline>>		m_linkedPipelines;			//!	Keyed by program groups, compile and link options.
 	};
 }
\ No newline at end of file
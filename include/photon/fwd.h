@@ -35,7 +35,14 @@ namespace PHOTON_NAMESPACE
 	class Program;
 	class Pipeline;
 	class Denoiser;
+	class DenoiserPool;
+	class BroadPhase;
+	class NeighborSearch;
+	class RayQueryEngine;
+	class SpatialSort;
 	class DeviceContext;
+	class MultiDeviceContext;
+	class Profiler;
 
 	class AccelStruct;
 	class InstAccelStruct;
@@ -46,6 +53,10 @@ namespace PHOTON_NAMESPACE
 	class AccelStructTriangle;
 
 	struct NS_ALIGN(16) Color4f { float r, g, b, a; };
+	struct NS_ALIGN(8) Color4h { unsigned short r, g, b, a; };		//	IEEE 754 half-precision bits (see payload_codec.h).
+	struct NS_ALIGN(2) Color3h { unsigned short r, g, b; };
+	struct NS_ALIGN(4) Color2h { unsigned short x, y; };
+	struct NS_ALIGN(4) Color4ub { unsigned char r, g, b, a; };
 	struct NS_ALIGN(16) Mat4x4 { ns::float4 rows[4]; };
 	struct NS_ALIGN(8) Aabb { ns::float3 lower, upper; };
 
@@ -0,0 +1,184 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "macros.h"
+#include "payload_codec.h"
+#include <optix_device.h>
+#include <utility>
+
+#ifndef __CUDACC__
+	#error This file should be inclued in *.cu files only!
+#endif
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	****************************    HitAttributes    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		A template struct to encapsulate a hit attribute value with its attribute register indices.
+	 *	@details	Mirrors `Payload`: the value is converted to 32-bit attribute registers by `PayloadCodec<Type>`,
+	 *				so the packed encodings (`OctNormal`, `Half2`, `Bitfield`) can be reported by intersection
+	 *				programs and read back in AH/CH programs.
+	 *	@note		OptiX provides up to 8 attribute registers. `numAttributeValues` is the value expected in
+	 *				`OptixPipelineCompileOptions::numAttributeValues`, oversizing it costs registers for every program.
+	 */
+	template<typename Type, unsigned int... Indices> struct HitAttributes
+	{
+		using codec_type = PayloadCodec<Type>;
+
+		using value_type = typename codec_type::value_type;
+
+		static constexpr int numSlots = codec_type::numSlots;
+
+		static_assert(sizeof...(Indices) == numSlots, "Number of indices must match the number of slots of the codec");
+
+		static_assert(((Indices < 8) && ...), "OptiX supports up to 8 attribute values");
+
+		static constexpr unsigned int numAttributeValues = details::maxValue<(Indices + 1)...>();
+
+		unsigned int encodes[numSlots];
+
+		__device__ HitAttributes() {}
+		__device__ HitAttributes(const value_type & v) { codec_type::encode(v, encodes); }
+		__device__ value_type get() const { return codec_type::decode(encodes); }
+		__device__ operator value_type() const { return codec_type::decode(encodes); }
+	};
+
+	/*****************************************************************************
+	***************************    IsHitAttributes    ****************************
+	*****************************************************************************/
+
+	//	@brief		Type trait to detect whether a type is a `HitAttributes`.
+	template<typename Type>							 struct IsHitAttributes								  { static constexpr bool value = false; };
+	template<typename Type, unsigned int... Indices> struct IsHitAttributes<HitAttributes<Type, Indices...>> { static constexpr bool value = true;  };
+
+	/*****************************************************************************
+	*************************    report_intersection    **************************
+	*****************************************************************************/
+
+	namespace details
+	{
+		template<typename Type, unsigned int... Indices> __device__ __forceinline__ void scatterAttributes(unsigned int * slots, const HitAttributes<Type, Indices...> & attributes)
+		{
+			int index = 0;			((slots[Indices] = attributes.encodes[index++]), ...);
+		}
+
+
+		template<unsigned int... Slots> __device__ __forceinline__ bool reportIntersection(float hitT, unsigned int hitKind, const unsigned int * slots, std::integer_sequence<unsigned int, Slots...>)
+		{
+			return optixReportIntersection(hitT, hitKind, slots[Slots]...);
+		}
+	}
+
+
+	/**
+	 *	@brief		Reports an intersection with one or more typed attributes.
+	 *	@details	The attributes are scattered into registers `[0, max(numAttributeValues))`, registers not
+	 *				covered by any attribute are passed as zero.
+	 *	@example	using Normal = HitAttributes<OctNormal, 0>;
+	 *				using UV = HitAttributes<Half2, 1>;
+	 *				report_intersection(t, 0, Normal(n), UV(uv));
+	 *	@see		`optixReportIntersection()`, `get_attributes<Type>()`.
+	 *	@note		Available in IS.
+	 */
+	template<typename... Attributes> __device__ __forceinline__ bool report_intersection(float hitT, unsigned int hitKind, const Attributes &... attributes)
+	{
+		static_assert((IsHitAttributes<Attributes>::value && ...), "Arguments must be HitAttributes");
+
+		constexpr unsigned int numValues = details::maxValue<Attributes::numAttributeValues...>();
+
+		unsigned int slots[numValues > 0 ? numValues : 1] = {};
+
+		(details::scatterAttributes(slots, attributes), ...);
+
+		return details::reportIntersection(hitT, hitKind, slots, std::make_integer_sequence<unsigned int, numValues>());
+	}
+
+
+	/**
+	 *	@brief		Reports an intersection with a single value written into the given attribute registers.
+	 *	@example	report_intersection<OctNormal, 0>(t, 0, normal);
+	 */
+	template<typename Type, unsigned int... Indices> requires(sizeof...(Indices) > 0) __device__ __forceinline__ bool report_intersection(float hitT, unsigned int hitKind, typename PayloadCodec<Type>::value_type value)
+	{
+		return report_intersection(hitT, hitKind, HitAttributes<Type, Indices...>(value));
+	}
+
+	/*****************************************************************************
+	****************************    get_attributes    ****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Returns the 32-bit attribute register at the given index.
+	 *	@see		`optixGetAttribute_0()`.
+	 *	@note		Available in AH, CH.
+	 */
+	template<unsigned int Index> requires(Index < 8) __device__ __forceinline__ unsigned int get_attribute()
+	{
+		if constexpr (Index == 0)		return optixGetAttribute_0();
+		else if constexpr (Index == 1)	return optixGetAttribute_1();
+		else if constexpr (Index == 2)	return optixGetAttribute_2();
+		else if constexpr (Index == 3)	return optixGetAttribute_3();
+		else if constexpr (Index == 4)	return optixGetAttribute_4();
+		else if constexpr (Index == 5)	return optixGetAttribute_5();
+		else if constexpr (Index == 6)	return optixGetAttribute_6();
+		else							return optixGetAttribute_7();
+	}
+
+
+	/**
+	 *	@brief		Retrieves an attribute value of `Type` from one or more registers.
+	 *	@example	float3 normal = get_attributes<OctNormal, 0>();
+	 */
+	template<typename Type, unsigned int... Indices> requires(sizeof...(Indices) > 0) __device__ __forceinline__ auto get_attributes()
+	{
+		int index = 0;			HitAttributes<Type, Indices...> attributes;
+
+		((attributes.encodes[index++] = get_attribute<Indices>()), ...);
+
+		return attributes.get();
+	}
+
+
+	namespace details
+	{
+		template<typename Type> struct GetAttributesImpl;
+
+		template<typename Type, unsigned int... Indices> struct GetAttributesImpl<HitAttributes<Type, Indices...>>
+		{
+			static __device__ __forceinline__ auto invoke() { return get_attributes<Type, Indices...>(); }
+		};
+	}
+
+
+	/**
+	 *	@brief		Retrieves an attribute value when `Type` is already a `HitAttributes`.
+	 *	@example	float3 normal = get_attributes<Normal>();
+	 */
+	template<typename Type> requires(IsHitAttributes<Type>::value) __device__ __forceinline__ typename Type::value_type get_attributes()
+	{
+		return details::GetAttributesImpl<Type>::invoke();
+	}
+}
\ No newline at end of file
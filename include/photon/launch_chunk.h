@@ -0,0 +1,48 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "macros.h"
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*****************************    LaunchChunk    ******************************
+	*****************************************************************************/
+
+	//!	Maximum number of launch indices of a single `optixLaunch()` (width * height * depth).
+	constexpr unsigned long long maxLaunchSize = 1ull << 30;
+
+
+	/**
+	 *	@brief		Part of a 1D launch split by `Pipeline::launchChunked()`.
+	 *	@details	Reserve a field of this type in the launch parameters, it is written for each chunk.
+	 *				The global index of a thread is `params.chunk.offset + optixGetLaunchIndex().x`.
+	 *	@example	struct Params { pt::LaunchChunk chunk; const float3 * queries; unsigned int * results; };
+	 *				pipeline.launchChunked(stream, params, &Params::chunk, sbt, 5'000'000'000ull);
+	 */
+	struct LaunchChunk
+	{
+		unsigned long long		offset;			//!	Global index of the first launch index of the chunk.
+		unsigned long long		count;			//!	Number of launch indices of the chunk, also the launch width.
+	};
+}
\ No newline at end of file
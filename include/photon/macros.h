@@ -31,6 +31,12 @@
 #define __RT_KERNEL__						extern "C" __global__
 #define __RT_CONSTANT__						extern "C" __constant__ static
 
+#ifdef __CUDACC__
+	#define __RT_HOST_DEVICE__				__host__ __device__
+#else
+	#define __RT_HOST_DEVICE__
+#endif
+
 /*********************************************************************************
 ********************************    Namespace    *********************************
 *********************************************************************************/
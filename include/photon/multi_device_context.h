@@ -0,0 +1,123 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include <optix.h>
+#include <nucleus/array_proxy.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	**************************    MultiDeviceContext    **************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		One `DeviceContext` per GPU, to run the same scene on several devices.
+	 *	@details	`replicate()` runs a callback once per device with that device current: the callback creates
+	 *				the module, acceleration structures, pipeline etc. of one device from its context, exactly as
+	 *				for a single GPU. Nothing is copied between devices, so each device uploads its own geometry
+	 *				and runs its own builds. `launch()` then splits a 1D range of launch indices across devices in proportion to their
+	 *				measured throughput, runs the parts concurrently on each device's default stream and waits
+	 *				for all of them. Results are gathered by the callback, e.g. with an asynchronous copy into
+	 *				`[range.offset, range.offset + range.count)` of a host buffer.
+	 *	@note		The same `ns::Device` may be listed several times (logical devices), e.g. for testing.
+	 */
+	class MultiDeviceContext
+	{
+		NS_NONCOPYABLE(MultiDeviceContext)
+
+	public:
+
+		//!	Part of a split launch assigned to one device.
+		struct LaunchRange
+		{
+			size_t		device;			//!	Index of the device in this context.
+			size_t		offset;			//!	First launch index.
+			size_t		count;			//!	Number of launch indices, may be 0.
+		};
+
+		//!	@brief	Create a context per device, see `DeviceContext::DeviceContext()`.
+		PHOTON_API explicit MultiDeviceContext(ns::ArrayProxy<ns::Device*> devices, int logLevel = 3, bool validationMode = false);
+
+		//!	@brief	Destructor.
+		PHOTON_API ~MultiDeviceContext();
+
+	public:
+
+		//!	@brief	Number of devices.
+		size_t size() const { return m_contexts.size(); }
+
+		//!	@brief	Return the context of the device at `index`.
+		const SharedContext & context(size_t index) const { return m_contexts[index]; }
+
+		/**
+		 *	@brief		Create an object per device by calling `func` for each of them.
+		 *	@param[in]	func - Called as `func(index, context)` with the CUDA device of `context` current,
+		 *				the caller's current device is restored afterwards.
+		 *	@return		The objects returned by `func`, one per device.
+		 */
+		template<typename Func> auto replicate(Func && func) -> std::vector<decltype(func(size_t(0), std::declval<const SharedContext&>()))>
+		{
+			std::vector<decltype(func(size_t(0), std::declval<const SharedContext&>()))> objects;
+
+			objects.reserve(m_contexts.size());
+
+			this->forEachDevice([&](size_t index, const SharedContext & context) { objects.push_back(func(index, context)); });
+
+			return objects;
+		}
+
+		//!	@brief	Split `count` launch indices in contiguous ranges, proportionally to the device throughputs.
+		PHOTON_API std::vector<LaunchRange> split(size_t count) const;
+
+		/**
+		 *	@brief		Launch `count` indices across all devices and wait for completion.
+		 *	@param[in]	func - Called as `func(range, stream)` for each device with a non-empty range, with that device
+		 *				current. It enqueues the launch of `[range.offset, range.offset + range.count)` (and the
+		 *				copy of its results) on `stream`, the default stream of that device.
+		 *	@note		The elapsed time of each part updates the throughput of its device for later splits.
+		 *	@return		The ranges that were launched.
+		 */
+		PHOTON_API std::vector<LaunchRange> launch(size_t count, const std::function<void(const LaunchRange & range, ns::Stream & stream)> & func);
+
+		//!	@brief	Launch indices per millisecond of each device, 0 until measured (then split as the average device).
+		const std::vector<double> & throughputs() const { return m_throughputs; }
+
+		//!	@brief	Override the throughput of a device, e.g. from a previous run.
+		void setThroughput(size_t index, double itemsPerMs) { m_throughputs[index] = itemsPerMs; }
+
+	private:
+
+		//!	@brief	Call `func(index, context)` for each device, with that device current.
+		PHOTON_API void forEachDevice(const std::function<void(size_t index, const SharedContext & context)> & func) const;
+
+	private:
+
+		std::vector<SharedContext>			m_contexts;
+		std::vector<double>					m_throughputs;
+		std::vector<void*>					m_events;			//!	`cudaEvent_t` start/stop pairs, one pair per device.
+	};
+}
\ No newline at end of file
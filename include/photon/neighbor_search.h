@@ -0,0 +1,103 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include <nucleus/vector_types.h>
+#include <nucleus/device_pointer.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	****************************    NeighborSearch    ****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Abstract interface for ray-traced fixed-radius neighbor search.
+	 *	@details	An AABB GAS is built over all points and a zero-length ray is traced from each of them,
+	 *				first to count the neighbors, then (after a device scan) to write them. The result is a
+	 *				CSR structure: the neighbors of point `i` are `indices[offsets[i] ... offsets[i + 1])`.
+	 *	@note		Neighbor lists exclude the point itself, the order within a list is unspecified. They are symmetric
+	 *				only if `maxNeighbors` is 0: a capped list keeps an arbitrary subset of the neighbors.
+	 */
+	class NeighborSearch
+	{
+
+	public:
+
+		//!	@brief		Virtual destructor.
+		virtual ~NeighborSearch() {}
+
+	public:
+
+		//!	Description of the point set.
+		struct BuildInput
+		{
+			dev::Ptr<const ns::float3_16a>		positions = nullptr;			//!	Point positions on device memory.
+			unsigned int						numPoints = 0;					//!	Number of points.
+			unsigned int						maxNeighbors = 0;				//!	Maximum length of each list (0 for unlimited), extra neighbors are dropped.
+			float								radius = 0.0f;					//!	Search radius: `j` is a neighbor of `i` if `|pi - pj| < radius`.
+			bool								reorder = true;					//!	Sort points along a Hilbert curve internally (lists still use input indices).
+		};
+
+		//!	Neighbor lists in CSR layout, valid until the next `search()` or `build()`.
+		struct Result
+		{
+			dev::Ptr<const unsigned int>		offsets = nullptr;				//!	`numPoints + 1` offsets into `indices`.
+			dev::Ptr<const unsigned int>		indices = nullptr;				//!	Neighbor indices, `offsets[numPoints]` elements.
+			unsigned int						numIndices = 0;					//!	Total number of neighbors.
+		};
+
+		//!	@brief		Return the current build input.
+		virtual const BuildInput & buildInput() const = 0;
+
+		//!	@brief		Return the result of the last `search()`.
+		virtual const Result & result() const = 0;
+
+		//!	@brief		Retrieve the device context associated with.
+		virtual std::shared_ptr<class DeviceContext> deviceContext() const = 0;
+
+	public:
+
+		/**
+		 *	@brief		Build the acceleration structure over the points.
+		 *	@param[in]	stream - CUDA stream to enqueue the work on.
+		 *	@param[in]	allocator - Allocator for the GAS and the CSR buffers.
+		 *	@param[in]	buildInput - Point set, the buffer must stay valid until the next `build()`.
+		 */
+		virtual void build(ns::Stream & stream, ns::AllocPtr allocator, const BuildInput & buildInput) = 0;
+
+
+		/**
+		 *	@brief		Refit the acceleration structure after points moved in-place.
+		 *	@note		Intended to be called between solver steps instead of `build()`.
+		 */
+		virtual void refit(ns::Stream & stream) = 0;
+
+
+		/**
+		 *	@brief		Build the neighbor lists: count pass, exclusive scan, fill pass.
+		 *	@details	The stream is synchronized once to read back the total number of neighbors.
+		 */
+		virtual const Result & search(ns::Stream & stream) = 0;
+	};
+}
\ No newline at end of file
@@ -22,7 +22,10 @@
 #pragma once
 
 #include "macros.h"
+#include "payload_codec.h"
 #include <cuda_runtime.h>
+#include <optix_device.h>
+#include <utility>
 
 #ifndef __CUDACC__
 	#error This file should be inclued in *.cu files only!
@@ -36,12 +39,40 @@ namespace PHOTON_NAMESPACE
 
 	/**
 	 *	@brief		A template struct to encapsulate a payload value with its corresponding indices for OptiX.
+	 *	@details	The value is converted to 32-bit slots by `PayloadCodec<Type>`, so packed encodings
+	 *				can be selected with a tag type, e.g. `Payload<OctNormal, 0>` carries a `float3`
+	 *				normal in a single slot. The decoded value is returned by `get()`.
+	 *	@see		`PayloadCodec`, `OctNormal`, `Half2`, `Bitfield`.
+	 */
+	template<typename Type, unsigned int... Indices> struct Payload
+	{
+		using codec_type = PayloadCodec<Type>;
+
+		using value_type = typename codec_type::value_type;
+
+		static constexpr int numSlots = codec_type::numSlots;
+
+		static_assert(sizeof...(Indices) == numSlots, "Number of indices must match the number of slots of the codec");
+
+		unsigned int encodes[numSlots];
+
+		__device__ Payload() {}
+		__device__ Payload(const value_type & v) { codec_type::encode(v, encodes); }
+		__device__ value_type get() const { return codec_type::decode(encodes); }
+		__device__ operator value_type() const { return codec_type::decode(encodes); }
+	};
+
+
+	/**
+	 *	@brief		Specialization for raw (bitwise copied) types.
 	 *	@details	This struct uses a union to map the payload value to an array of 32-bit unsigned integers,
 	 *				allowing it to be passed to Optix's payload system. The number of slots is computed based
 	 *				on the size of Type, rounded up to the nearest 32-bit boundary.
 	 */
-	template<typename Type, unsigned int... Indices> struct Payload
+	template<typename Type, unsigned int... Indices> requires(PayloadCodec<Type>::isRaw) struct Payload<Type, Indices...>
 	{
+		using codec_type = PayloadCodec<Type>;
+
 		using value_type = Type;
 
 		static constexpr int numSlots = (sizeof(Type) + 3) / 4;
@@ -56,6 +87,7 @@ namespace PHOTON_NAMESPACE
 
 		__device__ Payload() {}
 		__device__ Payload(value_type v) : value(v) {}
+		__device__ value_type get() const { return value; }
 		__device__ operator value_type&() { return value; }
 		__device__ operator const value_type&() const { return value; }
 	};
@@ -68,6 +100,84 @@ namespace PHOTON_NAMESPACE
 	template<typename Type>							 struct IsPayload							 { static constexpr bool value = false; };
 	template<typename Type, unsigned int... Indices> struct IsPayload<Payload<Type, Indices...>> { static constexpr bool value = true;  };
 
+	/*****************************************************************************
+	*****************************    LargePayload    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Per-ray state split into a hot part kept in payload registers and a cold part kept in memory.
+	 *	@details	Payload values are limited to 32 slots (128 bytes). `LargePayload` stores `Hot` (through its
+	 *				`PayloadCodec`) in slots `[First, First + numHotSlots)` and a pointer to `Cold` in the next
+	 *				two slots, so the split between registers and memory is chosen by which fields are put in `Hot`.
+	 *				`Cold` usually lives on the stack of the raygen program (per launch index local memory),
+	 *				or in a global scratch buffer of one element per launch index, see `fromScratch()`.
+	 *				Which fields are hot is chosen by the caller, they are not placed automatically.
+	 *	@example	struct PathState { float3 throughput; float3 radiance; unsigned int depth; };
+	 *				struct PathHistory { float3 vertices[16]; float pdfs[16]; };
+	 *				using PathPayload = LargePayload<PathState, PathHistory, 0>;		//	slots 0-6 in registers, 7-8 pointer.
+	 *				//	__raygen__:
+	 *				PathHistory history;		PathPayload payload(state, &history);
+	 *				optixTrace(..., payload.encodes[0], ..., payload.encodes[8]);
+	 *				//	__closesthit__:
+	 *				PathPayload payload = get_payload<PathPayload>();
+	 *				payload.cold()->pdfs[depth] = pdf;		payload.setHot(state);		set_payload(payload);
+	 */
+	template<typename Hot, typename Cold, unsigned int First = 0> struct LargePayload
+	{
+		using hot_codec = PayloadCodec<Hot>;
+
+		using hot_type = typename hot_codec::value_type;
+
+		using cold_type = Cold;
+
+		static constexpr unsigned int firstIndex = First;
+
+		static constexpr unsigned int numHotSlots = hot_codec::numSlots;
+
+		static constexpr int numSlots = numHotSlots + 2;
+
+		static_assert(First + numSlots <= 32, "Hot slots and the cold pointer must fit into 32 payload slots");
+
+		unsigned int encodes[numSlots];
+
+		__device__ LargePayload() {}
+		__device__ LargePayload(const hot_type & hotValue, Cold * coldPtr) { this->setHot(hotValue);	this->setCold(coldPtr); }
+
+		/**
+		 *	@brief		Payload whose cold part is the element of the current launch index in a global scratch buffer.
+		 *	@param[in]	scratch - One element per launch index (`width * height * depth`), e.g. an `ns::Array<Cold>`
+		 *				passed through the launch parameters.
+		 *	@note		Available in RG.
+		 */
+		static __device__ LargePayload fromScratch(const hot_type & hotValue, Cold * scratch)
+		{
+			const uint3 index = optixGetLaunchIndex();
+			const uint3 dims = optixGetLaunchDimensions();
+
+			return LargePayload(hotValue, scratch + (static_cast<size_t>(index.z) * dims.y + index.y) * dims.x + index.x);
+		}
+
+		__device__ hot_type hot() const { return hot_codec::decode(encodes); }
+		__device__ void setHot(const hot_type & hotValue) { hot_codec::encode(hotValue, encodes); }
+
+		__device__ Cold * cold() const
+		{
+			return reinterpret_cast<Cold*>(static_cast<unsigned long long>(encodes[numHotSlots]) | (static_cast<unsigned long long>(encodes[numHotSlots + 1]) << 32));
+		}
+
+		__device__ void setCold(Cold * coldPtr)
+		{
+			const unsigned long long address = reinterpret_cast<unsigned long long>(coldPtr);
+
+			encodes[numHotSlots + 0] = static_cast<unsigned int>(address);
+			encodes[numHotSlots + 1] = static_cast<unsigned int>(address >> 32);
+		}
+	};
+
+	//	@brief		Type trait to detect whether a type is a `LargePayload`.
+	template<typename Type>                                   struct IsLargePayload                                 { static constexpr bool value = false; };
+	template<typename Hot, typename Cold, unsigned int First> struct IsLargePayload<LargePayload<Hot, Cold, First>> { static constexpr bool value = true;  };
+
 	/*****************************************************************************
 	*****************************    set_payload    ******************************
 	*****************************************************************************/
@@ -101,10 +211,10 @@ namespace PHOTON_NAMESPACE
 	 *	@brief		Writes a value directly into multiple payload slots.
 	 *	@details	This function constructs a temporary `Payload<Type, Indices...>` from the given value,
 	 *				and forwards it to the multi-slot `set_payload(Payload<...>)` overload.
-	 *	@example	set_payload<ns::float3, 0, 1, 2>(rayOrigin);
+	 *	@example	set_payload<ns::float3, 0, 1, 2>(rayOrigin);		set_payload<OctNormal, 3>(normal);
 	 *	@warning	`Type` must not be a `Payload` for avoid ambiguity.
 	 */
-	template<typename Type, unsigned int... Indices> __device__ __forceinline__ void set_payload(Type value)
+	template<typename Type, unsigned int... Indices> __device__ __forceinline__ void set_payload(typename PayloadCodec<Type>::value_type value)
 	{
 		static_assert(!IsPayload<Type>::value, "Type must not be a Payload");
 
@@ -157,7 +267,7 @@ namespace PHOTON_NAMESPACE
 	 *	@details	This function reads 32-bit values from the specified indices and assembles them into a single value of `Type` using a fold expression.
 	 *	@example	auto rayOrigin = get_payload<ns::float3, 0, 1, 2>();
 	 */
-	template<typename Type, unsigned int... Indices> __device__ __forceinline__ auto get_payload()
+	template<typename Type, unsigned int... Indices> requires(sizeof...(Indices) > 0) __device__ __forceinline__ auto get_payload()
 	{
 		return details::GetPayloadImpl<Type, Indices...>::invoke();
 	}
@@ -169,11 +279,55 @@ namespace PHOTON_NAMESPACE
 	 */
 	template<typename Type> __device__ __forceinline__ Type get_payload()
 	{
-		static_assert(IsPayload<Type>::value, "Type must be a Payload");
+		static_assert(IsPayload<Type>::value || IsLargePayload<Type>::value, "Type must be a Payload");
 
 		return details::GetPayloadImpl<Type>::invoke();
 	}
 
+	/*****************************************************************************
+	***************************    LargePayload I/O    ***************************
+	*****************************************************************************/
+
+	namespace details
+	{
+		template<unsigned int First, unsigned int... Offsets> __device__ __forceinline__ void setPayloadRange(const unsigned int * encodes, std::integer_sequence<unsigned int, Offsets...>)
+		{
+			(set_payload<First + Offsets>(encodes[Offsets]), ...);
+		}
+
+
+		template<unsigned int First, unsigned int... Offsets> __device__ __forceinline__ void getPayloadRange(unsigned int * encodes, std::integer_sequence<unsigned int, Offsets...>)
+		{
+			((encodes[Offsets] = get_payload<First + Offsets>()), ...);
+		}
+
+
+		//!	Specialization of `GetPayloadImpl` for `LargePayload` types.
+		template<typename Hot, typename Cold, unsigned int First> struct GetPayloadImpl<LargePayload<Hot, Cold, First>>
+		{
+			using PayloadType = LargePayload<Hot, Cold, First>;
+
+			static __device__ __forceinline__ PayloadType invoke()
+			{
+				PayloadType payload;
+
+				getPayloadRange<First>(payload.encodes, std::make_integer_sequence<unsigned int, PayloadType::numSlots>());
+
+				return payload;
+			}
+		};
+	}
+
+
+	/**
+	 *	@brief		Writes the hot slots and the cold pointer of a `LargePayload`.
+	 *	@note		Only the slots are written, `Cold` is shared through the pointer and modified in place.
+	 */
+	template<typename Hot, typename Cold, unsigned int First> __device__ __forceinline__ void set_payload(const LargePayload<Hot, Cold, First> & payload)
+	{
+		details::setPayloadRange<First>(payload.encodes, std::make_integer_sequence<unsigned int, LargePayload<Hot, Cold, First>::numSlots>());
+	}
+
 	/*****************************************************************************
 	***************************    __PayloadExample    ***************************
 	*****************************************************************************/
@@ -212,5 +366,22 @@ namespace PHOTON_NAMESPACE
 		rayDir = get_payload<RayDirType>();
 		rayOrigin = get_payload<RayOrginType>();
 		rayOrigin = get_payload<float3, 4, 5, 6>();
+
+
+		/**
+		 *	Step-4:	Packed encodings save payload registers:
+		 *			- `OctNormal` stores a unit `float3` in one slot.
+		 *			- `Half2` stores a `float2` as two halves in one slot.
+		 *			- `Bitfield<Bits...>` packs small unsigned fields into one slot.
+		 */
+		using NormalType = Payload<OctNormal, 7>;
+		using FlagsType = Payload<Bitfield<1, 7, 24>, 8>;
+
+		set_payload<Half2, 9>(float2{ 0.25f, 0.75f });
+		set_payload(NormalType(float3{ 0.0f, 0.0f, 1.0f }));
+
+		float3 normal = get_payload<NormalType>();
+		FlagsType::value_type flags = get_payload<FlagsType>().get();
+		float2 uv = get_payload<Half2, 9>();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "macros.h"
+#include <vector_types.h>
+#include <math.h>
+#include <string.h>
+
+#ifndef __CUDA_ARCH__
+	#include <bit>
+#endif
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*****************************    PayloadCodec    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Maps a value to 32-bit payload (or attribute) slots.
+	 *	@details	A codec provides `value_type`, the number of slots `numSlots`, and
+	 *				`encode(value, slots)` / `decode(slots)`. The primary template copies the raw bytes
+	 *				of `Type` into `(sizeof(Type) + 3) / 4` slots. Tag types such as `OctNormal`, `Half2` or
+	 *				`Bitfield` select packed encodings, e.g. `Payload<OctNormal, 3>` stores a unit vector
+	 *				in a single slot instead of three.
+	 *	@note		Usable on host and device, so encodings can be unit tested on the CPU.
+	 */
+	template<typename Type> struct PayloadCodec
+	{
+		using value_type = Type;
+
+		static constexpr bool isRaw = true;
+
+		static constexpr unsigned int numSlots = (sizeof(Type) + 3) / 4;
+
+		static __RT_HOST_DEVICE__ void encode(const value_type & value, unsigned int * slots)
+		{
+			memcpy(slots, &value, sizeof(Type));
+		}
+
+		static __RT_HOST_DEVICE__ value_type decode(const unsigned int * slots)
+		{
+			value_type value;		memcpy(&value, slots, sizeof(Type));		return value;
+		}
+	};
+
+	namespace details
+	{
+		//!	Largest value of `Values`, zero if empty.
+		template<unsigned int... Values> constexpr unsigned int maxValue()
+		{
+			unsigned int result = 0;			((result = (Values > result) ? Values : result), ...);			return result;
+		}
+
+
+		__RT_HOST_DEVICE__ inline unsigned int floatAsUint(float value)
+		{
+		#ifdef __CUDA_ARCH__
+			return __float_as_uint(value);
+		#else
+			return std::bit_cast<unsigned int>(value);
+		#endif
+		}
+
+
+		__RT_HOST_DEVICE__ inline float uintAsFloat(unsigned int value)
+		{
+		#ifdef __CUDA_ARCH__
+			return __uint_as_float(value);
+		#else
+			return std::bit_cast<float>(value);
+		#endif
+		}
+
+
+		//!	IEEE 754 binary16 conversion, round to nearest even (bit exact on host and device).
+		__RT_HOST_DEVICE__ inline unsigned short floatToHalf(float value)
+		{
+			const unsigned int bits = floatAsUint(value);
+			const unsigned int sign = (bits >> 16) & 0x8000u;
+			const unsigned int absBits = bits & 0x7FFFFFFFu;
+
+			if (absBits >= 0x7F800000u)				//	Inf / NaN
+			{
+				return static_cast<unsigned short>(sign | ((absBits > 0x7F800000u) ? 0x7E00u : 0x7C00u));
+			}
+			else if (absBits >= 0x477FF000u)		//	Rounds to infinity (>= 65520).
+			{
+				return static_cast<unsigned short>(sign | 0x7C00u);
+			}
+			else if (absBits < 0x33000000u)			//	Rounds to zero (< 2^-25).
+			{
+				return static_cast<unsigned short>(sign);
+			}
+			else if (absBits < 0x38800000u)			//	Subnormal half.
+			{
+				const unsigned int mantissa = (absBits & 0x7FFFFFu) | 0x800000u;
+				const unsigned int shift = 126u - (absBits >> 23);
+				const unsigned int remainder = mantissa & ((1u << shift) - 1u);
+				const unsigned int halfway = 1u << (shift - 1u);
+
+				unsigned int half = mantissa >> shift;
+				half += ((remainder > halfway) || ((remainder == halfway) && (half & 1u))) ? 1u : 0u;
+
+				return static_cast<unsigned short>(sign | half);
+			}
+			else
+			{
+				const unsigned int remainder = absBits & 0x1FFFu;
+
+				unsigned int half = (absBits - 0x38000000u) >> 13;
+				half += ((remainder > 0x1000u) || ((remainder == 0x1000u) && (half & 1u))) ? 1u : 0u;
+
+				return static_cast<unsigned short>(sign | half);
+			}
+		}
+
+
+		__RT_HOST_DEVICE__ inline float halfToFloat(unsigned short half)
+		{
+			const unsigned int sign = (half & 0x8000u) << 16;
+			const unsigned int exponent = (half >> 10) & 0x1Fu;
+			const unsigned int mantissa = half & 0x3FFu;
+
+			if (exponent == 0)
+			{
+				const float value = static_cast<float>(mantissa) * 5.9604644775390625e-8f;		//	mantissa * 2^-24
+
+				return sign ? -value : value;
+			}
+			else if (exponent == 31)
+			{
+				return uintAsFloat(sign | 0x7F800000u | (mantissa << 13));
+			}
+			else
+			{
+				return uintAsFloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+			}
+		}
+
+
+		//!	Signed normalized 16-bit quantization of a value in [-1, 1].
+		__RT_HOST_DEVICE__ inline unsigned int toSnorm16(float value)
+		{
+			value = fminf(fmaxf(value, -1.0f), 1.0f) * 32767.0f;
+
+			return static_cast<unsigned int>(static_cast<int>(value + ((value >= 0.0f) ? 0.5f : -0.5f))) & 0xFFFFu;
+		}
+
+
+		__RT_HOST_DEVICE__ inline float fromSnorm16(unsigned int value)
+		{
+			return static_cast<short>(value & 0xFFFFu) / 32767.0f;
+		}
+	}
+
+	/*****************************************************************************
+	******************************    OctNormal    *******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Tag type: unit vector in 1 slot, octahedral mapping with 16 bits per coordinate.
+	 *	@note		Angular error is below 1e-4 radians, the input does not need to be normalized.
+	 */
+	struct OctNormal {};
+
+	template<> struct PayloadCodec<OctNormal>
+	{
+		using value_type = float3;
+
+		static constexpr bool isRaw = false;
+
+		static constexpr unsigned int numSlots = 1;
+
+		static __RT_HOST_DEVICE__ void encode(const value_type & value, unsigned int * slots)
+		{
+			const float sum = fabsf(value.x) + fabsf(value.y) + fabsf(value.z);
+			const float scale = (sum > 0.0f) ? (1.0f / sum) : 0.0f;
+
+			float u = value.x * scale;
+			float v = value.y * scale;
+
+			if (value.z < 0.0f)
+			{
+				const float foldU = (1.0f - fabsf(v)) * ((u >= 0.0f) ? 1.0f : -1.0f);
+				const float foldV = (1.0f - fabsf(u)) * ((v >= 0.0f) ? 1.0f : -1.0f);
+
+				u = foldU;
+				v = foldV;
+			}
+
+			slots[0] = details::toSnorm16(u) | (details::toSnorm16(v) << 16);
+		}
+
+		static __RT_HOST_DEVICE__ value_type decode(const unsigned int * slots)
+		{
+			float x = details::fromSnorm16(slots[0]);
+			float y = details::fromSnorm16(slots[0] >> 16);
+			float z = 1.0f - fabsf(x) - fabsf(y);
+			float t = fmaxf(-z, 0.0f);
+
+			x += (x >= 0.0f) ? -t : t;
+			y += (y >= 0.0f) ? -t : t;
+
+			const float invLength = 1.0f / sqrtf(x * x + y * y + z * z);
+
+			return value_type{ x * invLength, y * invLength, z * invLength };
+		}
+	};
+
+	/*****************************************************************************
+	********************************    Half2    *********************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Tag type: two floats as IEEE half precision in 1 slot (e.g. texture coordinates, barycentrics).
+	 */
+	struct Half2 {};
+
+	template<> struct PayloadCodec<Half2>
+	{
+		using value_type = float2;
+
+		static constexpr bool isRaw = false;
+
+		static constexpr unsigned int numSlots = 1;
+
+		static __RT_HOST_DEVICE__ void encode(const value_type & value, unsigned int * slots)
+		{
+			slots[0] = details::floatToHalf(value.x) | (static_cast<unsigned int>(details::floatToHalf(value.y)) << 16);
+		}
+
+		static __RT_HOST_DEVICE__ value_type decode(const unsigned int * slots)
+		{
+			return value_type{ details::halfToFloat(static_cast<unsigned short>(slots[0] & 0xFFFFu)), details::halfToFloat(static_cast<unsigned short>(slots[0] >> 16)) };
+		}
+	};
+
+	/*****************************************************************************
+	*******************************    Bitfield    *******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Tag type: several small unsigned fields (`Bits` wide each) packed into 1 slot.
+	 *	@example	using HitInfo = Payload<Bitfield<1, 7, 24>, 4>;		//	flag, depth, instance id
+	 *				HitInfo::value_type info;	info[0] = 1;	info[1] = depth;	info[2] = instanceId;
+	 *	@note		Values are truncated to their field width.
+	 */
+	template<unsigned int... Bits> struct Bitfield
+	{
+		static_assert(sizeof...(Bits) > 0, "Bitfield requires at least one field");
+		static_assert((Bits + ...) <= 32, "Bitfield must fit into a single 32-bit slot");
+		static_assert(((Bits > 0) && ...), "Bitfield widths must be positive");
+
+		static constexpr unsigned int numFields = sizeof...(Bits);
+
+		//!	Unpacked fields.
+		struct Fields
+		{
+			unsigned int values[numFields];
+
+			constexpr __RT_HOST_DEVICE__ unsigned int & operator[](unsigned int index) { return values[index]; }
+			constexpr __RT_HOST_DEVICE__ const unsigned int & operator[](unsigned int index) const { return values[index]; }
+		};
+	};
+
+	template<unsigned int... Bits> struct PayloadCodec<Bitfield<Bits...>>
+	{
+		using value_type = typename Bitfield<Bits...>::Fields;
+
+		static constexpr bool isRaw = false;
+
+		static constexpr unsigned int numSlots = 1;
+
+		static constexpr __RT_HOST_DEVICE__ unsigned int mask(unsigned int bits) { return (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1u); }
+
+		static constexpr __RT_HOST_DEVICE__ void encode(const value_type & value, unsigned int * slots)
+		{
+			unsigned int index = 0, offset = 0, result = 0;
+
+			((result |= (value[index++] & mask(Bits)) << offset, offset += Bits), ...);
+
+			slots[0] = result;
+		}
+
+		static constexpr __RT_HOST_DEVICE__ value_type decode(const unsigned int * slots)
+		{
+			unsigned int index = 0, offset = 0;		value_type value = {};
+
+			((value[index++] = (slots[0] >> offset) & mask(Bits), offset += Bits), ...);
+
+			return value;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "macros.h"
+#include "payload_codec.h"
+#include <optix.h>
+#include <array>
+#include <algorithm>
+
+#if OPTIX_VERSION >= 70400
+
+namespace PHOTON_NAMESPACE
+{
+	template<typename Type, unsigned int... Indices> struct Payload;
+	template<typename Hot, typename Cold, unsigned int First> struct LargePayload;
+
+	/*****************************************************************************
+	*****************************    PayloadField    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Binds a `Payload<Type, Indices...>` alias to its read/write semantics.
+	 *	@details	`Semantics` is a bitwise OR of `OptixPayloadSemantics` values and applies to every slot
+	 *				of the payload, e.g. `OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_READ | OPTIX_PAYLOAD_SEMANTICS_CH_WRITE`
+	 *				for a value written by the closest-hit program and read back after `optixTrace()`.
+	 *	@note		Only the payload declaration is needed, so this header can be used on host and device.
+	 */
+	template<typename PayloadType, unsigned int Semantics> struct PayloadField;
+
+	template<typename Type, unsigned int... Indices, unsigned int Semantics> struct PayloadField<Payload<Type, Indices...>, Semantics>
+	{
+		static constexpr unsigned int semantics = Semantics;
+
+		static constexpr unsigned int numPayloadValues = std::max({ (Indices + 1)... });
+	};
+
+
+	//!	A `LargePayload` covers its hot slots and the two slots of the cold pointer.
+	template<typename Hot, typename Cold, unsigned int First, unsigned int Semantics> struct PayloadField<LargePayload<Hot, Cold, First>, Semantics>
+	{
+		static constexpr unsigned int semantics = Semantics;
+
+		static constexpr unsigned int firstIndex = First;
+
+		static constexpr unsigned int numPayloadValues = First + PayloadCodec<Hot>::numSlots + 2;
+	};
+
+	/*****************************************************************************
+	****************************    PayloadLayout    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Compile-time description of a payload type, built from `PayloadField`s.
+	 *	@details	Generates the per-slot semantics array of an `OptixPayloadType`. Slots not covered by any
+	 *				field get no semantics at all, so the compiler can drop them. Slots shared by several fields
+	 *				get the union of their semantics.
+	 *	@example	using Radiance = Payload<float3, 0, 1, 2>;
+	 *				using Depth = Payload<unsigned int, 3>;
+	 *				using Layout = PayloadLayout<PayloadField<Radiance, OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_READ | OPTIX_PAYLOAD_SEMANTICS_CH_WRITE | OPTIX_PAYLOAD_SEMANTICS_MS_WRITE>,
+	 *											 PayloadField<Depth, OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_WRITE | OPTIX_PAYLOAD_SEMANTICS_CH_READ>>;
+	 *				auto module = context->createModule(ptx, pipelineCompileOptions, { Layout::payloadType() });
+	 */
+	template<typename... Fields> struct PayloadLayout
+	{
+		static_assert(sizeof...(Fields) > 0, "A payload layout requires at least one field");
+
+		static constexpr unsigned int numPayloadValues = std::max({ Fields::numPayloadValues... });
+
+		static_assert(numPayloadValues <= 32, "OptiX supports up to 32 payload values");
+
+	private:
+
+		template<typename Type, unsigned int... Indices, unsigned int Semantics>
+		static constexpr void accumulate(std::array<unsigned int, numPayloadValues> & result, PayloadField<Payload<Type, Indices...>, Semantics>*)
+		{
+			((result[Indices] |= Semantics), ...);
+		}
+
+
+		template<typename Hot, typename Cold, unsigned int First, unsigned int Semantics>
+		static constexpr void accumulate(std::array<unsigned int, numPayloadValues> & result, PayloadField<LargePayload<Hot, Cold, First>, Semantics>*)
+		{
+			for (unsigned int i = First; i < PayloadField<LargePayload<Hot, Cold, First>, Semantics>::numPayloadValues; i++)
+			{
+				result[i] |= Semantics;
+			}
+		}
+
+		static constexpr std::array<unsigned int, numPayloadValues> makeSemantics()
+		{
+			std::array<unsigned int, numPayloadValues> result = {};
+
+			(accumulate(result, static_cast<Fields*>(nullptr)), ...);
+
+			return result;
+		}
+
+	public:
+
+		//!	Per-slot semantics, `numPayloadValues` elements.
+		static constexpr std::array<unsigned int, numPayloadValues> semantics = makeSemantics();
+
+		//!	Payload type referencing `semantics`, to be passed to `DeviceContext::createModule()`.
+		static OptixPayloadType payloadType()
+		{
+			OptixPayloadType payloadType = {};
+			payloadType.numPayloadValues = numPayloadValues;
+			payloadType.payloadSemantics = semantics.data();
+			return payloadType;
+		}
+	};
+}
+
+#endif
\ No newline at end of file
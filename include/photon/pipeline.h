@@ -23,13 +23,19 @@
 
 #include "fwd.h"
 #include "sbt_record.h"
+#include "launch_chunk.h"
 #include <nucleus/array_proxy.h>
 #include <nucleus/device_pointer.h>
 #include <optix.h>
+#include <type_traits>
+#include <string_view>
 #include <string>
 
 namespace PHOTON_NAMESPACE
 {
+	class LinkedPipeline;
+	class ChunkedLauncher;
+
 	/*****************************************************************************
 	********************************    Module    ********************************
 	*****************************************************************************/
@@ -38,6 +44,8 @@ namespace PHOTON_NAMESPACE
 	 *	@brief		Abstract interface for an OptiX module.
 	 *	@note		Represents a compiled OptiX module that contains one or more
 	 *				program entry points. Programs can be retrieved by name.
+	 *	@note		Thread-safe: `at()` may be called concurrently, lookups of existing programs
+	 *				only take a shared lock of one cache shard.
 	 */
 	class Module
 	{
@@ -53,9 +61,11 @@ namespace PHOTON_NAMESPACE
 		 *	@note		The function name must match one of the PTX entry points defined
 		 *				in this module, such as "__raygen__xxx" or "__miss__yyy".
 		 * @param[in]	funcName - The PTX function entry name.
-		 * @return		A shared pointer to the corresponding Program.
+		 * @param[in]	payloadTypeIndex - Index of the payload type used by the program, if the module
+		 *				was created with payload types (see `payload_layout.h`), ignored otherwise.
+		 * @return		A shared pointer to the corresponding Program, the same one while it is alive.
 		 */
-		virtual std::shared_ptr<Program> at(const std::string & funcName) = 0;
+		virtual std::shared_ptr<Program> at(std::string_view funcName, unsigned int payloadTypeIndex = 0) = 0;
 	};
 
 	/*****************************************************************************
@@ -123,7 +133,11 @@ namespace PHOTON_NAMESPACE
 
 	public:
 
-		//!	@brief	
+		/**
+		 *	@brief		Create a pipeline from programs of the context.
+		 *	@note		Linking is cached by the context: pipelines created from the same programs with equal
+		 *				compile and link options share one `OptixPipeline`, which is destroyed with the last of them.
+		 */
 		PHOTON_API explicit Pipeline(SharedContext context,
 									 ns::ArrayProxy<std::shared_ptr<Program>> programs,
 									 const OptixPipelineCompileOptions & pipelineCompileOptions = OptixPipelineCompileOptions{},
@@ -134,6 +148,9 @@ namespace PHOTON_NAMESPACE
 
 	public:
 
+		//!	@brief	Return the native handle, shared with equal pipelines of the same context.
+		OptixPipeline handle() const { return m_hPipeline; }
+
 		/**
 		 *	@brief		Launch the pipeline with the given parameters.
 		 *	@tparam		Type - Type of the pipeline parameter structure.
@@ -150,7 +167,30 @@ namespace PHOTON_NAMESPACE
 		 */
 		template<typename Type> ns::Stream & launch(ns::Stream & stream, ns::dev::Ptr<const Type> pipelineParams, const OptixShaderBindingTable & sbt, size_t width, size_t height = 1, size_t depth = 1)
 		{
-			this->doLaunch(stream, pipelineParams.data(), sizeof(Type), sbt, static_cast<unsigned int>(width), static_cast<unsigned int>(height), static_cast<unsigned int>(depth));
+			this->doLaunch(stream, pipelineParams.data(), sizeof(Type), sbt, width, height, depth);
+
+			return stream;
+		}
+
+
+		/**
+		 *	@brief		Launch `count` 1D indices, split into chunks of at most `chunkSize` launches (see `LaunchChunk`).
+		 *	@param[in]	stream - CUDA stream the launch is ordered with: chunks start after the work already
+		 *				enqueued on it, and work enqueued afterwards starts after the last chunk.
+		 *	@param[in]	pipelineParams - Host copy of the launch parameters, uploaded once per chunk with
+		 *				`pipelineParams.*chunk` set to the chunk.
+		 *	@param[in]	chunk - Field reserved for the chunk in the launch parameters.
+		 *	@note		Chunks are spread over a small pool of internal streams: the parameter upload of a chunk
+		 *				overlaps the execution of the previous one. Chunks may run concurrently, so programs must
+		 *				not depend on the order of launch indices across chunks.
+		 */
+		template<typename Type> ns::Stream & launchChunked(ns::Stream & stream, const Type & pipelineParams, LaunchChunk Type::*chunk, const OptixShaderBindingTable & sbt, size_t count, size_t chunkSize = maxLaunchSize)
+		{
+			static_assert(std::is_trivially_copyable_v<Type>, "Launch parameters must be trivially copyable");
+
+			const size_t chunkOffset = reinterpret_cast<const char*>(&(pipelineParams.*chunk)) - reinterpret_cast<const char*>(&pipelineParams);
+
+			this->doLaunchChunked(stream, &pipelineParams, sizeof(Type), chunkOffset, sbt, count, chunkSize);
 
 			return stream;
 		}
@@ -161,12 +201,19 @@ namespace PHOTON_NAMESPACE
 		 *	@brief		Internal implementation of pipeline launch.
 		 *	@note		This is the low-level entry point that forwards the call to the OptiX API with untyped pipeline parameters.
 		 */
-		PHOTON_API void doLaunch(ns::Stream & stream, const void * pipelineParams, size_t pipelineParamsSize, const OptixShaderBindingTable & sbt, unsigned int width, unsigned int height, unsigned int depth);
+		PHOTON_API void doLaunch(ns::Stream & stream, const void * pipelineParams, size_t pipelineParamsSize, const OptixShaderBindingTable & sbt, size_t width, size_t height, size_t depth);
+
+		//!	@brief	Internal implementation of chunked launches, `hostParams` is copied per chunk.
+		PHOTON_API void doLaunchChunked(ns::Stream & stream, const void * hostParams, size_t pipelineParamsSize, size_t chunkOffset, const OptixShaderBindingTable & sbt, size_t count, size_t chunkSize);
 
 	private:
 
-		const SharedContext 	m_context;
+		const SharedContext 					m_context;
+
+		std::shared_ptr<LinkedPipeline>			m_linkedPipeline;
+
+		std::unique_ptr<ChunkedLauncher>		m_chunkedLauncher;
 
-		OptixPipeline			m_hPipeline;
+		OptixPipeline							m_hPipeline;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include <string>
+#include <vector>
+#include <array>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*******************************    Profiler    *******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Abstract interface for the built-in GPU profiler of a device context.
+	 *	@details	When enabled, CUDA events are recorded around acceleration structure builds, refits and
+	 *				compactions, instance transform updates, pipeline launches and denoiser phases. Timings
+	 *				are aggregated per operation and per object (accel struct, pipeline, denoiser), and can be
+	 *				queried with `stats()` or exported as a Chrome trace (chrome://tracing, Perfetto).
+	 *	@note		Disabled by default. Setting the environment variable `PHOTON_PROFILE` to `1` enables it
+	 *				at context creation, any other value is taken as the path of a Chrome trace written when
+	 *				the context is destroyed.
+	 *	@example	deviceContext->profiler()->setEnabled(true);
+	 *				...
+	 *				for (const auto & stats : deviceContext->profiler()->stats())
+	 *					printf("%s [%s]: %.3f ms\n", stats.operation.c_str(), stats.object.c_str(), stats.meanMs());
+	 */
+	class Profiler
+	{
+
+	public:
+
+		//!	@brief		Virtual destructor.
+		virtual ~Profiler() {}
+
+	public:
+
+		//!	Number of bins of the duration histogram, bin `i` counts durations in [2^(i-1), 2^i) microseconds.
+		static constexpr unsigned int numHistogramBins = 24;
+
+		//!	Aggregated timings of one operation on one object.
+		struct Stats
+		{
+			std::string										operation;			//!	Name of the operation, e.g. `optixAccelBuild`.
+			std::string										object;				//!	Label of the object (see `setLabel()`).
+			size_t											count = 0;			//!	Number of recorded calls.
+			double											totalMs = 0.0;		//!	Sum of the GPU durations in milliseconds.
+			double											minMs = 0.0;		//!	Shortest GPU duration in milliseconds.
+			double											maxMs = 0.0;		//!	Longest GPU duration in milliseconds.
+			std::array<unsigned int, numHistogramBins>		histogram = {};		//!	Distribution of the durations.
+
+			double meanMs() const { return count ? totalMs / count : 0.0; }
+		};
+
+
+		/**
+		 *	@brief		Records the GPU duration of the work enqueued on `stream` during its lifetime.
+		 *	@note		`operation` must be a string literal, it is not copied until the record is resolved.
+		 */
+		class Scope
+		{
+			NS_NONCOPYABLE(Scope)
+
+		public:
+
+			Scope(Profiler * profiler, ns::Stream & stream, const char * operation, const void * object)
+				: m_profiler(profiler), m_record(profiler->isEnabled() ? profiler->begin(stream, operation, object) : invalidRecord) {}
+
+			~Scope() { if (m_record != invalidRecord) m_profiler->end(m_record); }
+
+		private:
+
+			Profiler * const		m_profiler;
+			const size_t			m_record;
+		};
+
+	public:
+
+		//!	@brief		Enable or disable recording, pending records are kept.
+		virtual void setEnabled(bool enabled) = 0;
+
+		//!	@brief		Whether recording is enabled.
+		virtual bool isEnabled() const = 0;
+
+		//!	@brief		Set the label of an object in the statistics and the trace (its address by default).
+		virtual void setLabel(const void * object, const char * label) = 0;
+
+		//!	@brief		Return the statistics of all operations, waiting for the pending records to complete.
+		virtual std::vector<Stats> stats() = 0;
+
+		//!	@brief		Discard statistics and trace events.
+		virtual void reset() = 0;
+
+		/**
+		 *	@brief		Write the recorded events as a Chrome trace JSON file, one track per stream.
+		 *	@return		False if the file could not be written.
+		 */
+		virtual bool writeChromeTrace(const char * path) = 0;
+
+	protected:
+
+		static constexpr size_t invalidRecord = ~size_t(0);
+
+		//!	@brief		Record the start event of an operation, return its record index.
+		virtual size_t begin(ns::Stream & stream, const char * operation, const void * object) = 0;
+
+		//!	@brief		Record the end event of an operation.
+		virtual void end(size_t record) = 0;
+	};
+}
\ No newline at end of file
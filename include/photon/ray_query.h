@@ -0,0 +1,143 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include <nucleus/vector_types.h>
+#include <nucleus/device_pointer.h>
+#include <optix_types.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	****************************    RayQueryEngine    ****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Abstract interface for batched closest-hit ray queries against triangle geometry.
+	 *	@details	Ships its own raygen, closest-hit and miss programs, so a query only needs rays and a
+	 *				traversable (GAS or IAS, any depth). Rays and hits are given as structures of arrays,
+	 *				each attribute in its own buffer, and optional attributes may be left as nullptr.
+	 *	@note		Only triangle primitives are supported. Every SBT entry of the traversable (geometries
+	 *				and instance `sbtOffset`s) maps to the built-in closest-hit program, see `numSbtEntries`.
+	 *	@note		All methods are thread-safe. Calls on one engine are serialized, and `queryHost()` holds
+	 *				the engine until it returns, use one engine per thread for concurrent host queries.
+	 */
+	class RayQueryEngine
+	{
+
+	public:
+
+		//!	@brief		Virtual destructor.
+		virtual ~RayQueryEngine() {}
+
+	public:
+
+		//!	Primitive index and instance ID of rays that missed.
+		static constexpr unsigned int invalidIndex = ~0u;
+
+		//!	Hit distance of rays that missed.
+		static constexpr float missDistance = -1.0f;
+
+		//!	Rays on device memory.
+		struct Rays
+		{
+			dev::Ptr<const ns::float3>			origins = nullptr;				//!	Ray origins.
+			dev::Ptr<const ns::float3>			directions = nullptr;			//!	Ray directions, not necessarily normalized.
+			dev::Ptr<const float>				tmins = nullptr;				//!	[optional] Per-ray minimum distance.
+			dev::Ptr<const float>				tmaxs = nullptr;				//!	[optional] Per-ray maximum distance.
+			size_t								count = 0;						//!	Number of rays, not limited by the OptiX launch size.
+			float								tmin = 0.0f;					//!	Minimum distance, used if `tmins` is nullptr.
+			float								tmax = 1e16f;					//!	Maximum distance, used if `tmaxs` is nullptr.
+		};
+
+		//!	Hits on device memory, `Rays::count` elements each. Attributes left as nullptr are not written.
+		struct Hits
+		{
+			dev::Ptr<float>						t = nullptr;					//!	Hit distance, `missDistance` for misses.
+			dev::Ptr<unsigned int>				primIndices = nullptr;			//!	Primitive index within its build input.
+			dev::Ptr<unsigned int>				instanceIds = nullptr;			//!	`OptixInstance::instanceId`, `invalidIndex` if no instance was traversed.
+			dev::Ptr<ns::float2>				barycentrics = nullptr;			//!	Triangle barycentrics of vertices 1 and 2.
+		};
+
+		//!	Rays on host memory, see `Rays`.
+		struct HostRays
+		{
+			const ns::float3 *					origins = nullptr;
+			const ns::float3 *					directions = nullptr;
+			const float *						tmins = nullptr;
+			const float *						tmaxs = nullptr;
+			size_t								count = 0;
+			float								tmin = 0.0f;
+			float								tmax = 1e16f;
+		};
+
+		//!	Hits on host memory, see `Hits`.
+		struct HostHits
+		{
+			float *								t = nullptr;
+			unsigned int *						primIndices = nullptr;
+			unsigned int *						instanceIds = nullptr;
+			ns::float2 *						barycentrics = nullptr;
+		};
+
+		//!	@brief		Return the number of rays per batch of `queryHost()`.
+		virtual size_t batchSize() const = 0;
+
+		//!	@brief		Retrieve the device context associated with.
+		virtual std::shared_ptr<class DeviceContext> deviceContext() const = 0;
+
+	public:
+
+		/**
+		 *	@brief		Set the number of rays per batch of `queryHost()` (default 256K).
+		 *	@details	Staging memory is allocated for two batches on both the host and the device,
+		 *				about 52 bytes per ray each. Larger batches hide the per-batch latency better.
+		 *	@throw		OPTIX_ERROR_INVALID_VALUE if `batchSize` is zero or exceeds `maxLaunchSize`.
+		 */
+		virtual void setBatchSize(size_t batchSize) = 0;
+
+
+		/**
+		 *	@brief		Trace rays on device memory and write the closest hits.
+		 *	@param[in]	stream - CUDA stream to enqueue the work on, nothing is synchronized.
+		 *	@param[in]	traversable - Handle of the acceleration structure, must stay valid until the work is done.
+		 *	@param[in]	rays - Rays to trace.
+		 *	@param[in]	hits - Output buffers.
+		 *	@param[in]	numSbtEntries - Number of SBT entries referenced by the traversable, i.e. the largest
+		 *				instance `sbtOffset` plus the number of SBT records of its GAS (1 for a plain GAS).
+		 */
+		virtual void query(ns::Stream & stream, OptixTraversableHandle traversable, const Rays & rays, const Hits & hits, unsigned int numSbtEntries = 1) = 0;
+
+
+		/**
+		 *	@brief		Trace rays on host memory and write the closest hits back to host memory.
+		 *	@details	Rays are streamed in batches of `batchSize()` through pinned staging buffers: while a
+		 *				batch is traced, the next one is staged and uploaded, and the previous one downloaded.
+		 *				Host memory may be pageable, it is only accessed by this thread.
+		 *	@param[in]	stream - Work already enqueued on it (e.g. the build) completes before the first batch.
+		 *	@note		Blocks until all hits are written.
+		 *	@see		`query()`.
+		 */
+		virtual void queryHost(ns::Stream & stream, OptixTraversableHandle traversable, const HostRays & rays, const HostHits & hits, unsigned int numSbtEntries = 1) = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "macros.h"
+#include <type_traits>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*****************************    RayTypeTable    *****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Compile-time table of ray types, shared by the device trace calls and the host SBT layout.
+	 *	@details	Each ray type is a tag struct, its position in `Tags` defines the SBT offset and the
+	 *				miss program index, and the number of ray types defines the SBT stride. The usual SBT
+	 *				layout is assumed: hit group records are grouped per geometry (one per ray type), and
+	 *				miss records are ordered as the ray types. A tag may optionally define
+	 *				`static constexpr unsigned int rayFlags` and `visibilityMask`.
+	 *	@example	struct RadianceRay {};
+	 *				struct ShadowRay { static constexpr unsigned int rayFlags = OPTIX_RAY_FLAG_TERMINATE_ON_FIRST_HIT; };
+	 *				using RayTypes = RayTypeTable<RadianceRay, ShadowRay>;
+	 *				//	device:
+	 *				trace<RayTypes::Ray<ShadowRay>>(handle, origin, direction, tmin, tmax, occluded);
+	 *				//	host:
+	 *				sbt.missRecordCount = RayTypes::missRecordCount;
+	 *				sbt.hitgroupRecordCount = RayTypes::hitgroupRecordCount(numGeometries);
+	 *				records[RayTypes::hitgroupRecordIndex<ShadowRay>(geometryIndex)] = shadowRecord;
+	 */
+	template<typename... Tags> struct RayTypeTable
+	{
+		static_assert(sizeof...(Tags) > 0, "A ray type table requires at least one ray type");
+
+		//!	Number of ray types, also the SBT stride.
+		static constexpr unsigned int numRayTypes = sizeof...(Tags);
+
+		//!	Number of miss records, one per ray type.
+		static constexpr unsigned int missRecordCount = numRayTypes;
+
+		//!	Position of `Tag` in the table.
+		template<typename Tag> static constexpr unsigned int indexOf()
+		{
+			static_assert((std::is_same_v<Tag, Tags> || ...), "Tag is not part of the ray type table");
+
+			unsigned int index = 0, result = 0;
+
+			((std::is_same_v<Tag, Tags> ? (result = index, index++) : index++), ...);
+
+			return result;
+		}
+
+		//!	Number of hit group records for `numGeometries` SBT entries (geometries or instance offsets).
+		static constexpr unsigned int hitgroupRecordCount(unsigned int numGeometries) { return numGeometries * numRayTypes; }
+
+		//!	Index of the hit group record of `Tag` for the SBT entry `sbtIndex`.
+		template<typename Tag> static constexpr unsigned int hitgroupRecordIndex(unsigned int sbtIndex) { return sbtIndex * numRayTypes + indexOf<Tag>(); }
+
+		//!	Index of the miss record of `Tag`.
+		template<typename Tag> static constexpr unsigned int missRecordIndex() { return indexOf<Tag>(); }
+
+		/**
+		 *	@brief		Trace arguments of one ray type, to be passed to `trace<Ray<Tag>>()`.
+		 */
+		template<typename Tag> struct Ray
+		{
+			using tag_type = Tag;
+
+			static constexpr unsigned int sbtOffset = indexOf<Tag>();
+
+			static constexpr unsigned int sbtStride = numRayTypes;
+
+			static constexpr unsigned int missIndex = indexOf<Tag>();
+
+			static constexpr unsigned int rayFlags = []() { if constexpr (requires { Tag::rayFlags; }) return static_cast<unsigned int>(Tag::rayFlags); else return 0u; }();
+
+			static constexpr unsigned int visibilityMask = []() { if constexpr (requires { Tag::visibilityMask; }) return static_cast<unsigned int>(Tag::visibilityMask); else return 0xFFu; }();
+		};
+	};
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "trace.cuh"
+#include <optix.h>
+
+#ifndef __CUDACC__
+	#error This file should be inclued in *.cu files only!
+#endif
+
+/*********************************************************************************
+***************************    Shader Execution Reordering    *******************
+*********************************************************************************/
+
+/**
+ *	Shader Execution Reordering (SER, OptiX 8.0+) splits `optixTrace()` into three steps:
+ *		1. `traverse()`	- find the hit (runs IS/AH), the result is kept in a hit object.
+ *		2. `reorder()`	- regroup the threads of the launch by hit shader and coherence hint.
+ *		3. `invoke()`	- run the CH/MS program of the hit object.
+ *	Divergent CH programs (e.g. material shading) run with coherent warps after step 2.
+ *
+ *	Devices without SER support accept the calls, `optixReorder()` is a no-op there. Whether it
+ *	is effective is reported by `DeviceContext::supportsShaderExecutionReordering()`, which should
+ *	be forwarded to the launch parameters and passed to `trace_reordered()`. With OptiX < 8.0 all
+ *	wrappers fall back to a plain `trace()`.
+ */
+namespace PHOTON_NAMESPACE
+{
+#if OPTIX_VERSION >= 80000
+	namespace details
+	{
+		template<typename RayType, unsigned int... Slots> __device__ __forceinline__ void traverseSlots(OptixTraversableHandle handle, float3 origin, float3 direction, float tmin, float tmax, float rayTime,
+																										unsigned int * slots, std::integer_sequence<unsigned int, Slots...>)
+		{
+			optixTraverse(handle, origin, direction, tmin, tmax, rayTime,
+						  OptixVisibilityMask(RayType::visibilityMask),
+						  RayType::rayFlags,
+						  RayType::sbtOffset,
+						  RayType::sbtStride,
+						  RayType::missIndex,
+						  slots[Slots]...);
+		}
+
+
+		template<unsigned int... Slots> __device__ __forceinline__ void invokeSlots(unsigned int * slots, std::integer_sequence<unsigned int, Slots...>)
+		{
+			optixInvoke(slots[Slots]...);
+		}
+	}
+#endif
+
+	/*****************************************************************************
+	*******************************    traverse    *******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Traverses a ray of a compile-time ray type and records the hit in a hit object.
+	 *	@details	Same arguments as `trace()`. The payloads are visible to IS/AH programs and updated in place.
+	 *	@note		Falls back to `trace()` with OptiX < 8.0, the following `invoke()` is then a no-op.
+	 */
+	template<typename RayType, TracePayload... Payloads> __device__ __forceinline__ void traverse(OptixTraversableHandle handle, float3 origin, float3 direction, float tmin, float tmax, float rayTime, Payloads &... payloads)
+	{
+	#if OPTIX_VERSION >= 80000
+		constexpr unsigned int numSlots = details::maxValue<details::PayloadExtent<Payloads>::value...>();
+
+		unsigned int slots[numSlots > 0 ? numSlots : 1] = {};
+
+		(details::gatherSlots(slots, payloads), ...);
+
+		details::traverseSlots<RayType>(handle, origin, direction, tmin, tmax, rayTime, slots, std::make_integer_sequence<unsigned int, numSlots>());
+
+		(details::scatterSlots(slots, payloads), ...);
+	#else
+		trace<RayType>(handle, origin, direction, tmin, tmax, rayTime, payloads...);
+	#endif
+	}
+
+
+	//!	@brief		Traverses a ray of a compile-time ray type at time zero.
+	template<typename RayType, TracePayload... Payloads> __device__ __forceinline__ void traverse(OptixTraversableHandle handle, float3 origin, float3 direction, float tmin, float tmax, Payloads &... payloads)
+	{
+		traverse<RayType>(handle, origin, direction, tmin, tmax, 0.0f, payloads...);
+	}
+
+	/*****************************************************************************
+	*******************************    reorder    ********************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Reorders the threads by the shader of their hit object.
+	 *	@see		`optixReorder()`.
+	 *	@note		Available in RG, no-op with OptiX < 8.0.
+	 */
+	__device__ __forceinline__ void reorder()
+	{
+	#if OPTIX_VERSION >= 80000
+		optixReorder();
+	#endif
+	}
+
+
+	/**
+	 *	@brief		Reorders the threads by the shader of their hit object, then by a user coherence hint.
+	 *	@param[in]	coherenceHint - E.g. material id, texture id or ray direction octant.
+	 *	@param[in]	numHintBits - Number of significant bits of `coherenceHint`, fewer bits sort faster.
+	 *	@note		Available in RG, no-op with OptiX < 8.0.
+	 */
+	__device__ __forceinline__ void reorder(unsigned int coherenceHint, unsigned int numHintBits)
+	{
+	#if OPTIX_VERSION >= 80000
+		optixReorder(coherenceHint, numHintBits);
+	#endif
+	}
+
+	/*****************************************************************************
+	********************************    invoke    ********************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Invokes the CH or MS program of the current hit object with typed payloads.
+	 *	@note		Available in RG, no-op with OptiX < 8.0 (the programs already ran in `traverse()`).
+	 */
+	template<TracePayload... Payloads> __device__ __forceinline__ void invoke([[maybe_unused]] Payloads &... payloads)
+	{
+	#if OPTIX_VERSION >= 80000
+		constexpr unsigned int numSlots = details::maxValue<details::PayloadExtent<Payloads>::value...>();
+
+		unsigned int slots[numSlots > 0 ? numSlots : 1] = {};
+
+		(details::gatherSlots(slots, payloads), ...);
+
+		details::invokeSlots(slots, std::make_integer_sequence<unsigned int, numSlots>());
+
+		(details::scatterSlots(slots, payloads), ...);
+	#endif
+	}
+
+	/*****************************************************************************
+	***************************    trace_reordered    ****************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		`traverse()` + `reorder(coherenceHint, numHintBits)` + `invoke()`, or a plain `trace()`.
+	 *	@param[in]	enableReorder - Usually `DeviceContext::supportsShaderExecutionReordering()` forwarded through
+	 *				the launch parameters: where reordering is a no-op, a plain `trace()` avoids the hit object.
+	 *	@example	trace_reordered<RayTypes::Ray<RadianceRay>>(params.reorder, materialId, 4, params.handle, origin, direction, 0.0f, 1e16f, radiance);
+	 */
+	template<typename RayType, TracePayload... Payloads> __device__ __forceinline__ void trace_reordered(bool enableReorder, unsigned int coherenceHint, unsigned int numHintBits,
+																										 OptixTraversableHandle handle, float3 origin, float3 direction, float tmin, float tmax, Payloads &... payloads)
+	{
+	#if OPTIX_VERSION >= 80000
+		if (enableReorder)
+		{
+			traverse<RayType>(handle, origin, direction, tmin, tmax, payloads...);
+
+			reorder(coherenceHint, numHintBits);
+
+			invoke(payloads...);
+
+			return;
+		}
+	#endif
+
+		trace<RayType>(handle, origin, direction, tmin, tmax, payloads...);
+	}
+}
\ No newline at end of file
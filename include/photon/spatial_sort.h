@@ -0,0 +1,133 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include <nucleus/vector_types.h>
+#include <nucleus/device_pointer.h>
+#include <type_traits>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*****************************    SpatialSort    ******************************
+	*****************************************************************************/
+
+	/**
+	 *	@brief		Abstract interface for sorting points along a space-filling curve on the device.
+	 *	@details	Points are quantized to 21 bits per axis inside their bounding box, mapped to 63-bit
+	 *				Morton or Hilbert keys and radix-sorted. The resulting permutation maps a sorted index
+	 *				to the original one, and is used to reorder primitives before a GAS build and query
+	 *				points (i.e. launch indices) before a launch, so that neighboring rays and primitives
+	 *				are close in memory and in the BVH.
+	 *	@example	spatialSort->sort(stream, allocator, points, count);
+	 *				spatialSort->gather(stream, sortedPoints, points);					//	sortedPoints[k] = points[permutation[k]]
+	 *				...
+	 *				spatialSort->scatter(stream, results, sortedResults);				//	results[permutation[k]] = sortedResults[k]
+	 */
+	class SpatialSort
+	{
+
+	public:
+
+		//!	@brief		Virtual destructor.
+		virtual ~SpatialSort() {}
+
+	public:
+
+		//!	Space-filling curve used for the keys.
+		enum Curve
+		{
+			Morton,				//!	Z-order, cheapest to compute.
+			Hilbert,			//!	No jumps between consecutive cells, slightly better locality.
+		};
+
+		//!	@brief		Return number of points of the last `sort()`.
+		virtual unsigned int size() const = 0;
+
+		//!	@brief		Return the permutation of the last `sort()`, `permutation[sorted] = original`.
+		virtual dev::Ptr<const unsigned int> permutation() const = 0;
+
+		//!	@brief		Retrieve the device context associated with.
+		virtual std::shared_ptr<class DeviceContext> deviceContext() const = 0;
+
+	public:
+
+		/**
+		 *	@brief		Compute keys of the points and sort them.
+		 *	@param[in]	stream - CUDA stream to enqueue the work on.
+		 *	@param[in]	allocator - Allocator for keys, permutation and scratch memory (reused across calls).
+		 *	@param[in]	points - Point positions (primitive centers for a GAS).
+		 *	@param[in]	count - Number of points.
+		 *	@param[in]	curve - Space-filling curve.
+		 */
+		virtual void sort(ns::Stream & stream, ns::AllocPtr allocator, dev::Ptr<const ns::float3_16a> points, unsigned int count, Curve curve = Hilbert) = 0;
+
+
+		/**
+		 *	@brief		Copy the 64-bit keys of the last `sort()` in sorted order (for debugging and custom passes).
+		 */
+		virtual dev::Ptr<const uint64_t> sortedKeys() const = 0;
+
+
+		/**
+		 *	@brief		Write the permutation into the header buffer of a GAS built from sorted primitives.
+		 *	@details	The GAS must have been built with a `headerSize` of at least `remapHeaderSize(size())`.
+		 *				Programs read the original primitive index back with:
+		 *				`reinterpret_cast<const unsigned int*>(optixGetGASPointerFromHandle(gas) - headerSize)[optixGetPrimitiveIndex()]`.
+		 */
+		virtual void writeRemap(ns::Stream & stream, GeomAccelStruct & accelStruct) const = 0;
+
+
+		//!	@brief		Header size needed by `writeRemap()` for `count` primitives.
+		static constexpr size_t remapHeaderSize(unsigned int count) { return sizeof(unsigned int) * count; }
+
+
+		/**
+		 *	@brief		Reorder an array into sorted order: `dst[k] = src[permutation[k]]`.
+		 *	@note		`dst` and `src` must not overlap, `sizeof(Type)` must be a multiple of 4 bytes.
+		 */
+		template<typename Type> void gather(ns::Stream & stream, dev::Ptr<Type> dst, dev::Ptr<const std::type_identity_t<Type>> src) const
+		{
+			static_assert(sizeof(Type) % sizeof(uint32_t) == 0, "Element size must be a multiple of 4 bytes");
+
+			this->permute(stream, dst.data(), src.data(), sizeof(Type) / sizeof(uint32_t), false);
+		}
+
+
+		/**
+		 *	@brief		Restore an array in sorted order back to original order: `dst[permutation[k]] = src[k]`.
+		 *	@note		`dst` and `src` must not overlap, `sizeof(Type)` must be a multiple of 4 bytes.
+		 */
+		template<typename Type> void scatter(ns::Stream & stream, dev::Ptr<Type> dst, dev::Ptr<const std::type_identity_t<Type>> src) const
+		{
+			static_assert(sizeof(Type) % sizeof(uint32_t) == 0, "Element size must be a multiple of 4 bytes");
+
+			this->permute(stream, dst.data(), src.data(), sizeof(Type) / sizeof(uint32_t), true);
+		}
+
+	protected:
+
+		//!	@brief		Untyped implementation of `gather()` and `scatter()`.
+		virtual void permute(ns::Stream & stream, void * dst, const void * src, unsigned int numWords, bool scatter) const = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "payload.cuh"
+#include "ray_types.h"
+#include <optix_device.h>
+
+#ifndef __CUDACC__
+	#error This file should be inclued in *.cu files only!
+#endif
+
+namespace PHOTON_NAMESPACE
+{
+	namespace details
+	{
+		//!	Number of payload registers covered by a `Payload` / `LargePayload` (highest slot + 1).
+		template<typename Type> struct PayloadExtent;
+
+		template<typename Type, unsigned int... Indices> struct PayloadExtent<Payload<Type, Indices...>>
+		{
+			static constexpr unsigned int value = maxValue<(Indices + 1)...>();
+		};
+
+		template<typename Hot, typename Cold, unsigned int First> struct PayloadExtent<LargePayload<Hot, Cold, First>>
+		{
+			static constexpr unsigned int value = First + LargePayload<Hot, Cold, First>::numSlots;
+		};
+
+
+		template<typename Type, unsigned int... Indices> __device__ __forceinline__ void gatherSlots(unsigned int * slots, const Payload<Type, Indices...> & payload)
+		{
+			int index = 0;			((slots[Indices] = payload.encodes[index++]), ...);
+		}
+
+
+		template<typename Type, unsigned int... Indices> __device__ __forceinline__ void scatterSlots(const unsigned int * slots, Payload<Type, Indices...> & payload)
+		{
+			int index = 0;			((payload.encodes[index++] = slots[Indices]), ...);
+		}
+
+
+		template<typename Hot, typename Cold, unsigned int First> __device__ __forceinline__ void gatherSlots(unsigned int * slots, const LargePayload<Hot, Cold, First> & payload)
+		{
+			#pragma unroll
+			for (int i = 0; i < LargePayload<Hot, Cold, First>::numSlots; i++)		slots[First + i] = payload.encodes[i];
+		}
+
+
+		template<typename Hot, typename Cold, unsigned int First> __device__ __forceinline__ void scatterSlots(const unsigned int * slots, LargePayload<Hot, Cold, First> & payload)
+		{
+			#pragma unroll
+			for (int i = 0; i < LargePayload<Hot, Cold, First>::numSlots; i++)		payload.encodes[i] = slots[First + i];
+		}
+
+
+		template<typename RayType, unsigned int... Slots> __device__ __forceinline__ void traceSlots(OptixTraversableHandle handle, float3 origin, float3 direction, float tmin, float tmax, float rayTime,
+																									 unsigned int * slots, std::integer_sequence<unsigned int, Slots...>)
+		{
+			optixTrace(handle, origin, direction, tmin, tmax, rayTime,
+					   OptixVisibilityMask(RayType::visibilityMask),
+					   RayType::rayFlags,
+					   RayType::sbtOffset,
+					   RayType::sbtStride,
+					   RayType::missIndex,
+					   slots[Slots]...);
+		}
+	}
+
+	/*****************************************************************************
+	********************************    trace    *********************************
+	*****************************************************************************/
+
+	template<typename Type> concept TracePayload = IsPayload<Type>::value || IsLargePayload<Type>::value;
+
+
+	/**
+	 *	@brief		Traces a ray of a compile-time ray type with typed payloads.
+	 *	@details	SBT offset, stride, miss index, ray flags and visibility mask come from `RayType`
+	 *				(`RayTypeTable<...>::Ray<Tag>`), so they always match the host SBT layout. The payloads
+	 *				are laid out by their slot indices and passed as registers `p0...pN`, where `N` is the
+	 *				highest slot in use. The intermediate slot array is indexed with constants only and is
+	 *				promoted to registers, slots not covered by any payload are passed as zero. The payloads
+	 *				are updated in place after the trace returns.
+	 *	@example	using Radiance = Payload<float3, 0, 1, 2>;
+	 *				Radiance radiance = float3{};
+	 *				trace<RayTypes::Ray<RadianceRay>>(params.handle, origin, direction, 0.0f, 1e16f, radiance);
+	 *	@note		Available in RG, CH, MS.
+	 */
+	template<typename RayType, TracePayload... Payloads> __device__ __forceinline__ void trace(OptixTraversableHandle handle, float3 origin, float3 direction, float tmin, float tmax, float rayTime, Payloads &... payloads)
+	{
+		constexpr unsigned int numSlots = details::maxValue<details::PayloadExtent<Payloads>::value...>();
+
+		static_assert(numSlots <= 32, "OptiX supports up to 32 payload values");
+
+		unsigned int slots[numSlots > 0 ? numSlots : 1] = {};
+
+		(details::gatherSlots(slots, payloads), ...);
+
+		details::traceSlots<RayType>(handle, origin, direction, tmin, tmax, rayTime, slots, std::make_integer_sequence<unsigned int, numSlots>());
+
+		(details::scatterSlots(slots, payloads), ...);
+	}
+
+
+	/**
+	 *	@brief		Traces a ray of a compile-time ray type with typed payloads at time zero.
+	 */
+	template<typename RayType, TracePayload... Payloads> __device__ __forceinline__ void trace(OptixTraversableHandle handle, float3 origin, float3 direction, float tmin, float tmax, Payloads &... payloads)
+	{
+		trace<RayType>(handle, origin, direction, tmin, tmax, 0.0f, payloads...);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "aabb_utils.h"
+#include "accel_struct.h"
+#include <nucleus/logger.h>
+#include <nucleus/stream.h>
+#include <nucleus/launch_utils.cuh>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+namespace kernels
+{
+	__device__ __forceinline__ Aabb MakeAabb(ns::float3_16a p, float r)
+	{
+		Aabb aabb;
+		aabb.lower = ns::float3{ p.x - r, p.y - r, p.z - r };
+		aabb.upper = ns::float3{ p.x + r, p.y + r, p.z + r };
+		return aabb;
+	}
+
+
+	__device__ __forceinline__ Aabb Merge(Aabb a, Aabb b)
+	{
+		Aabb aabb;
+		aabb.lower = ns::float3{ fminf(a.lower.x, b.lower.x), fminf(a.lower.y, b.lower.y), fminf(a.lower.z, b.lower.z) };
+		aabb.upper = ns::float3{ fmaxf(a.upper.x, b.upper.x), fmaxf(a.upper.y, b.upper.y), fmaxf(a.upper.z, b.upper.z) };
+		return aabb;
+	}
+
+
+	__global__ void ComputePointAabbs(dev::Ptr<Aabb> aabbs, dev::Ptr<const ns::float3_16a> points, float radius, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		aabbs[i] = MakeAabb(points[i], radius);
+	}
+
+
+	__global__ void ComputeSphereAabbs(dev::Ptr<Aabb> aabbs, dev::Ptr<const ns::float3_16a> centers, dev::Ptr<const float> radii, float padding, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		aabbs[i] = MakeAabb(centers[i], radii[i] + padding);
+	}
+
+
+	__global__ void ComputeTriangleAabbs(dev::Ptr<Aabb> aabbs, dev::Ptr<const ns::float3_16a> vertices, dev::Ptr<const ns::int3_16a> triangles, float padding, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		ns::int3_16a tri = (triangles != nullptr) ? triangles[i] : ns::int3_16a{ int(3 * i), int(3 * i + 1), int(3 * i + 2) };
+
+		Aabb aabb = MakeAabb(vertices[tri.x], padding);
+		aabb = Merge(aabb, MakeAabb(vertices[tri.y], padding));
+		aabb = Merge(aabb, MakeAabb(vertices[tri.z], padding));
+
+		aabbs[i] = aabb;
+	}
+
+
+	__global__ void ComputeSegmentAabbs(dev::Ptr<Aabb> aabbs, dev::Ptr<const ns::float3_16a> vertices, dev::Ptr<const uint32_t> segments, dev::Ptr<const float> radii, float padding, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		uint32_t v0 = segments[i];
+		uint32_t v1 = v0 + 1;
+		float r0 = (radii != nullptr) ? radii[v0] + padding : padding;
+		float r1 = (radii != nullptr) ? radii[v1] + padding : padding;
+
+		aabbs[i] = Merge(MakeAabb(vertices[v0], r0), MakeAabb(vertices[v1], r1));
+	}
+}
+
+/*********************************************************************************
+*******************************    computeAabbs    *******************************
+*********************************************************************************/
+
+void PHOTON_NAMESPACE::computeAabbs(ns::Stream & stream, dev::Ptr<Aabb> aabbs, const AabbSource & source)
+{
+	const unsigned int count = source.numPrimitives;
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	switch (source.type)
+	{
+		case AabbSource::Points:
+		{
+			stream.launch(kernels::ComputePointAabbs, ns::ceil_div(count, 256), 256)(aabbs, source.vertexBuffer, source.radius, count);
+			break;
+		}
+		case AabbSource::Spheres:
+		{
+			NS_ASSERT(source.radiusBuffer != nullptr);
+
+			stream.launch(kernels::ComputeSphereAabbs, ns::ceil_div(count, 256), 256)(aabbs, source.vertexBuffer, source.radiusBuffer, source.radius, count);
+			break;
+		}
+		case AabbSource::Triangles:
+		{
+			stream.launch(kernels::ComputeTriangleAabbs, ns::ceil_div(count, 256), 256)(aabbs, source.vertexBuffer, source.indexBuffer, source.radius, count);
+			break;
+		}
+		case AabbSource::Segments:
+		{
+			NS_ASSERT(source.segmentBuffer != nullptr);
+
+			stream.launch(kernels::ComputeSegmentAabbs, ns::ceil_div(count, 256), 256)(aabbs, source.vertexBuffer, source.segmentBuffer, source.radiusBuffer, source.radius, count);
+			break;
+		}
+		default:
+		{
+			NS_ERROR_LOG("Invalid AABB source type!");
+			break;
+		}
+	}
+}
+
+
+void PHOTON_NAMESPACE::refitAabbs(ns::Stream & stream, AccelStructAabb & accelStruct, dev::Ptr<Aabb> aabbs, const AabbSource & source)
+{
+	computeAabbs(stream, aabbs, source);
+
+	if (accelStruct.allowUpdate())
+	{
+		accelStruct.refit(stream);
+	}
+	else
+	{
+		accelStruct.rebuild(stream);
+	}
+}
\ No newline at end of file
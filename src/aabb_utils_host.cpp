@@ -0,0 +1,145 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "aabb_utils.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+
+PHOTON_USING_NAMESPACE
+
+static_assert(sizeof(Aabb) == 6 * sizeof(float), "Aabb is expected to be tightly packed");
+static_assert(sizeof(ns::float3_16a) == 4 * sizeof(float), "float3_16a is expected to be padded to 16 bytes");
+
+/*********************************************************************************
+*********************************    helpers    **********************************
+*********************************************************************************/
+
+//!	Split [0, count) into contiguous ranges and run `func(begin, end)` on each of them.
+template<typename Func> static void parallelFor(size_t count, unsigned int numThreads, Func && func)
+{
+	constexpr size_t minCountPerThread = 16384;
+
+	if (numThreads == 0)
+	{
+		numThreads = NS_MAX(std::thread::hardware_concurrency(), 1u);
+	}
+
+	numThreads = static_cast<unsigned int>(NS_MIN(size_t(numThreads), (count + minCountPerThread - 1) / minCountPerThread));
+
+	if (numThreads <= 1)
+	{
+		func(size_t(0), count);
+
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(numThreads - 1);
+
+	const size_t countPerThread = (count + numThreads - 1) / numThreads;
+
+	for (unsigned int t = 1; t < numThreads; t++)
+	{
+		size_t begin = NS_MIN(count, t * countPerThread);
+		size_t end = NS_MIN(count, begin + countPerThread);
+
+		workers.emplace_back([=, &func]() { func(begin, end); });
+	}
+
+	func(size_t(0), NS_MIN(count, countPerThread));
+
+	for (auto & worker : workers)
+	{
+		worker.join();
+	}
+}
+
+
+static void fillPointAabbs(Aabb * aabbs, const ns::float3_16a * points, const float * radii, float radius, size_t begin, size_t end)
+{
+	size_t i = begin;
+
+#if defined(__AVX2__)
+	//!	Each point is loaded as [x y z w], duplicated into [x y z x y z . .] and offset by [-r -r -r +r +r +r 0 0].
+	//!	Stores are 8 lanes wide and overlap the next AABB, which is overwritten right after (the last one is handled in scalar code).
+	float * output = reinterpret_cast<float*>(aabbs);
+	const __m256i permutation = _mm256_setr_epi32(0, 1, 2, 0, 1, 2, 3, 3);
+	const __m256 signs = _mm256_setr_ps(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+
+	for (; i + 1 < end; i++)
+	{
+		const float r = (radii != nullptr) ? radii[i] + radius : radius;
+		const __m256 p = _mm256_castps128_ps256(_mm_load_ps(reinterpret_cast<const float*>(&points[i])));
+		const __m256 v = _mm256_add_ps(_mm256_permutevar8x32_ps(p, permutation), _mm256_mul_ps(signs, _mm256_set1_ps(r)));
+
+		_mm256_storeu_ps(output + 6 * i, v);
+	}
+#endif
+
+	for (; i < end; i++)
+	{
+		const float r = (radii != nullptr) ? radii[i] + radius : radius;
+		const ns::float3_16a p = points[i];
+
+		aabbs[i].lower = ns::float3{ p.x - r, p.y - r, p.z - r };
+		aabbs[i].upper = ns::float3{ p.x + r, p.y + r, p.z + r };
+	}
+}
+
+/*********************************************************************************
+****************************    computePointAabbs    *****************************
+*********************************************************************************/
+
+void PHOTON_NAMESPACE::computePointAabbs(Aabb * aabbs, const ns::float3_16a * points, const float * radii, float radius, size_t count, unsigned int numThreads)
+{
+	parallelFor(count, numThreads, [=](size_t begin, size_t end) { fillPointAabbs(aabbs, points, radii, radius, begin, end); });
+}
+
+
+void PHOTON_NAMESPACE::computeTriangleAabbs(Aabb * aabbs, const ns::float3_16a * vertices, const ns::int3_16a * triangles, float padding, size_t count, unsigned int numThreads)
+{
+	parallelFor(count, numThreads, [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			int v0 = (triangles != nullptr) ? triangles[i].x : int(3 * i + 0);
+			int v1 = (triangles != nullptr) ? triangles[i].y : int(3 * i + 1);
+			int v2 = (triangles != nullptr) ? triangles[i].z : int(3 * i + 2);
+
+			const ns::float3_16a & p0 = vertices[v0];
+			const ns::float3_16a & p1 = vertices[v1];
+			const ns::float3_16a & p2 = vertices[v2];
+
+			aabbs[i].lower.x = std::min({ p0.x, p1.x, p2.x }) - padding;
+			aabbs[i].lower.y = std::min({ p0.y, p1.y, p2.y }) - padding;
+			aabbs[i].lower.z = std::min({ p0.z, p1.z, p2.z }) - padding;
+			aabbs[i].upper.x = std::max({ p0.x, p1.x, p2.x }) + padding;
+			aabbs[i].upper.y = std::max({ p0.y, p1.y, p2.y }) + padding;
+			aabbs[i].upper.z = std::max({ p0.z, p1.z, p2.z }) + padding;
+		}
+	});
+}
\ No newline at end of file
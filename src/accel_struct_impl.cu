@@ -21,6 +21,7 @@
  */
 
 #include "accel_struct_impl.h"
+#include "profiler.h"
 #include <nucleus/launch_utils.cuh>
 #include <optix_stubs.h>
 
@@ -70,33 +71,179 @@ AccelStructBase::AccelStructBase(std::shared_ptr<DeviceContext> deviceContext) :
 }
 
 
-void AccelStructBase::build(ns::Stream & stream, ns::AllocPtr allocator, const std::vector<OptixBuildInput> & buildInputs, OptixAccelBuildOptions buildOptions, size_t headerSize)
+//!	Append everything of a build input that affects its memory usage: counts, formats, strides, flags and
+//!	whether optional buffers are present, but not the device addresses.
+static void appendSignature(std::vector<uint64_t> & signature, const OptixBuildInput & buildInput)
+{
+	signature.push_back(buildInput.type);
+
+	switch (buildInput.type)
+	{
+		case OPTIX_BUILD_INPUT_TYPE_TRIANGLES:
+		{
+			const OptixBuildInputTriangleArray & triangleArray = buildInput.triangleArray;
+
+			signature.push_back(triangleArray.vertexFormat);
+			signature.push_back(triangleArray.vertexStrideInBytes);
+			signature.push_back(triangleArray.numVertices);
+			signature.push_back(triangleArray.indexFormat);
+			signature.push_back(triangleArray.indexStrideInBytes);
+			signature.push_back(triangleArray.numIndexTriplets);
+			signature.push_back(triangleArray.preTransform != 0);
+			signature.push_back(triangleArray.sbtIndexOffsetBuffer != 0);
+			signature.push_back(triangleArray.sbtIndexOffsetSizeInBytes);
+			signature.push_back(triangleArray.numSbtRecords);
+			signature.insert(signature.end(), triangleArray.flags, triangleArray.flags + triangleArray.numSbtRecords);
+		#if OPTIX_VERSION >= 70100
+			signature.push_back(triangleArray.transformFormat);
+		#endif
+			break;
+		}
+		case OPTIX_BUILD_INPUT_TYPE_CUSTOM_PRIMITIVES:
+		{
+		#if OPTIX_VERSION >= 70100
+			const OptixBuildInputCustomPrimitiveArray & aabbArray = buildInput.customPrimitiveArray;
+		#else
+			const OptixBuildInputCustomPrimitiveArray & aabbArray = buildInput.aabbArray;
+		#endif
+			signature.push_back(aabbArray.numPrimitives);
+			signature.push_back(aabbArray.strideInBytes);
+			signature.push_back(aabbArray.sbtIndexOffsetBuffer != 0);
+			signature.push_back(aabbArray.sbtIndexOffsetSizeInBytes);
+			signature.push_back(aabbArray.numSbtRecords);
+			signature.insert(signature.end(), aabbArray.flags, aabbArray.flags + aabbArray.numSbtRecords);
+			break;
+		}
+	#if OPTIX_VERSION >= 70100
+		case OPTIX_BUILD_INPUT_TYPE_CURVES:
+		{
+			const OptixBuildInputCurveArray & curveArray = buildInput.curveArray;
+
+			signature.push_back(curveArray.curveType);
+			signature.push_back(curveArray.numPrimitives);
+			signature.push_back(curveArray.numVertices);
+			signature.push_back(curveArray.vertexStrideInBytes);
+			signature.push_back(curveArray.widthStrideInBytes);
+			signature.push_back(curveArray.indexStrideInBytes);
+			signature.push_back(curveArray.flag);
+		#if OPTIX_VERSION >= 70400
+			signature.push_back(curveArray.endcapFlags);
+		#endif
+			break;
+		}
+	#endif
+	#if OPTIX_VERSION >= 70500
+		case OPTIX_BUILD_INPUT_TYPE_SPHERES:
+		{
+			const OptixBuildInputSphereArray & sphereArray = buildInput.sphereArray;
+
+			signature.push_back(sphereArray.numVertices);
+			signature.push_back(sphereArray.vertexStrideInBytes);
+			signature.push_back(sphereArray.radiusStrideInBytes);
+			signature.push_back(sphereArray.singleRadius);
+			signature.push_back(sphereArray.sbtIndexOffsetBuffer != 0);
+			signature.push_back(sphereArray.sbtIndexOffsetSizeInBytes);
+			signature.push_back(sphereArray.numSbtRecords);
+			signature.insert(signature.end(), sphereArray.flags, sphereArray.flags + sphereArray.numSbtRecords);
+			break;
+		}
+	#endif
+		case OPTIX_BUILD_INPUT_TYPE_INSTANCES:
+		{
+			signature.push_back(buildInput.instanceArray.numInstances);
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+}
+
+
+OptixResult AccelStructBase::computeMemoryUsage(const OptixAccelBuildOptions & buildOptions, OptixAccelBufferSizes & accelBufferSizes)
+{
+	m_signature.clear();
+	m_signature.push_back(buildOptions.buildFlags);
+	m_signature.push_back(buildOptions.motionOptions.numKeys);
+
+	for (const OptixBuildInput & buildInput : m_optixBuildInputs)
+	{
+		appendSignature(m_signature, buildInput);
+	}
+
+	auto iter = m_memoryUsages.find(m_signature);
+
+	if (iter != m_memoryUsages.end())
+	{
+		accelBufferSizes = iter->second;
+
+		return OPTIX_SUCCESS;
+	}
+
+	OptixResult err = optixAccelComputeMemoryUsage(m_deviceContext->handle(), &buildOptions, m_optixBuildInputs.data(), (uint32_t)m_optixBuildInputs.size(), &accelBufferSizes);
+
+	if (err == OPTIX_SUCCESS)
+	{
+		//	Bounded: a mesh whose size changes every frame must not grow the cache forever.
+		if (m_memoryUsages.size() >= maxCachedSignatures)
+		{
+			m_memoryUsages.clear();
+		}
+
+		m_memoryUsages.emplace(m_signature, accelBufferSizes);
+	}
+
+	return err;
+}
+
+
+void AccelStructBase::reserve(ns::Array<unsigned char> & buffer, ns::AllocPtr allocator, size_t bytes)
+{
+	bytes = ns::align_up(bytes, OPTIX_ACCEL_BUFFER_BYTE_ALIGNMENT);
+
+	if (bytes > buffer.size())
+	{
+		buffer.resize(allocator, ns::align_up(NS_MAX(bytes, buffer.size() + buffer.size() / 2), OPTIX_ACCEL_BUFFER_BYTE_ALIGNMENT));
+	}
+	else if (bytes < buffer.size() / 4)
+	{
+		buffer.resize(allocator, bytes);
+	}
+}
+
+
+void AccelStructBase::build(ns::Stream & stream, ns::AllocPtr allocator, OptixAccelBuildOptions buildOptions, size_t headerSize)
 {
 	OptixAccelBufferSizes accelBufferSizes = {};
 
 	buildOptions.operation = OPTIX_BUILD_OPERATION_BUILD;
 
-	OptixResult err = optixAccelComputeMemoryUsage(m_deviceContext->handle(), &buildOptions, buildInputs.data(), (uint32_t)buildInputs.size(), &accelBufferSizes);
+	OptixResult err = this->computeMemoryUsage(buildOptions, accelBufferSizes);
 
 	if (err == OPTIX_SUCCESS)
 	{
 		headerSize = ns::align_up(headerSize, OPTIX_ACCEL_BUFFER_BYTE_ALIGNMENT);
 
 		//!	Last aligned 8-bytes for storing compacted size.
-		m_tempBuffer.resize(allocator, ns::align_up(NS_MAX(accelBufferSizes.tempSizeInBytes, accelBufferSizes.tempUpdateSizeInBytes), alignof(uint64_t)) + sizeof(uint64_t));
+		this->reserve(m_tempBuffer, allocator, ns::align_up(NS_MAX(accelBufferSizes.tempSizeInBytes, accelBufferSizes.tempUpdateSizeInBytes), alignof(uint64_t)) + sizeof(uint64_t));
 
 		if (buildOptions.buildFlags & OPTIX_BUILD_FLAG_ALLOW_COMPACTION)
 		{
-			m_outputBuffer.resize(allocator, accelBufferSizes.outputSizeInBytes);
+			this->reserve(m_outputBuffer, allocator, accelBufferSizes.outputSizeInBytes);
 
 			OptixAccelEmitDesc			emittedProp = {};
 			OptixTraversableHandle		outputHandle = 0;
 			emittedProp.type			= OPTIX_PROPERTY_TYPE_COMPACTED_SIZE;
 			emittedProp.result			= CUdeviceptr(m_tempBuffer.data() + m_tempBuffer.size() - sizeof(uint64_t));
 
-			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &buildOptions, buildInputs.data(), (uint32_t)buildInputs.size(),
-								  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), (CUdeviceptr)m_outputBuffer.data(),
-								  m_outputBuffer.bytes(), &outputHandle, &emittedProp, 1);
+			{
+				Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelBuild", this);
+
+				err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &buildOptions, m_optixBuildInputs.data(), (uint32_t)m_optixBuildInputs.size(),
+									  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), (CUdeviceptr)m_outputBuffer.data(),
+									  m_outputBuffer.bytes(), &outputHandle, &emittedProp, 1);
+			}
 
 			if (err == OPTIX_SUCCESS)
 			{
@@ -105,20 +252,28 @@ void AccelStructBase::build(ns::Stream & stream, ns::AllocPtr allocator, const s
 				stream.memcpy<uint64_t>(&compactedSize, (const uint64_t*)emittedProp.result, 1).sync();
 
 				//!	First \p headerSize bytes for storing user data.
-				m_compactedBuffer.resize(allocator, headerSize + compactedSize);
+				this->reserve(m_compactedBuffer, allocator, headerSize + compactedSize);
 
-				err = optixAccelCompact(m_deviceContext->handle(), stream.handle(), outputHandle,
-										CUdeviceptr(m_compactedBuffer.data() + headerSize), m_compactedBuffer.bytes() - headerSize, &m_hTraversable);
+				{
+					Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelCompact", this);
+
+					err = optixAccelCompact(m_deviceContext->handle(), stream.handle(), outputHandle,
+											CUdeviceptr(m_compactedBuffer.data() + headerSize), m_compactedBuffer.bytes() - headerSize, &m_hTraversable);
+				}
 			}
 		}
 		else
 		{
 			//!	First \p headerSize bytes for storing user data.
-			m_outputBuffer.resize(allocator, headerSize + accelBufferSizes.outputSizeInBytes);
+			this->reserve(m_outputBuffer, allocator, headerSize + accelBufferSizes.outputSizeInBytes);
+
+			{
+				Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelBuild", this);
 
-			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &buildOptions, buildInputs.data(), (uint32_t)buildInputs.size(),
-								  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), CUdeviceptr(m_outputBuffer.data() + headerSize),
-								  m_outputBuffer.bytes() - headerSize, &m_hTraversable, nullptr, 0);
+				err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &buildOptions, m_optixBuildInputs.data(), (uint32_t)m_optixBuildInputs.size(),
+									  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), CUdeviceptr(m_outputBuffer.data() + headerSize),
+									  m_outputBuffer.bytes() - headerSize, &m_hTraversable, nullptr, 0);
+			}
 		}
 	}
 
@@ -130,7 +285,6 @@ void AccelStructBase::build(ns::Stream & stream, ns::AllocPtr allocator, const s
 	}
 
 	m_buildOptions = buildOptions;
-	m_buildInputs = buildInputs;
 	m_headerSize = headerSize;
 }
 
@@ -147,20 +301,30 @@ void AccelStructBase::rebuild(ns::Stream & stream)
 
 		if (this->allowCompaction())
 		{
-			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_buildInputs.data(), (uint32_t)m_buildInputs.size(),
-								  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), (CUdeviceptr)m_outputBuffer.data(), m_outputBuffer.bytes(), &outputHandle, nullptr, 0);
+			{
+				Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelBuild", this);
+
+				err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_optixBuildInputs.data(), (uint32_t)m_optixBuildInputs.size(),
+									  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), (CUdeviceptr)m_outputBuffer.data(), m_outputBuffer.bytes(), &outputHandle, nullptr, 0);
+			}
 
 			if (err == OPTIX_SUCCESS)
 			{
+				Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelCompact", this);
+
 				err = optixAccelCompact(m_deviceContext->handle(), stream.handle(), outputHandle,
 										CUdeviceptr(m_compactedBuffer.data() + m_headerSize), m_compactedBuffer.bytes() - m_headerSize, &m_hTraversable);
 			}
 		}
 		else
 		{
-			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_buildInputs.data(), (uint32_t)m_buildInputs.size(),
-								  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), CUdeviceptr(m_outputBuffer.data() + m_headerSize),
-								  m_outputBuffer.bytes() - m_headerSize, &outputHandle, nullptr, 0);
+			{
+				Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelBuild", this);
+
+				err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_optixBuildInputs.data(), (uint32_t)m_optixBuildInputs.size(),
+									  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), CUdeviceptr(m_outputBuffer.data() + m_headerSize),
+									  m_outputBuffer.bytes() - m_headerSize, &outputHandle, nullptr, 0);
+			}
 
 			m_hTraversable = outputHandle;
 		}
@@ -185,13 +349,17 @@ void AccelStructBase::refit(ns::Stream & stream)
 
 		if (this->allowCompaction())
 		{
-			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_buildInputs.data(), (uint32_t)m_buildInputs.size(),
+			Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelBuild (update)", this);
+
+			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_optixBuildInputs.data(), (uint32_t)m_optixBuildInputs.size(),
 								  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), CUdeviceptr(m_compactedBuffer.data() + m_headerSize),
 								  m_compactedBuffer.bytes() - m_headerSize, &m_hTraversable, nullptr, 0);
 		}
 		else
 		{
-			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_buildInputs.data(), (uint32_t)m_buildInputs.size(),
+			Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixAccelBuild (update)", this);
+
+			err = optixAccelBuild(m_deviceContext->handle(), stream.handle(), &m_buildOptions, m_optixBuildInputs.data(), (uint32_t)m_optixBuildInputs.size(),
 								  (CUdeviceptr)m_tempBuffer.data(), m_tempBuffer.bytes(), CUdeviceptr(m_outputBuffer.data() + m_headerSize),
 								  m_outputBuffer.bytes() - m_headerSize, &m_hTraversable, nullptr, 0);
 		}
@@ -219,60 +387,114 @@ AccelStructBase::~AccelStructBase()
 *************************    AccelStructTriangleImpl    **************************
 *********************************************************************************/
 
+//!	Check that every input has either no flags or one flag per SBT record.
+template<typename BuildInput> static bool validateGeomFlags(ns::ArrayProxy<BuildInput> buildInputs)
+{
+	for (size_t i = 0; i < buildInputs.size(); i++)
+	{
+		if (!buildInputs[i].perSbtRecordFlags.empty() && (buildInputs[i].perSbtRecordFlags.size() != buildInputs[i].numSbtRecords))
+		{
+			NS_ASSERT_LOG_IF(buildInputs[i].perSbtRecordFlags.size() != buildInputs[i].numSbtRecords, "Geometry flags does not match with numSbtRecords!");
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//!	Whether `geomFlags` already holds the (validated) flags of an input.
+static bool sameGeomFlags(const std::vector<unsigned int> & geomFlags, ns::ArrayProxy<GeomAccelStruct::GeomFlags> perSbtRecordFlags, unsigned int numSbtRecords)
+{
+	if (geomFlags.size() != numSbtRecords)
+	{
+		return false;
+	}
+	else if (perSbtRecordFlags.empty())
+	{
+		return std::all_of(geomFlags.begin(), geomFlags.end(), [](unsigned int flags) { return flags == OPTIX_GEOMETRY_FLAG_NONE; });
+	}
+	else
+	{
+		return std::memcmp(geomFlags.data(), perSbtRecordFlags.data(), sizeof(GeomAccelStruct::GeomFlags) * numSbtRecords) == 0;
+	}
+}
+
+
+static void assignGeomFlags(std::vector<unsigned int> & geomFlags, ns::ArrayProxy<GeomAccelStruct::GeomFlags> perSbtRecordFlags, unsigned int numSbtRecords)
+{
+	if (perSbtRecordFlags.empty())
+	{
+		geomFlags.assign(numSbtRecords, OPTIX_GEOMETRY_FLAG_NONE);
+	}
+	else
+	{
+		geomFlags.resize(numSbtRecords);
+
+		std::memcpy(geomFlags.data(), perSbtRecordFlags.data(), sizeof(GeomAccelStruct::GeomFlags) * numSbtRecords);
+	}
+}
+
+
 void AccelStructTriangleImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns::ArrayProxy<BuildInput> buildInputs, size_t headerSize, bool preferFastTrace, bool allowUpdate)
 {
+	if (!validateGeomFlags(buildInputs))
+	{
+		return;
+	}
+
+	//	Inputs are translated in place: storage is reused across builds, and entries whose layout did
+	//	not change (counts, flags, optional buffers) only get their device addresses patched.
+	const size_t numTranslated = NS_MIN(m_buildInputs.size(), m_optixBuildInputs.size());
+
 	m_numSbtRecords = 0;
 	m_geomFlags.resize(buildInputs.size());
 	m_vertBuffers.resize(buildInputs.size());
 	m_buildInputs.resize(buildInputs.size());
+	m_optixBuildInputs.resize(buildInputs.size());
 
-	std::vector<OptixBuildInput> optixBuildInputs(buildInputs.size());
-
-	for (size_t i = 0; i < optixBuildInputs.size(); i++)
+	for (size_t i = 0; i < buildInputs.size(); i++)
 	{
-		const bool useInexBuffer = (buildInputs[i].indexBuffer != nullptr) && (buildInputs[i].numIndexTriplets > 0);
+		const BuildInput & buildInput = buildInputs[i];
+		const bool useInexBuffer = (buildInput.indexBuffer != nullptr) && (buildInput.numIndexTriplets > 0);
+		const bool sameLayout = (i < numTranslated) && (m_buildInputs[i].numVertices == buildInput.numVertices) && (m_buildInputs[i].numIndexTriplets == buildInput.numIndexTriplets) &&
+								((m_buildInputs[i].indexBuffer != nullptr) == (buildInput.indexBuffer != nullptr)) && (m_buildInputs[i].primitiveIndexOffset == buildInput.primitiveIndexOffset) &&
+								sameGeomFlags(m_geomFlags[i], buildInput.perSbtRecordFlags, buildInput.numSbtRecords);
 
-		if (buildInputs[i].perSbtRecordFlags.empty())
-		{
-			m_geomFlags[i].assign(buildInputs[i].numSbtRecords, OPTIX_GEOMETRY_FLAG_NONE);
-		}
-		else if (buildInputs[i].perSbtRecordFlags.size() == buildInputs[i].numSbtRecords)
-		{
-			m_geomFlags[i].resize(buildInputs[i].perSbtRecordFlags.size());
+		OptixBuildInputTriangleArray & triangleArray						= m_optixBuildInputs[i].triangleArray;
 
-			std::memcpy(m_geomFlags[i].data(),buildInputs[i].perSbtRecordFlags.data(), sizeof(GeomFlags) * buildInputs[i].perSbtRecordFlags.size());
-		}
-		else
+		if (!sameLayout)
 		{
-			NS_ASSERT_LOG_IF(buildInputs[i].perSbtRecordFlags.size() != buildInputs[i].numSbtRecords, "Geometry flags does not match with numSbtRecords!");
-
-			return;
+			assignGeomFlags(m_geomFlags[i], buildInput.perSbtRecordFlags, buildInput.numSbtRecords);
+
+			m_optixBuildInputs[i]											= OptixBuildInput{};
+			m_optixBuildInputs[i].type										= OPTIX_BUILD_INPUT_TYPE_TRIANGLES;
+			triangleArray.vertexFormat										= OPTIX_VERTEX_FORMAT_FLOAT3;
+			triangleArray.vertexStrideInBytes								= sizeof(ns::float3_16a);
+			triangleArray.numVertices										= buildInput.numVertices;
+			triangleArray.numIndexTriplets									= useInexBuffer ? buildInput.numIndexTriplets : 0;
+			triangleArray.indexStrideInBytes								= useInexBuffer ? sizeof(ns::int3_16a) : 0;
+			triangleArray.preTransform										= NULL;
+			triangleArray.numSbtRecords										= buildInput.numSbtRecords;
+			triangleArray.primitiveIndexOffset								= buildInput.primitiveIndexOffset;
+			triangleArray.sbtIndexOffsetSizeInBytes							= sizeof(uint32_t);
+			triangleArray.sbtIndexOffsetStrideInBytes						= sizeof(uint32_t);
+		#if OPTIX_VERSION >= 70100
+			triangleArray.indexFormat										= useInexBuffer ? OPTIX_INDICES_FORMAT_UNSIGNED_INT3 : OPTIX_INDICES_FORMAT_NONE;
+			triangleArray.transformFormat									= OPTIX_TRANSFORM_FORMAT_NONE;
+		#else
+			triangleArray.indexFormat										= OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
+		#endif
 		}
 
-		m_buildInputs[i]													= buildInputs[i];
-		m_vertBuffers[i]													= (CUdeviceptr)buildInputs[i].vertexBuffer.data();
-		m_numSbtRecords														+= buildInputs[i].numSbtRecords;
-		optixBuildInputs[i].type											= OPTIX_BUILD_INPUT_TYPE_TRIANGLES;
-		optixBuildInputs[i].triangleArray.flags								= m_geomFlags[i].data();
-		optixBuildInputs[i].triangleArray.vertexFormat						= OPTIX_VERTEX_FORMAT_FLOAT3;
-		optixBuildInputs[i].triangleArray.vertexStrideInBytes				= sizeof(ns::float3_16a);
-		optixBuildInputs[i].triangleArray.vertexBuffers						= &m_vertBuffers[i];
-		optixBuildInputs[i].triangleArray.numVertices						= buildInputs[i].numVertices;
-		optixBuildInputs[i].triangleArray.indexBuffer						= useInexBuffer ? (CUdeviceptr)buildInputs[i].indexBuffer.data() : NULL;
-		optixBuildInputs[i].triangleArray.numIndexTriplets					= useInexBuffer ? buildInputs[i].numIndexTriplets : 0;
-		optixBuildInputs[i].triangleArray.indexStrideInBytes				= useInexBuffer ? sizeof(ns::int3_16a) : 0;
-		optixBuildInputs[i].triangleArray.preTransform						= NULL;
-		optixBuildInputs[i].triangleArray.numSbtRecords						= buildInputs[i].numSbtRecords;
-		optixBuildInputs[i].triangleArray.primitiveIndexOffset				= buildInputs[i].primitiveIndexOffset;
-		optixBuildInputs[i].triangleArray.sbtIndexOffsetBuffer				= (CUdeviceptr)buildInputs[i].sbtIndexOffsetBuffer.data();
-		optixBuildInputs[i].triangleArray.sbtIndexOffsetSizeInBytes			= sizeof(uint32_t);
-		optixBuildInputs[i].triangleArray.sbtIndexOffsetStrideInBytes		= sizeof(uint32_t);
-	#if OPTIX_VERSION >= 70100
-		optixBuildInputs[i].triangleArray.indexFormat						= useInexBuffer ? OPTIX_INDICES_FORMAT_UNSIGNED_INT3 : OPTIX_INDICES_FORMAT_NONE;
-		optixBuildInputs[i].triangleArray.transformFormat					= OPTIX_TRANSFORM_FORMAT_NONE;
-	#else
-		optixBuildInputs[i].triangleArray.indexFormat						= OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
-	#endif
+		m_buildInputs[i]													= buildInput;
+		m_vertBuffers[i]													= (CUdeviceptr)buildInput.vertexBuffer.data();
+		m_numSbtRecords														+= buildInput.numSbtRecords;
+		triangleArray.flags													= m_geomFlags[i].data();
+		triangleArray.vertexBuffers											= &m_vertBuffers[i];
+		triangleArray.indexBuffer											= useInexBuffer ? (CUdeviceptr)buildInput.indexBuffer.data() : NULL;
+		triangleArray.sbtIndexOffsetBuffer									= (CUdeviceptr)buildInput.sbtIndexOffsetBuffer.data();
 	}
 
 	OptixAccelBuildOptions						buildOptions = {};
@@ -286,7 +508,7 @@ void AccelStructTriangleImpl::build(ns::Stream & stream, ns::AllocPtr allocator,
 	buildOptions.motionOptions.timeEnd			= 0.0f;
 	buildOptions.motionOptions.flags			= OPTIX_MOTION_FLAG_NONE;
 
-	AccelStructBase::build(stream, allocator, optixBuildInputs, buildOptions, headerSize);
+	AccelStructBase::build(stream, allocator, buildOptions, headerSize);
 }
 
 /*********************************************************************************
@@ -295,57 +517,52 @@ void AccelStructTriangleImpl::build(ns::Stream & stream, ns::AllocPtr allocator,
 
 void AccelStructAabbImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns::ArrayProxy<BuildInput> buildInputs, size_t headerSize, bool preferFastTrace, bool allowUpdate)
 {
+	if (!validateGeomFlags(buildInputs))
+	{
+		return;
+	}
+
+	//	See `AccelStructTriangleImpl::build()`.
+	const size_t numTranslated = NS_MIN(m_buildInputs.size(), m_optixBuildInputs.size());
+
 	m_numSbtRecords = 0;
 	m_geomFlags.resize(buildInputs.size());
 	m_aabbBuffers.resize(buildInputs.size());
 	m_buildInputs.resize(buildInputs.size());
+	m_optixBuildInputs.resize(buildInputs.size());
 
-	std::vector<OptixBuildInput> optixBuildInputs(buildInputs.size());
-
-	for (size_t i = 0; i < optixBuildInputs.size(); i++)
+	for (size_t i = 0; i < buildInputs.size(); i++)
 	{
-		if (buildInputs[i].perSbtRecordFlags.empty())
-		{
-			m_geomFlags[i].assign(buildInputs[i].numSbtRecords, OPTIX_GEOMETRY_FLAG_NONE);
-		}
-		else if (buildInputs[i].perSbtRecordFlags.size() == buildInputs[i].numSbtRecords)
-		{
-			m_geomFlags[i].resize(buildInputs[i].perSbtRecordFlags.size());
-
-			std::memcpy(m_geomFlags[i].data(),buildInputs[i].perSbtRecordFlags.data(), sizeof(GeomFlags) * buildInputs[i].perSbtRecordFlags.size());
-		}
-		else
-		{
-			NS_ASSERT_LOG_IF(buildInputs[i].perSbtRecordFlags.size() != buildInputs[i].numSbtRecords, "Geometry flags does not match with numSbtRecords!");
+		const BuildInput & buildInput = buildInputs[i];
+		const bool sameLayout = (i < numTranslated) && (m_buildInputs[i].numPrimitives == buildInput.numPrimitives) && (m_buildInputs[i].primitiveIndexOffset == buildInput.primitiveIndexOffset) &&
+								sameGeomFlags(m_geomFlags[i], buildInput.perSbtRecordFlags, buildInput.numSbtRecords);
 
-			return;
-		}
-
-		m_buildInputs[i]															= buildInputs[i];
-		m_aabbBuffers[i]															= (CUdeviceptr)buildInputs[i].aabbBuffer.data();
-		m_numSbtRecords																+= buildInputs[i].numSbtRecords;
-		optixBuildInputs[i].type													= OPTIX_BUILD_INPUT_TYPE_CUSTOM_PRIMITIVES;
 	#if OPTIX_VERSION >= 70100
-		optixBuildInputs[i].customPrimitiveArray.flags								= m_geomFlags[i].data();
-		optixBuildInputs[i].customPrimitiveArray.aabbBuffers						= &m_aabbBuffers[i];
-		optixBuildInputs[i].customPrimitiveArray.strideInBytes						= sizeof(Aabb);
-		optixBuildInputs[i].customPrimitiveArray.numPrimitives						= buildInputs[i].numPrimitives;
-		optixBuildInputs[i].customPrimitiveArray.numSbtRecords						= buildInputs[i].numSbtRecords;
-		optixBuildInputs[i].customPrimitiveArray.primitiveIndexOffset				= buildInputs[i].primitiveIndexOffset;
-		optixBuildInputs[i].customPrimitiveArray.sbtIndexOffsetBuffer				= (CUdeviceptr)buildInputs[i].sbtIndexOffsetBuffer.data();
-		optixBuildInputs[i].customPrimitiveArray.sbtIndexOffsetSizeInBytes			= sizeof(uint32_t);
-		optixBuildInputs[i].customPrimitiveArray.sbtIndexOffsetStrideInBytes		= sizeof(uint32_t);
+		OptixBuildInputCustomPrimitiveArray & aabbArray						= m_optixBuildInputs[i].customPrimitiveArray;
 	#else
-		optixBuildInputs[i].aabbArray.flags											= m_geomFlags[i].data();
-		optixBuildInputs[i].aabbArray.aabbBuffers									= &m_aabbBuffers[i];
-		optixBuildInputs[i].aabbArray.strideInBytes									= sizeof(Aabb);
-		optixBuildInputs[i].aabbArray.numPrimitives									= buildInputs[i].numPrimitives;
-		optixBuildInputs[i].aabbArray.numSbtRecords									= buildInputs[i].numSbtRecords;
-		optixBuildInputs[i].aabbArray.primitiveIndexOffset							= buildInputs[i].primitiveIndexOffset;
-		optixBuildInputs[i].aabbArray.sbtIndexOffsetBuffer							= (CUdeviceptr)buildInputs[i].sbtIndexOffsetBuffer.data();
-		optixBuildInputs[i].aabbArray.sbtIndexOffsetSizeInBytes						= sizeof(uint32_t);
-		optixBuildInputs[i].aabbArray.sbtIndexOffsetStrideInBytes					= sizeof(uint32_t);
+		OptixBuildInputCustomPrimitiveArray & aabbArray						= m_optixBuildInputs[i].aabbArray;
 	#endif
+
+		if (!sameLayout)
+		{
+			assignGeomFlags(m_geomFlags[i], buildInput.perSbtRecordFlags, buildInput.numSbtRecords);
+
+			m_optixBuildInputs[i]											= OptixBuildInput{};
+			m_optixBuildInputs[i].type										= OPTIX_BUILD_INPUT_TYPE_CUSTOM_PRIMITIVES;
+			aabbArray.strideInBytes											= sizeof(Aabb);
+			aabbArray.numPrimitives											= buildInput.numPrimitives;
+			aabbArray.numSbtRecords											= buildInput.numSbtRecords;
+			aabbArray.primitiveIndexOffset									= buildInput.primitiveIndexOffset;
+			aabbArray.sbtIndexOffsetSizeInBytes								= sizeof(uint32_t);
+			aabbArray.sbtIndexOffsetStrideInBytes							= sizeof(uint32_t);
+		}
+
+		m_buildInputs[i]													= buildInput;
+		m_aabbBuffers[i]													= (CUdeviceptr)buildInput.aabbBuffer.data();
+		m_numSbtRecords														+= buildInput.numSbtRecords;
+		aabbArray.flags														= m_geomFlags[i].data();
+		aabbArray.aabbBuffers												= &m_aabbBuffers[i];
+		aabbArray.sbtIndexOffsetBuffer										= (CUdeviceptr)buildInput.sbtIndexOffsetBuffer.data();
 	}
 
 	OptixAccelBuildOptions						buildOptions = {};
@@ -359,7 +576,7 @@ void AccelStructAabbImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns:
 	buildOptions.motionOptions.timeEnd			= 0.0f;
 	buildOptions.motionOptions.flags			= OPTIX_MOTION_FLAG_NONE;
 
-	AccelStructBase::build(stream, allocator, optixBuildInputs, buildOptions, headerSize);
+	AccelStructBase::build(stream, allocator, buildOptions, headerSize);
 }
 
 /*********************************************************************************
@@ -368,38 +585,53 @@ void AccelStructAabbImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns:
 
 void AccelStructCurveImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns::ArrayProxy<BuildInput> buildInputs, size_t headerSize, bool preferFastTrace, bool allowUpdate)
 {
+	//	See `AccelStructTriangleImpl::build()`.
+	const size_t numTranslated = NS_MIN(m_buildInputs.size(), m_optixBuildInputs.size());
+
 	m_buildInputs.resize(buildInputs.size());
 	m_vertBuffers.resize(buildInputs.size());
 	m_widthBuffers.resize(buildInputs.size());
+	m_optixBuildInputs.resize(buildInputs.size());
 	m_numSbtRecords = static_cast<uint32_t>(buildInputs.size());
 
-	std::vector<OptixBuildInput> optixBuildInputs(buildInputs.size());
-
 	for (size_t i = 0; i < buildInputs.size(); i++)
 	{
-		m_buildInputs[i]										= buildInputs[i];
-		m_vertBuffers[i]										= (CUdeviceptr)buildInputs[i].vertexBuffer.data();
-		m_widthBuffers[i]										= (CUdeviceptr)buildInputs[i].widthBuffer.data();
+		const BuildInput & buildInput = buildInputs[i];
 
-	#if OPTIX_VERSION >= 70400
-		optixBuildInputs[i].curveArray.endcapFlags				= OPTIX_CURVE_ENDCAP_DEFAULT;
-	#endif
 	#if OPTIX_VERSION >= 70100
-		optixBuildInputs[i].type								= OPTIX_BUILD_INPUT_TYPE_CURVES;
-		optixBuildInputs[i].curveArray.flag						= buildInputs[i].flags;
-		optixBuildInputs[i].curveArray.curveType				= static_cast<OptixPrimitiveType>(buildInputs[i].curveType);
-		optixBuildInputs[i].curveArray.numVertices				= buildInputs[i].numVertices;
-		optixBuildInputs[i].curveArray.numPrimitives			= buildInputs[i].numPrimitives;
-		optixBuildInputs[i].curveArray.primitiveIndexOffset		= buildInputs[i].primitiveIndexOffset;
-		optixBuildInputs[i].curveArray.vertexBuffers			= &m_vertBuffers[i];
-		optixBuildInputs[i].curveArray.vertexStrideInBytes		= sizeof(ns::float3_16a);
-		optixBuildInputs[i].curveArray.indexBuffer				= (CUdeviceptr)buildInputs[i].indexBuffer.data();
-		optixBuildInputs[i].curveArray.indexStrideInBytes		= sizeof(uint32_t);
-		optixBuildInputs[i].curveArray.widthBuffers				= &m_widthBuffers[i];
-		optixBuildInputs[i].curveArray.widthStrideInBytes		= sizeof(float);
-		optixBuildInputs[i].curveArray.normalBuffers			= nullptr;
-		optixBuildInputs[i].curveArray.normalStrideInBytes		= 0;
+		const bool sameLayout = (i < numTranslated) && (m_buildInputs[i].curveType == buildInput.curveType) && (m_buildInputs[i].numPrimitives == buildInput.numPrimitives) &&
+								(m_buildInputs[i].numVertices == buildInput.numVertices) && (m_buildInputs[i].primitiveIndexOffset == buildInput.primitiveIndexOffset) &&
+								(m_buildInputs[i].flags == buildInput.flags);
+
+		OptixBuildInputCurveArray & curveArray					= m_optixBuildInputs[i].curveArray;
+
+		if (!sameLayout)
+		{
+			m_optixBuildInputs[i]								= OptixBuildInput{};
+			m_optixBuildInputs[i].type							= OPTIX_BUILD_INPUT_TYPE_CURVES;
+			curveArray.flag										= buildInput.flags;
+			curveArray.curveType								= static_cast<OptixPrimitiveType>(buildInput.curveType);
+			curveArray.numVertices								= buildInput.numVertices;
+			curveArray.numPrimitives							= buildInput.numPrimitives;
+			curveArray.primitiveIndexOffset						= buildInput.primitiveIndexOffset;
+			curveArray.vertexStrideInBytes						= sizeof(ns::float3_16a);
+			curveArray.indexStrideInBytes						= sizeof(uint32_t);
+			curveArray.widthStrideInBytes						= sizeof(float);
+			curveArray.normalBuffers							= nullptr;
+			curveArray.normalStrideInBytes						= 0;
+		#if OPTIX_VERSION >= 70400
+			curveArray.endcapFlags								= OPTIX_CURVE_ENDCAP_DEFAULT;
+		#endif
+		}
+
+		curveArray.vertexBuffers								= &m_vertBuffers[i];
+		curveArray.indexBuffer									= (CUdeviceptr)buildInput.indexBuffer.data();
+		curveArray.widthBuffers									= &m_widthBuffers[i];
 	#endif
+
+		m_buildInputs[i]										= buildInput;
+		m_vertBuffers[i]										= (CUdeviceptr)buildInput.vertexBuffer.data();
+		m_widthBuffers[i]										= (CUdeviceptr)buildInput.widthBuffer.data();
 	}
 
 	OptixAccelBuildOptions						buildOptions = {};
@@ -413,7 +645,7 @@ void AccelStructCurveImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns
 	buildOptions.motionOptions.timeEnd			= 0.0f;
 	buildOptions.motionOptions.flags			= OPTIX_MOTION_FLAG_NONE;
 
-	AccelStructBase::build(stream, allocator, optixBuildInputs, buildOptions, headerSize);
+	AccelStructBase::build(stream, allocator, buildOptions, headerSize);
 }
 
 /*********************************************************************************
@@ -422,50 +654,57 @@ void AccelStructCurveImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns
 
 void AccelStructSphereImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns::ArrayProxy<BuildInput> buildInputs, size_t headerSize, bool preferFastTrace, bool allowUpdate)
 {
+	if (!validateGeomFlags(buildInputs))
+	{
+		return;
+	}
+
+	//	See `AccelStructTriangleImpl::build()`.
+	const size_t numTranslated = NS_MIN(m_buildInputs.size(), m_optixBuildInputs.size());
+
 	m_numSbtRecords = 0;
 	m_geomFlags.resize(buildInputs.size());
 	m_buildInputs.resize(buildInputs.size());
 	m_vertBuffers.resize(buildInputs.size());
 	m_radiusBuffers.resize(buildInputs.size());
+	m_optixBuildInputs.resize(buildInputs.size());
 
-	std::vector<OptixBuildInput> optixBuildInputs(buildInputs.size());
-	
 	for (size_t i = 0; i < buildInputs.size(); i++)
 	{
-		if (buildInputs[i].perSbtRecordFlags.empty())
+		const BuildInput & buildInput = buildInputs[i];
+		const bool sameLayout = (i < numTranslated) && (m_buildInputs[i].numVertices == buildInput.numVertices) && (m_buildInputs[i].singleRadius == buildInput.singleRadius) &&
+								(m_buildInputs[i].primitiveIndexOffset == buildInput.primitiveIndexOffset) && sameGeomFlags(m_geomFlags[i], buildInput.perSbtRecordFlags, buildInput.numSbtRecords);
+
+		if (!sameLayout)
 		{
-			m_geomFlags[i].assign(buildInputs[i].numSbtRecords, OPTIX_GEOMETRY_FLAG_NONE);
+			assignGeomFlags(m_geomFlags[i], buildInput.perSbtRecordFlags, buildInput.numSbtRecords);
 		}
-		else if (buildInputs[i].perSbtRecordFlags.size() == buildInputs[i].numSbtRecords)
-		{
-			m_geomFlags[i].resize(buildInputs[i].perSbtRecordFlags.size());
 
-			std::memcpy(m_geomFlags[i].data(),buildInputs[i].perSbtRecordFlags.data(), sizeof(GeomFlags) * buildInputs[i].perSbtRecordFlags.size());
-		}
-		else
-		{
-			NS_ASSERT_LOG_IF(buildInputs[i].perSbtRecordFlags.size() != buildInputs[i].numSbtRecords, "Geometry flags does not match with numSbtRecords!");
+		m_buildInputs[i]												= buildInput;
+		m_vertBuffers[i]												= (CUdeviceptr)buildInput.vertexBuffer.data();
+		m_radiusBuffers[i]												= (CUdeviceptr)buildInput.radiusBuffer.data();
+		m_numSbtRecords													+= buildInput.numSbtRecords;
 
-			return;
+	#if OPTIX_VERSION >= 70500
+		OptixBuildInputSphereArray & sphereArray						= m_optixBuildInputs[i].sphereArray;
+
+		if (!sameLayout)
+		{
+			m_optixBuildInputs[i]										= OptixBuildInput{};
+			m_optixBuildInputs[i].type									= OPTIX_BUILD_INPUT_TYPE_SPHERES;
+			sphereArray.numVertices										= buildInput.numVertices;
+			sphereArray.radiusStrideInBytes								= sizeof(float);
+			sphereArray.singleRadius									= buildInput.singleRadius;
+			sphereArray.numSbtRecords									= buildInput.numSbtRecords;
+			sphereArray.primitiveIndexOffset							= buildInput.primitiveIndexOffset;
+			sphereArray.sbtIndexOffsetSizeInBytes						= sizeof(uint32_t);
+			sphereArray.sbtIndexOffsetStrideInBytes						= sizeof(uint32_t);
 		}
 
-		m_buildInputs[i]												= buildInputs[i];
-		m_vertBuffers[i]												= (CUdeviceptr)buildInputs[i].vertexBuffer.data();
-		m_radiusBuffers[i]												= (CUdeviceptr)buildInputs[i].radiusBuffer.data();
-		m_numSbtRecords													+= buildInputs[i].numSbtRecords;
-	#if OPTIX_VERSION >= 70500
-		optixBuildInputs[i].type										= OPTIX_BUILD_INPUT_TYPE_SPHERES;
-		optixBuildInputs[i].sphereArray.flags							= m_geomFlags[i].data();
-		optixBuildInputs[i].sphereArray.numVertices						= buildInputs[i].numVertices;
-		optixBuildInputs[i].sphereArray.vertexBuffers					= &m_vertBuffers[i];
-		optixBuildInputs[i].sphereArray.radiusBuffers					= &m_radiusBuffers[i];
-		optixBuildInputs[i].sphereArray.radiusStrideInBytes				= sizeof(float);
-		optixBuildInputs[i].sphereArray.singleRadius					= buildInputs[i].singleRadius;
-		optixBuildInputs[i].sphereArray.numSbtRecords					= buildInputs[i].numSbtRecords;
-		optixBuildInputs[i].sphereArray.primitiveIndexOffset			= buildInputs[i].primitiveIndexOffset;
-		optixBuildInputs[i].sphereArray.sbtIndexOffsetBuffer			= (CUdeviceptr)buildInputs[i].sbtIndexOffsetBuffer.data();
-		optixBuildInputs[i].sphereArray.sbtIndexOffsetSizeInBytes		= sizeof(uint32_t);
-		optixBuildInputs[i].sphereArray.sbtIndexOffsetStrideInBytes		= sizeof(uint32_t);
+		sphereArray.flags												= m_geomFlags[i].data();
+		sphereArray.vertexBuffers										= &m_vertBuffers[i];
+		sphereArray.radiusBuffers										= &m_radiusBuffers[i];
+		sphereArray.sbtIndexOffsetBuffer								= (CUdeviceptr)buildInput.sbtIndexOffsetBuffer.data();
 	#endif
 	}
 
@@ -480,7 +719,7 @@ void AccelStructSphereImpl::build(ns::Stream & stream, ns::AllocPtr allocator, n
 	buildOptions.motionOptions.timeEnd			= 0.0f;
 	buildOptions.motionOptions.flags			= OPTIX_MOTION_FLAG_NONE;
 
-	AccelStructBase::build(stream, allocator, optixBuildInputs, buildOptions, headerSize);
+	AccelStructBase::build(stream, allocator, buildOptions, headerSize);
 }
 
 /*********************************************************************************
@@ -518,26 +757,34 @@ void InstAccelStructImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns:
 	m_instances.resize(allocator, buildInputs.size());
 	m_transforms.resize(allocator, buildInputs.size());
 
-	std::vector<OptixInstance>					instances(buildInputs.size());
-	std::vector<ns::dev::Ptr<const Mat4x4>>		pTransforms(buildInputs.size());
+	m_hostInstances.resize(buildInputs.size());
+	m_hostTransforms.resize(buildInputs.size());
 
 	for (size_t i = 0; i < buildInputs.size(); i++)
 	{
-		instances[i]						= OptixInstance{};
-		instances[i].traversableHandle		= buildInputs[i].geomAccelStruct->handle();
-		instances[i].visibilityMask			= buildInputs[i].visibilityMask;
-		instances[i].instanceId				= buildInputs[i].instanceId;
-		instances[i].sbtOffset				= buildInputs[i].sbtOffset;
-		instances[i].flags					= buildInputs[i].flags;
-		pTransforms[i]						= buildInputs[i].transform;
-		m_buildInputs[i]					= buildInputs[i];
+		m_hostInstances[i]						= OptixInstance{};
+		m_hostInstances[i].traversableHandle	= buildInputs[i].geomAccelStruct->handle();
+		m_hostInstances[i].visibilityMask		= buildInputs[i].visibilityMask;
+		m_hostInstances[i].instanceId			= buildInputs[i].instanceId;
+		m_hostInstances[i].sbtOffset			= buildInputs[i].sbtOffset;
+		m_hostInstances[i].flags				= buildInputs[i].flags;
+		m_hostTransforms[i]						= buildInputs[i].transform;
+		m_buildInputs[i]						= buildInputs[i];
 	}
 
-	stream.memcpy(m_instances.data(), instances.data(), instances.size());
-	stream.memcpy(m_transforms.data(), pTransforms.data(), pTransforms.size());
-	stream.launch(kernels::AssignInstanceTransforms, ns::ceil_div(m_instances.size(), 128), 128)(m_instances, m_transforms, static_cast<uint32_t>(m_instances.size()));
+	stream.memcpy(m_instances.data(), m_hostInstances.data(), m_hostInstances.size());
+	stream.memcpy(m_transforms.data(), m_hostTransforms.data(), m_hostTransforms.size());
 
-	OptixBuildInput										optixBuildInput = {};
+	{
+		Profiler::Scope scope(this->deviceContext()->profiler(), stream, "AssignInstanceTransforms", this);
+
+		stream.launch(kernels::AssignInstanceTransforms, ns::ceil_div(m_instances.size(), 128), 128)(m_instances, m_transforms, static_cast<uint32_t>(m_instances.size()));
+	}
+
+	m_optixBuildInputs.resize(1);
+
+	OptixBuildInput &									optixBuildInput = m_optixBuildInputs[0];
+	optixBuildInput										= OptixBuildInput{};
 	optixBuildInput.type								= OPTIX_BUILD_INPUT_TYPE_INSTANCES;
 	optixBuildInput.instanceArray.instances				= (CUdeviceptr)m_instances.data();
 #if OPTIX_VERSION >= 70600
@@ -556,13 +803,17 @@ void InstAccelStructImpl::build(ns::Stream & stream, ns::AllocPtr allocator, ns:
 	buildOptions.motionOptions.timeEnd					= 0.0f;
 	buildOptions.motionOptions.flags					= OPTIX_MOTION_FLAG_NONE;
 
-	AccelStructBase::build(stream, allocator, { optixBuildInput }, buildOptions, 0);
+	AccelStructBase::build(stream, allocator, buildOptions, 0);
 }
 
 
 void InstAccelStructImpl::rebuild(ns::Stream & stream)
 {
-	stream.launch(kernels::AssignInstanceTransforms, ns::ceil_div(m_instances.size(), 128), 128)(m_instances, m_transforms, static_cast<uint32_t>(m_instances.size()));
+	{
+		Profiler::Scope scope(this->deviceContext()->profiler(), stream, "AssignInstanceTransforms", this);
+
+		stream.launch(kernels::AssignInstanceTransforms, ns::ceil_div(m_instances.size(), 128), 128)(m_instances, m_transforms, static_cast<uint32_t>(m_instances.size()));
+	}
 
 	AccelStructBase::rebuild(stream);
 }
@@ -570,7 +821,11 @@ void InstAccelStructImpl::rebuild(ns::Stream & stream)
 
 void InstAccelStructImpl::refit(ns::Stream & stream)
 {
-	stream.launch(kernels::AssignInstanceTransforms, ns::ceil_div(m_instances.size(), 128), 128)(m_instances, m_transforms, static_cast<uint32_t>(m_instances.size()));
+	{
+		Profiler::Scope scope(this->deviceContext()->profiler(), stream, "AssignInstanceTransforms", this);
+
+		stream.launch(kernels::AssignInstanceTransforms, ns::ceil_div(m_instances.size(), 128), 128)(m_instances, m_transforms, static_cast<uint32_t>(m_instances.size()));
+	}
 
 	AccelStructBase::refit(stream);
 }
\ No newline at end of file
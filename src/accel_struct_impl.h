@@ -25,6 +25,8 @@
 #include "device_context.h"
 #include <nucleus/array_1d.h>
 #include <optix.h>
+#include <algorithm>
+#include <map>
 
 #pragma warning(disable: 4250)
 
@@ -59,7 +61,8 @@ namespace PHOTON_NAMESPACE
 
 	public:
 
-		void build(ns::Stream & stream, ns::AllocPtr allocator, const std::vector<OptixBuildInput> & buildInputs, OptixAccelBuildOptions buildOptions, size_t headerSize);
+		//!	Build from `m_optixBuildInputs`, translated in place by the derived classes.
+		void build(ns::Stream & stream, ns::AllocPtr allocator, OptixAccelBuildOptions buildOptions, size_t headerSize);
 
 		bool allowCompaction() const { return (m_buildOptions.buildFlags & OPTIX_BUILD_FLAG_ALLOW_COMPACTION) != 0; }
 
@@ -73,19 +76,31 @@ namespace PHOTON_NAMESPACE
 				return dev::Ptr<unsigned char>(nullptr);
 		}
 
+	private:
+
+		//!	Memory usage of the current build inputs, queried once per input signature (counts, formats and flags).
+		OptixResult computeMemoryUsage(const OptixAccelBuildOptions & buildOptions, OptixAccelBufferSizes & accelBufferSizes);
+
+		//!	Grow geometrically, shrink only below a quarter of the current size.
+		static void reserve(ns::Array<unsigned char> & buffer, ns::AllocPtr allocator, size_t bytes);
+
 	protected:
 
 		size_t										m_headerSize;
 		unsigned int								m_numSbtRecords;
+		std::vector<OptixBuildInput>				m_optixBuildInputs;
 
 	private:
 
+		static constexpr size_t						maxCachedSignatures = 16;
+
 		ns::Array<unsigned char>					m_tempBuffer;
 		ns::Array<unsigned char>					m_outputBuffer;
 		ns::Array<unsigned char>					m_compactedBuffer;
 		OptixTraversableHandle						m_hTraversable;
 		OptixAccelBuildOptions						m_buildOptions;
-		std::vector<OptixBuildInput>				m_buildInputs;
+		std::vector<uint64_t>						m_signature;
+		std::map<std::vector<uint64_t>, OptixAccelBufferSizes>		m_memoryUsages;
 		const std::shared_ptr<DeviceContext>		m_deviceContext;
 	};
 
@@ -236,5 +251,7 @@ namespace PHOTON_NAMESPACE
 		std::vector<BuildInput>						m_buildInputs;
 		ns::Array<ns::dev::Ptr<const Mat4x4>>		m_transforms;
 		ns::Array<OptixInstance>					m_instances;
+		std::vector<ns::dev::Ptr<const Mat4x4>>		m_hostTransforms;
+		std::vector<OptixInstance>					m_hostInstances;
 	};
 }
\ No newline at end of file
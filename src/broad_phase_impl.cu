@@ -0,0 +1,250 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "broad_phase_impl.h"
+#include "broad_phase.optixir.h"
+#include <nucleus/stream.h>
+#include <nucleus/logger.h>
+#include <nucleus/launch_utils.cuh>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+namespace kernels
+{
+	//!	Radii are non-negative, so their bit patterns are ordered as unsigned integers.
+	__global__ void MaxRadius(dev::Ptr<float> maxRadius, dev::Ptr<const float> radii, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		atomicMax(reinterpret_cast<unsigned int*>(maxRadius.data()), __float_as_uint(fmaxf(radii[i], 0.0f)));
+	}
+
+
+	//!	Box of particle `j` is inflated by the largest radius, so it contains the center of every particle `i` that may overlap it.
+	__global__ void ComputeAabbs(dev::Ptr<Aabb> aabbs, dev::Ptr<const ns::float3_16a> positions, dev::Ptr<const float> radii, dev::Ptr<const float> maxRadius, float radius, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		const float r = (radii != nullptr) ? (radii[i] + maxRadius[0] + 2.0f * radius) : (2.0f * radius);
+		const ns::float3_16a p = positions[i];
+
+		aabbs[i].lower = ns::float3{ p.x - r, p.y - r, p.z - r };
+		aabbs[i].upper = ns::float3{ p.x + r, p.y + r, p.z + r };
+	}
+}
+
+/*********************************************************************************
+******************************    BroadPhaseImpl    ******************************
+*********************************************************************************/
+
+BroadPhaseImpl::BroadPhaseImpl(std::shared_ptr<DeviceContext> deviceContext) : m_numContacts(0), m_sbt{}, m_deviceContext(deviceContext)
+{
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.numPayloadValues = 2;
+	pipelineCompileOptions.numAttributeValues = 2;
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "broadPhaseParams";
+	pipelineCompileOptions.traversableGraphFlags = OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_GAS;
+	pipelineCompileOptions.usesPrimitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_CUSTOM;
+
+	OptixPipelineLinkOptions pipelineLinkOptions = {};
+	pipelineLinkOptions.maxTraceDepth = 1;
+
+	auto module = m_deviceContext->createModule(broad_phase_optixir, pipelineCompileOptions);
+	auto raygenProg = module->at("__raygen__broad_phase");
+	auto intersectionProg = module->at("__intersection__broad_phase");
+	auto missProg = module->at("__miss__broad_phase");
+
+	//	Program groups are kept alive as long as the pipeline.
+	m_programs = { raygenProg, intersectionProg, missProg };
+	m_pipeline = std::make_unique<Pipeline>(SharedContext(m_deviceContext), m_programs, pipelineCompileOptions, pipelineLinkOptions);
+
+	m_accelStruct = m_deviceContext->createAccelStructAabb();
+	m_spatialSort = m_deviceContext->createSpatialSort();
+
+	//	SBT records: [0] raygen, [1] hit group, [2] miss.
+	auto allocator = m_deviceContext->device()->defaultAllocator();
+	auto & stream = m_deviceContext->device()->defaultStream();
+
+	m_params.resize(allocator, 1);
+	m_numPairs.resize(allocator, 1);
+	m_maxRadius.resize(allocator, 1);
+	m_sbtRecords.resize(allocator, 3);
+
+	stream.memcpy(&m_sbtRecords.data()[0].header, &raygenProg->header(), 1);
+	stream.memcpy(&m_sbtRecords.data()[1].header, &intersectionProg->header(), 1);
+	stream.memcpy(&m_sbtRecords.data()[2].header, &missProg->header(), 1);
+	stream.sync();
+
+	m_sbt.raygenRecord					= (CUdeviceptr)(m_sbtRecords.data() + 0);
+	m_sbt.hitgroupRecordBase			= (CUdeviceptr)(m_sbtRecords.data() + 1);
+	m_sbt.hitgroupRecordStrideInBytes	= sizeof(EmptyRecord);
+	m_sbt.hitgroupRecordCount			= BroadPhaseRayTypes::hitgroupRecordCount(1);
+	m_sbt.missRecordBase				= (CUdeviceptr)(m_sbtRecords.data() + 2);
+	m_sbt.missRecordStrideInBytes		= sizeof(EmptyRecord);
+	m_sbt.missRecordCount				= BroadPhaseRayTypes::missRecordCount;
+}
+
+
+void BroadPhaseImpl::build(ns::Stream & stream, ns::AllocPtr allocator, const BuildInput & buildInput, unsigned int initialCapacity)
+{
+	NS_ASSERT(buildInput.positions != nullptr);
+
+	m_numContacts = 0;
+	m_allocator = allocator;
+	m_buildInput = buildInput;
+
+	if (initialCapacity == 0)
+	{
+		initialCapacity = 4 * NS_MAX(buildInput.numParticles, 256u);
+	}
+
+	m_aabbs.resize(allocator, buildInput.numParticles);
+	m_pairs.resize(allocator, initialCapacity);
+
+	//	The order is kept until the next build, refit only moves particles within it.
+	if (buildInput.reorder)
+	{
+		m_sortedPositions.resize(allocator, buildInput.numParticles);
+		m_sortedRadii.resize(allocator, (buildInput.radii != nullptr) ? buildInput.numParticles : 0);
+		m_spatialSort->sort(stream, allocator, buildInput.positions, buildInput.numParticles, SpatialSort::Hilbert);
+
+		this->gatherParticles(stream);
+	}
+
+	this->computeAabbs(stream);
+
+	AccelStructAabb::BuildInput aabbInput;
+	aabbInput.aabbBuffer = m_aabbs;
+	aabbInput.numPrimitives = buildInput.numParticles;
+
+	//	Refit is expected every substep, keep the GAS updatable.
+	m_accelStruct->build(stream, allocator, aabbInput, 0, true, true);
+
+	this->uploadParams(stream);
+}
+
+
+void BroadPhaseImpl::refit(ns::Stream & stream)
+{
+	if (m_buildInput.numParticles == 0)
+	{
+		return;
+	}
+
+	if (m_buildInput.reorder)
+	{
+		this->gatherParticles(stream);
+	}
+
+	this->computeAabbs(stream);
+
+	m_accelStruct->refit(stream);
+}
+
+
+void BroadPhaseImpl::gatherParticles(ns::Stream & stream)
+{
+	m_spatialSort->gather(stream, m_sortedPositions.ptr(), m_buildInput.positions);
+
+	if (m_buildInput.radii != nullptr)
+	{
+		m_spatialSort->gather(stream, m_sortedRadii.ptr(), m_buildInput.radii);
+	}
+}
+
+
+dev::Ptr<const BroadPhase::ContactPair> BroadPhaseImpl::detect(ns::Stream & stream)
+{
+	m_numContacts = 0;
+
+	if (m_buildInput.numParticles == 0)
+	{
+		return nullptr;
+	}
+
+	while (true)
+	{
+		unsigned int numPairs = 0;
+
+		stream.memset(m_numPairs.data(), 0, m_numPairs.bytes());
+
+		m_pipeline->launch<BroadPhaseParams>(stream, m_params.ptr(), m_sbt, m_buildInput.numParticles);
+
+		stream.memcpy(&numPairs, m_numPairs.data(), 1).sync();
+
+		if (numPairs <= m_pairs.size())
+		{
+			m_numContacts = numPairs;
+
+			break;
+		}
+
+		//	Overflow: the count is still exact, grow with some headroom and run again.
+		m_pairs.resize(m_allocator, ns::align_up(numPairs + numPairs / 4, 1024));
+
+		this->uploadParams(stream);
+	}
+
+	return dev::Ptr<const ContactPair>(m_pairs.data(), m_numContacts);
+}
+
+
+void BroadPhaseImpl::computeAabbs(ns::Stream & stream)
+{
+	const unsigned int count = m_buildInput.numParticles;
+
+	if (m_buildInput.radii != nullptr)
+	{
+		stream.memset(m_maxRadius.data(), 0, m_maxRadius.bytes());
+
+		stream.launch(kernels::MaxRadius, ns::ceil_div(count, 256), 256)(m_maxRadius, this->radii(), count);
+	}
+
+	stream.launch(kernels::ComputeAabbs, ns::ceil_div(count, 256), 256)(m_aabbs, this->positions(), this->radii(), m_maxRadius, m_buildInput.radius, count);
+}
+
+
+void BroadPhaseImpl::uploadParams(ns::Stream & stream)
+{
+	BroadPhaseParams params = {};
+	params.pairs = m_pairs.ptr();
+	params.numPairs = m_numPairs.ptr();
+	params.positions = this->positions();
+	params.radii = this->radii();
+	params.remap = m_buildInput.reorder ? m_spatialSort->permutation() : dev::Ptr<const unsigned int>(nullptr);
+	params.traversable = m_accelStruct->handle();
+	params.shape = m_buildInput.shape;
+	params.capacity = static_cast<unsigned int>(m_pairs.size());
+	params.radius = m_buildInput.radius;
+
+	stream.memcpy(m_params.data(), &params, 1);
+}
+
+
+BroadPhaseImpl::~BroadPhaseImpl()
+{
+
+}
\ No newline at end of file
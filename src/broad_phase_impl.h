@@ -0,0 +1,97 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "pipeline.h"
+#include "broad_phase.h"
+#include "accel_struct.h"
+#include "spatial_sort.h"
+#include "device_context.h"
+#include "broad_phase_params.h"
+#include <nucleus/array_1d.h>
+#include <vector>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	****************************    BroadPhaseImpl    ****************************
+	*****************************************************************************/
+
+	class BroadPhaseImpl : public BroadPhase
+	{
+
+	public:
+
+		BroadPhaseImpl(std::shared_ptr<DeviceContext> deviceContext);
+
+		virtual ~BroadPhaseImpl();
+
+	public:
+
+		virtual unsigned int numContacts() const override { return m_numContacts; }
+		virtual const BuildInput & buildInput() const override { return m_buildInput; }
+		virtual unsigned int capacity() const override { return static_cast<unsigned int>(m_pairs.size()); }
+		virtual std::shared_ptr<class DeviceContext> deviceContext() const override { return m_deviceContext; }
+		virtual void build(ns::Stream & stream, ns::AllocPtr allocator, const BuildInput & buildInput, unsigned int initialCapacity) override;
+		virtual dev::Ptr<const ContactPair> detect(ns::Stream & stream) override;
+		virtual void refit(ns::Stream & stream) override;
+
+	private:
+
+		void computeAabbs(ns::Stream & stream);
+
+		void uploadParams(ns::Stream & stream);
+
+		void gatherParticles(ns::Stream & stream);
+
+		//!	Particle buffers seen by the pipeline: sorted copies if `reorder`, otherwise the input.
+		dev::Ptr<const float> radii() const
+		{
+			return (m_buildInput.reorder && (m_buildInput.radii != nullptr)) ? dev::Ptr<const float>(m_sortedRadii.data(), m_sortedRadii.size()) : m_buildInput.radii;
+		}
+
+		dev::Ptr<const ns::float3_16a> positions() const
+		{
+			return m_buildInput.reorder ? dev::Ptr<const ns::float3_16a>(m_sortedPositions.data(), m_sortedPositions.size()) : m_buildInput.positions;
+		}
+
+	private:
+
+		BuildInput									m_buildInput;
+		unsigned int								m_numContacts;
+		ns::AllocPtr								m_allocator;
+		OptixShaderBindingTable						m_sbt;
+		ns::Array<Aabb>								m_aabbs;
+		ns::Array<float>							m_maxRadius;
+		ns::Array<ContactPair>						m_pairs;
+		ns::Array<float>							m_sortedRadii;
+		ns::Array<ns::float3_16a>					m_sortedPositions;
+		ns::Array<unsigned int>						m_numPairs;
+		ns::Array<BroadPhaseParams>					m_params;
+		ns::Array<EmptyRecord>						m_sbtRecords;
+		std::vector<std::shared_ptr<Program>>		m_programs;
+		std::unique_ptr<Pipeline>					m_pipeline;
+		std::unique_ptr<SpatialSort>				m_spatialSort;
+		std::unique_ptr<AccelStructAabb>			m_accelStruct;
+		const std::shared_ptr<DeviceContext>		m_deviceContext;
+	};
+}
\ No newline at end of file
@@ -21,9 +21,13 @@
  */
 
 #include "denoiser_impl.h"
+#include "profiler.h"
 #include <nucleus/Logger.h>
 #include <nucleus/Stream.h>
 #include <optix_stubs.h>
+#if OPTIX_VERSION >= 70300
+	#include <optix_denoiser_tiling.h>
+#endif
 
 PHOTON_USING_NAMESPACE
 
@@ -32,63 +36,123 @@ PHOTON_USING_NAMESPACE
 *********************************************************************************/
 
 DenoiserImpl::DenoiserImpl(std::shared_ptr<DeviceContext> deviceContext) : m_deviceContext(deviceContext), m_hDenoiser(nullptr),
-	m_eModelKind(ModelKind::Normal), m_maxInputWidth(0), m_maxInputHeight(0), m_inputWidth(0), m_inputHeight(0)
+	m_eModelKind(ModelKind::Normal), m_eGuideSet(GuideAlbedoNormal), m_maxInputWidth(0), m_maxInputHeight(0), m_inputWidth(0), m_inputHeight(0),
+	m_tileWidth(0), m_tileHeight(0), m_overlap(0), m_internalGuidePixelSize(0), m_internalGuideWidth(0), m_internalGuideHeight(0)
 {
 
 }
 
 
-void DenoiserImpl::launch(ns::Stream & stream, dev::Ptr2<Color4f> output, dev::Ptr2<const Color4f> input, dev::Ptr2<const Color4f> albedo, dev::Ptr2<const Color4f> normal,
-						  [[maybe_unused]] dev::Ptr2<const Color4f> previousOutput, [[maybe_unused]] dev::Ptr2<const ns::float2> flow, [[maybe_unused]] dev::Ptr2<const float> flowTrustworthiness, float blendFactor)
+//!	Describes a pitched device image for the OptiX denoiser.
+static OptixImage2D makeImage(const Denoiser::Image & image)
 {
-	NS_ASSERT((albedo.width() == input.width()) && (albedo.height() == input.height()));
-	NS_ASSERT((normal.width() == input.width()) && (normal.height() == input.height()));
-
-	OptixImage2D										inputImage = {};
-	inputImage.format									= OPTIX_PIXEL_FORMAT_FLOAT4;
-	inputImage.data										= (CUdeviceptr)input.data();
-	inputImage.width									= input.width();
-	inputImage.height									= input.height();
-	inputImage.rowStrideInBytes							= input.pitch();
-	inputImage.pixelStrideInBytes						= sizeof(Color4f);
-
-	OptixImage2D										outputImage = {};
-	outputImage.format									= OPTIX_PIXEL_FORMAT_FLOAT4;
-	outputImage.data									= (CUdeviceptr)output.data();
-	outputImage.width									= output.width();
-	outputImage.height									= output.height();
-	outputImage.rowStrideInBytes						= output.pitch();
-	outputImage.pixelStrideInBytes						= sizeof(Color4f);
+	OptixImage2D					optixImage = {};
+	optixImage.format				= image.format;
+	optixImage.data					= (CUdeviceptr)image.data;
+	optixImage.width				= image.width;
+	optixImage.height				= image.height;
+	optixImage.rowStrideInBytes		= image.rowStrideInBytes;
+	optixImage.pixelStrideInBytes	= image.pixelStrideInBytes;
+	return optixImage;
+}
+
+
+//!	Albedo and normal are read as RGB, RGBA images keep their pixel stride and only the 4th channel is skipped.
+static OptixImage2D makeGuideImage(const Denoiser::Image & image)
+{
+	OptixImage2D optixImage = makeImage(image);
+
+	//	OptiX only documents float and half guide layers.
+	NS_ASSERT((optixImage.format != OPTIX_PIXEL_FORMAT_UCHAR3) && (optixImage.format != OPTIX_PIXEL_FORMAT_UCHAR4));
+
+	switch (optixImage.format)
+	{
+		case OPTIX_PIXEL_FORMAT_FLOAT4:		optixImage.format = OPTIX_PIXEL_FORMAT_FLOAT3;		break;
+		case OPTIX_PIXEL_FORMAT_HALF4:		optixImage.format = OPTIX_PIXEL_FORMAT_HALF3;		break;
+		default:																				break;
+	}
+
+	return optixImage;
+}
+
 
-#if OPTIX_VERSION >= 70300
-	OptixDenoiserLayer									denoiserLayer = {};
 #if OPTIX_VERSION >= 70700
-	denoiserLayer.type									= OPTIX_DENOISER_AOV_TYPE_NONE;
+static OptixDenoiserAOVType toOptixAovType(Denoiser::AovType type)
+{
+	switch (type)
+	{
+		case Denoiser::AovBeauty:			return OPTIX_DENOISER_AOV_TYPE_BEAUTY;
+		case Denoiser::AovSpecular:			return OPTIX_DENOISER_AOV_TYPE_SPECULAR;
+		case Denoiser::AovReflection:		return OPTIX_DENOISER_AOV_TYPE_REFLECTION;
+		case Denoiser::AovRefraction:		return OPTIX_DENOISER_AOV_TYPE_REFRACTION;
+		case Denoiser::AovDiffuse:			return OPTIX_DENOISER_AOV_TYPE_DIFFUSE;
+		default:							return OPTIX_DENOISER_AOV_TYPE_NONE;
+	}
+}
 #endif
-	denoiserLayer.input									= inputImage;
-	denoiserLayer.output								= outputImage;
+
+
+void DenoiserImpl::launch(ns::Stream & stream, ns::ArrayProxy<Layer> layers, const GuideLayer & guideLayer, float blendFactor)
+{
+	NS_ASSERT(layers.size() > 0);
+
+	//	The first layer is the beauty layer: intensity and average color are computed from it, and shared by all AOVs.
+	const Layer & beauty = layers[0];
+	const unsigned int inputWidth = beauty.input.width;
+	const unsigned int inputHeight = beauty.input.height;
+
+	NS_ASSERT((m_eGuideSet < GuideAlbedo) || ((guideLayer.albedo.width == inputWidth) && (guideLayer.albedo.height == inputHeight)));
+	NS_ASSERT((m_eGuideSet < GuideAlbedoNormal) || ((guideLayer.normal.width == inputWidth) && (guideLayer.normal.height == inputHeight)));
+
+	const OptixImage2D inputImage = makeImage(beauty.input);
+
+#if OPTIX_VERSION >= 70300
+	m_denoiserLayers.resize(layers.size());
+
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		NS_ASSERT((layers[i].input.width == inputWidth) && (layers[i].input.height == inputHeight));
+
+		OptixDenoiserLayer & denoiserLayer = m_denoiserLayers[i];
+		denoiserLayer = {};
+	#if OPTIX_VERSION >= 70700
+		denoiserLayer.type = toOptixAovType(layers[i].type);
+	#endif
+		denoiserLayer.input = makeImage(layers[i].input);
+		denoiserLayer.output = makeImage(layers[i].output);
+	#if OPTIX_VERSION >= 70400
+		if (m_eModelKind & ModelKind::Temporal)
+		{
+			const Image & previousOutput = layers[i].previousOutput.empty() ? layers[i].input : layers[i].previousOutput;
+
+			denoiserLayer.previousOutput = makeImage(previousOutput);
+		}
+	#endif
+	}
 
 	OptixDenoiserGuideLayer								denoiserGuideLayer = {};
-	denoiserGuideLayer.albedo.format					= OPTIX_PIXEL_FORMAT_FLOAT3;
-	denoiserGuideLayer.albedo.data						= (CUdeviceptr)albedo.data();
-	denoiserGuideLayer.albedo.width						= albedo.width();
-	denoiserGuideLayer.albedo.height					= albedo.height();
-	denoiserGuideLayer.albedo.rowStrideInBytes			= albedo.pitch();
-	denoiserGuideLayer.albedo.pixelStrideInBytes		= sizeof(Color4f);
-	
-	denoiserGuideLayer.normal.format					= OPTIX_PIXEL_FORMAT_FLOAT3;
-	denoiserGuideLayer.normal.data						= (CUdeviceptr)normal.data();
-	denoiserGuideLayer.normal.width						= normal.width();
-	denoiserGuideLayer.normal.height					= normal.height();
-	denoiserGuideLayer.normal.rowStrideInBytes			= normal.pitch();
-	denoiserGuideLayer.normal.pixelStrideInBytes		= sizeof(Color4f);
+
+	//	Unused guides stay zero-initialized, they are neither read by the denoiser nor required from the caller.
+	if (m_eGuideSet >= GuideAlbedo)
+	{
+		denoiserGuideLayer.albedo = makeGuideImage(guideLayer.albedo);
+	}
+
+	if (m_eGuideSet >= GuideAlbedoNormal)
+	{
+		denoiserGuideLayer.normal = makeGuideImage(guideLayer.normal);
+	}
+#else
+	NS_ASSERT(layers.size() == 1);
+
+	const OptixImage2D outputImage = makeImage(beauty.output);
 #endif
 
 	OptixDenoiserParams									denoiserParams = {};
 	denoiserParams.blendFactor							= blendFactor;
 	denoiserParams.hdrIntensity							= (CUdeviceptr)m_intensityCache.data();
 #if OPTIX_VERSION >= 70500
-	denoiserParams.temporalModeUsePreviousLayers		= (m_eModelKind & ModelKind::Temporal) && !previousOutput.empty() && (previousOutput != input);
+	denoiserParams.temporalModeUsePreviousLayers		= (m_eModelKind & ModelKind::Temporal) && !beauty.previousOutput.empty() && (beauty.previousOutput != beauty.input);
 #endif
 #if (OPTIX_VERSION >= 70500) && (OPTIX_VERSION <= 70700)
 	denoiserParams.denoiseAlpha							= OPTIX_DENOISER_ALPHA_MODE_COPY;
@@ -102,45 +166,32 @@ void DenoiserImpl::launch(ns::Stream & stream, dev::Ptr2<Color4f> output, dev::P
 #if OPTIX_VERSION >= 70400
 	if (m_eModelKind & ModelKind::Temporal)
 	{
-		NS_ASSERT((flow.width() == input.width()) && (flow.height() == input.height()));
-
-		if (previousOutput.empty())													previousOutput = input;
-
-		denoiserLayer.previousOutput.format											= OPTIX_PIXEL_FORMAT_FLOAT4;
-		denoiserLayer.previousOutput.data											= (CUdeviceptr)previousOutput.data();
-		denoiserLayer.previousOutput.width											= previousOutput.width();
-		denoiserLayer.previousOutput.height											= previousOutput.height();
-		denoiserLayer.previousOutput.rowStrideInBytes								= previousOutput.pitch();
-		denoiserLayer.previousOutput.pixelStrideInBytes								= sizeof(Color4f);
-
-		denoiserGuideLayer.flow.format												= OPTIX_PIXEL_FORMAT_FLOAT2;
-		denoiserGuideLayer.flow.data												= (CUdeviceptr)flow.data();
-		denoiserGuideLayer.flow.width												= flow.width();
-		denoiserGuideLayer.flow.height												= flow.height();
-		denoiserGuideLayer.flow.rowStrideInBytes									= flow.pitch();
-		denoiserGuideLayer.flow.pixelStrideInBytes									= sizeof(ns::float2);
+		NS_ASSERT((guideLayer.flow.width == inputWidth) && (guideLayer.flow.height == inputHeight));
+
+		denoiserGuideLayer.flow															= makeImage(guideLayer.flow);
 	#if OPTIX_VERSION >= 70700
-		denoiserGuideLayer.flowTrustworthiness.format								= OPTIX_PIXEL_FORMAT_FLOAT1;
-		denoiserGuideLayer.flowTrustworthiness.data									= (CUdeviceptr)flowTrustworthiness.data();
-		denoiserGuideLayer.flowTrustworthiness.width								= flowTrustworthiness.width();
-		denoiserGuideLayer.flowTrustworthiness.height								= flowTrustworthiness.height();
-		denoiserGuideLayer.flowTrustworthiness.rowStrideInBytes						= flowTrustworthiness.pitch();
-		denoiserGuideLayer.flowTrustworthiness.pixelStrideInBytes					= sizeof(float);
+		denoiserGuideLayer.flowTrustworthiness											= makeImage(guideLayer.flowTrustworthiness);
 	#endif
 	#if OPTIX_VERSION >= 70500
+		//	In tiled mode the internal guide layers are not preallocated, they always cover the whole image.
+		if ((m_tileWidth != 0) && this->resizeInternalGuideLayers(inputWidth, inputHeight))
+		{
+			denoiserParams.temporalModeUsePreviousLayers = 0;
+		}
+
 		denoiserGuideLayer.previousOutputInternalGuideLayer.format					= OPTIX_PIXEL_FORMAT_INTERNAL_GUIDE_LAYER;
 		denoiserGuideLayer.previousOutputInternalGuideLayer.data					= (CUdeviceptr)m_internalGuideLayers[0].data();
-		denoiserGuideLayer.previousOutputInternalGuideLayer.width					= input.width();
-		denoiserGuideLayer.previousOutputInternalGuideLayer.height					= input.height();
+		denoiserGuideLayer.previousOutputInternalGuideLayer.width					= inputWidth;
+		denoiserGuideLayer.previousOutputInternalGuideLayer.height					= inputHeight;
 		denoiserGuideLayer.previousOutputInternalGuideLayer.rowStrideInBytes		= static_cast<uint32_t>(m_internalGuideLayers[0].pitch());
-		denoiserGuideLayer.previousOutputInternalGuideLayer.pixelStrideInBytes		= static_cast<uint32_t>(m_internalGuideLayers[0].pitch() / input.width());
+		denoiserGuideLayer.previousOutputInternalGuideLayer.pixelStrideInBytes		= static_cast<uint32_t>(m_internalGuidePixelSize);
 
 		denoiserGuideLayer.outputInternalGuideLayer.format							= OPTIX_PIXEL_FORMAT_INTERNAL_GUIDE_LAYER;
 		denoiserGuideLayer.outputInternalGuideLayer.data							= (CUdeviceptr)m_internalGuideLayers[1].data();
-		denoiserGuideLayer.outputInternalGuideLayer.width							= input.width();
-		denoiserGuideLayer.outputInternalGuideLayer.height							= input.height();
+		denoiserGuideLayer.outputInternalGuideLayer.width							= inputWidth;
+		denoiserGuideLayer.outputInternalGuideLayer.height							= inputHeight;
 		denoiserGuideLayer.outputInternalGuideLayer.rowStrideInBytes				= static_cast<uint32_t>(m_internalGuideLayers[1].pitch());
-		denoiserGuideLayer.outputInternalGuideLayer.pixelStrideInBytes				= static_cast<uint32_t>(m_internalGuideLayers[1].pitch() / input.width());
+		denoiserGuideLayer.outputInternalGuideLayer.pixelStrideInBytes				= static_cast<uint32_t>(m_internalGuidePixelSize);
 
 		if (!denoiserParams.temporalModeUsePreviousLayers)
 		{
@@ -151,22 +202,45 @@ void DenoiserImpl::launch(ns::Stream & stream, dev::Ptr2<Color4f> output, dev::P
 	#endif
 	}
 #endif
-	this->internalSetup(stream, input.width(), input.height());
+	this->setup(stream, inputWidth, inputHeight);
+
+	OptixResult eResult = OPTIX_SUCCESS;
+
+	{
+		Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixDenoiserComputeIntensity", this);
 
-	OptixResult eResult = optixDenoiserComputeIntensity(m_hDenoiser, stream.handle(), &inputImage,
-														(CUdeviceptr)m_intensityCache.data(), (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
+		eResult = optixDenoiserComputeIntensity(m_hDenoiser, stream.handle(), &inputImage,
+												(CUdeviceptr)m_intensityCache.data(), (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
+	}
 
 	if (eResult == OPTIX_SUCCESS)
 	{
 	#if OPTIX_VERSION >= 70200
-		eResult = optixDenoiserComputeAverageColor(m_hDenoiser, stream.handle(), &inputImage, (CUdeviceptr)m_avgColorCache.data(), (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
+		{
+			Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixDenoiserComputeAverageColor", this);
+
+			eResult = optixDenoiserComputeAverageColor(m_hDenoiser, stream.handle(), &inputImage, (CUdeviceptr)m_avgColorCache.data(), (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
+		}
 	#endif
 
 		if (eResult == OPTIX_SUCCESS)
 		{
+			Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixDenoiserInvoke", this);
+
 		#if OPTIX_VERSION >= 70300
-			eResult = optixDenoiserInvoke(m_hDenoiser, stream.handle(), &denoiserParams, (CUdeviceptr)m_stateCache.data(), m_stateCache.bytes(),
-										  &denoiserGuideLayer, &denoiserLayer, 1, 0, 0, (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
+			const unsigned int numLayers = static_cast<unsigned int>(m_denoiserLayers.size());
+
+			if (m_tileWidth != 0)
+			{
+				eResult = optixUtilDenoiserInvokeTiled(m_hDenoiser, stream.handle(), &denoiserParams, (CUdeviceptr)m_stateCache.data(), m_stateCache.bytes(),
+													   &denoiserGuideLayer, m_denoiserLayers.data(), numLayers, (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes(),
+													   m_overlap, m_tileWidth, m_tileHeight);
+			}
+			else
+			{
+				eResult = optixDenoiserInvoke(m_hDenoiser, stream.handle(), &denoiserParams, (CUdeviceptr)m_stateCache.data(), m_stateCache.bytes(),
+											  &denoiserGuideLayer, m_denoiserLayers.data(), numLayers, 0, 0, (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
+			}
 		#else
 			eResult = optixDenoiserInvoke(m_hDenoiser, stream.handle(), &denoiserParams, (CUdeviceptr)m_stateCache.data(), m_stateCache.bytes(),
 										  &inputImage, 1, 0, 0, &outputImage,(CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
@@ -183,7 +257,33 @@ void DenoiserImpl::launch(ns::Stream & stream, dev::Ptr2<Color4f> output, dev::P
 }
 
 
-void DenoiserImpl::preallocate(ns::AllocPtr pAlloc, ModelKind eModeKind, unsigned int maxInputWidth, unsigned int maxInputHeight)
+void DenoiserImpl::preallocate(ns::AllocPtr pAlloc, ModelKind eModeKind, unsigned int maxInputWidth, unsigned int maxInputHeight, GuideSet eGuideSet)
+{
+	if ((m_maxInputWidth != maxInputWidth) || (m_maxInputHeight != maxInputHeight) || (m_eModelKind != eModeKind) || (m_eGuideSet != eGuideSet) || (m_tileWidth != 0))
+	{
+		this->createDenoiser(pAlloc, eModeKind, eGuideSet, maxInputWidth, maxInputHeight, false);
+	}
+}
+
+
+void DenoiserImpl::preallocateTiled(ns::AllocPtr pAlloc, ModelKind eModeKind, unsigned int tileWidth, unsigned int tileHeight, GuideSet eGuideSet)
+{
+#if OPTIX_VERSION >= 70300
+	NS_ASSERT((tileWidth != 0) && (tileHeight != 0));
+
+	if ((m_tileWidth != tileWidth) || (m_tileHeight != tileHeight) || (m_eModelKind != eModeKind) || (m_eGuideSet != eGuideSet))
+	{
+		this->createDenoiser(pAlloc, eModeKind, eGuideSet, tileWidth, tileHeight, true);
+	}
+#else
+	NS_ERROR_LOG("Tiled denoising requires Optix 7.3 or newer.");
+
+	throw OPTIX_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+
+void DenoiserImpl::createDenoiser(ns::AllocPtr pAlloc, ModelKind eModeKind, GuideSet eGuideSet, unsigned int width, unsigned int height, bool tiled)
 {
 #if OPTIX_VERSION >= 70200
 	OptixDenoiserModelKind							denoiserModelKind = OPTIX_DENOISER_MODEL_KIND_AOV;
@@ -201,77 +301,110 @@ void DenoiserImpl::preallocate(ns::AllocPtr pAlloc, ModelKind eModeKind, unsigne
 #endif
 	else											{ NS_ASSERT(false); }
 
-	if ((m_maxInputWidth != maxInputWidth) || (m_maxInputHeight != maxInputHeight) || (m_eModelKind != eModeKind))
+	this->release();
+
+	OptixDenoiser						hDenoiser = nullptr;
+	OptixDenoiserOptions				denoiserOptions = {};
+#if OPTIX_VERSION >= 70300
+	denoiserOptions.guideAlbedo			= (eGuideSet >= GuideAlbedo) ? 1 : 0;
+	denoiserOptions.guideNormal			= (eGuideSet >= GuideAlbedoNormal) ? 1 : 0;
+#else
+	denoiserOptions.inputKind			= (eGuideSet == GuideNone) ? OPTIX_DENOISER_INPUT_RGB : ((eGuideSet == GuideAlbedo) ? OPTIX_DENOISER_INPUT_RGB_ALBEDO : OPTIX_DENOISER_INPUT_RGB_ALBEDO_NORMAL);
+#endif
+#if OPTIX_VERSION >= 80000
+	denoiserOptions.denoiseAlpha		= OPTIX_DENOISER_ALPHA_MODE_COPY;
+#endif
+
+#if OPTIX_VERSION >= 70300
+	OptixResult eResult = optixDenoiserCreate(m_deviceContext->handle(), denoiserModelKind, &denoiserOptions, &hDenoiser);
+#else
+	OptixResult eResult = optixDenoiserCreate(m_deviceContext->handle(), &denoiserOptions, &hDenoiser);
+#endif
+
+	if (eResult == OPTIX_SUCCESS)
 	{
-		this->release();
-
-		OptixDenoiser						hDenoiser = nullptr;
-		OptixDenoiserOptions				denoiserOptions = {};
-	#if OPTIX_VERSION >= 70300
-		denoiserOptions.guideAlbedo			= 1;
-		denoiserOptions.guideNormal			= 1;
-	#else
-		denoiserOptions.inputKind			= OPTIX_DENOISER_INPUT_RGB_ALBEDO_NORMAL;
-	#endif
-	#if OPTIX_VERSION >= 80000
-		denoiserOptions.denoiseAlpha		= OPTIX_DENOISER_ALPHA_MODE_COPY;
-	#endif
+		OptixDenoiserSizes cacheSizes = {};
 
-	#if OPTIX_VERSION >= 70300
-		OptixResult eResult = optixDenoiserCreate(m_deviceContext->handle(), denoiserModelKind, &denoiserOptions, &hDenoiser);
-	#else
-		OptixResult eResult = optixDenoiserCreate(m_deviceContext->handle(), &denoiserOptions, &hDenoiser);
-	#endif
+		eResult = optixDenoiserComputeMemoryResources(hDenoiser, width, height, &cacheSizes);
 
-		if (eResult == OPTIX_SUCCESS)
+		if (eResult != OPTIX_SUCCESS)
 		{
-			OptixDenoiserSizes cacheSizes = {};
-
-			eResult = optixDenoiserComputeMemoryResources(hDenoiser, maxInputWidth, maxInputHeight, &cacheSizes);
+			eResult = optixDenoiserDestroy(hDenoiser);
+		}
+		else
+		{
+		#if OPTIX_VERSION >= 70100
+			m_scratchCache.resize(pAlloc, tiled ? cacheSizes.withOverlapScratchSizeInBytes : cacheSizes.withoutOverlapScratchSizeInBytes);
+			m_overlap = tiled ? cacheSizes.overlapWindowSizeInPixels : 0;
+		#else
+			m_scratchCache.resize(pAlloc, cacheSizes.recommendedScratchSizeInBytes);
+		#endif
+		#if OPTIX_VERSION >= 70500
+			m_internalGuidePixelSize = cacheSizes.internalGuideLayerPixelSizeInBytes;
 
-			if (eResult != OPTIX_SUCCESS)
+			if (!tiled)
 			{
-				eResult = optixDenoiserDestroy(hDenoiser);
-			}
-			else
-			{
-			#if OPTIX_VERSION >= 70100
-				m_scratchCache.resize(pAlloc, cacheSizes.withoutOverlapScratchSizeInBytes);
-			#else
-				m_scratchCache.resize(pAlloc, cacheSizes.recommendedScratchSizeInBytes);
-			#endif
-			#if OPTIX_VERSION >= 70500
-				m_internalGuideLayers[0].resize(pAlloc, cacheSizes.internalGuideLayerPixelSizeInBytes * maxInputWidth, maxInputHeight);
-				m_internalGuideLayers[1].resize(pAlloc, cacheSizes.internalGuideLayerPixelSizeInBytes * maxInputWidth, maxInputHeight);
-				m_avgColorCache.resize(pAlloc, cacheSizes.computeAverageColorSizeInBytes);
-				m_intensityCache.resize(pAlloc, cacheSizes.computeIntensitySizeInBytes);
-			#endif
-				m_stateCache.resize(pAlloc, cacheSizes.stateSizeInBytes);
-				m_maxInputHeight = maxInputHeight;
-				m_maxInputWidth = maxInputWidth;
-				m_eModelKind = eModeKind;
-				m_hDenoiser = hDenoiser;
-				m_inputHeight = 0;
-				m_inputWidth = 0;
+				m_internalGuideLayers[0].resize(pAlloc, cacheSizes.internalGuideLayerPixelSizeInBytes * width, height);
+				m_internalGuideLayers[1].resize(pAlloc, cacheSizes.internalGuideLayerPixelSizeInBytes * width, height);
+				m_internalGuideHeight = height;
+				m_internalGuideWidth = width;
 			}
+
+			m_avgColorCache.resize(pAlloc, cacheSizes.computeAverageColorSizeInBytes);
+			m_intensityCache.resize(pAlloc, cacheSizes.computeIntensitySizeInBytes);
+		#endif
+			m_stateCache.resize(pAlloc, cacheSizes.stateSizeInBytes);
+			m_maxInputHeight = tiled ? 0 : height;
+			m_maxInputWidth = tiled ? 0 : width;
+			m_tileHeight = tiled ? height : 0;
+			m_tileWidth = tiled ? width : 0;
+			m_allocator = pAlloc;
+			m_eModelKind = eModeKind;
+			m_eGuideSet = eGuideSet;
+			m_hDenoiser = hDenoiser;
+			m_inputHeight = 0;
+			m_inputWidth = 0;
 		}
+	}
 
-		if (eResult != OPTIX_SUCCESS)
-		{
-			NS_ERROR_LOG("%s.", optixGetErrorString(eResult));
+	if (eResult != OPTIX_SUCCESS)
+	{
+		NS_ERROR_LOG("%s.", optixGetErrorString(eResult));
 
-			throw eResult;
-		}
+		throw eResult;
+	}
+}
+
+
+size_t DenoiserImpl::memoryUsage() const
+{
+	return m_stateCache.bytes() + m_scratchCache.bytes() + m_avgColorCache.bytes() + m_intensityCache.bytes() + m_internalGuideLayers[0].bytes() + m_internalGuideLayers[1].bytes();
+}
+
+
+void DenoiserImpl::setup(ns::Stream & stream, unsigned int inputWidth, unsigned int inputHeight)
+{
+	if (m_tileWidth != 0)
+	{
+		this->internalSetup(stream, m_tileWidth + 2 * m_overlap, m_tileHeight + 2 * m_overlap);
+	}
+	else
+	{
+		this->internalSetup(stream, inputWidth, inputHeight);
 	}
 }
 
 
 void DenoiserImpl::internalSetup(ns::Stream & stream, unsigned int inputWidth, unsigned int inputHeight)
 {
-	NS_ASSERT((inputWidth <= m_maxInputWidth) && (inputHeight <= m_maxInputHeight));
+	NS_ASSERT((m_tileWidth != 0) || ((inputWidth <= m_maxInputWidth) && (inputHeight <= m_maxInputHeight)));
 
-	if ((m_hDenoiser != nullptr) && ((m_inputWidth != inputWidth) || (m_inputHeight != inputHeight)))
+	//	The state set up for a size is valid for any smaller input, so smaller images do not rerun the setup.
+	if ((m_hDenoiser != nullptr) && ((m_inputWidth < inputWidth) || (m_inputHeight < inputHeight)))
 	{
+		inputWidth = NS_MAX(inputWidth, m_inputWidth);
+		inputHeight = NS_MAX(inputHeight, m_inputHeight);
+
 		OptixResult eResult = optixDenoiserSetup(m_hDenoiser, stream.handle(), inputWidth, inputHeight, (CUdeviceptr)m_stateCache.data(),
 												 m_stateCache.bytes(), (CUdeviceptr)m_scratchCache.data(), m_scratchCache.bytes());
 
@@ -288,6 +421,22 @@ void DenoiserImpl::internalSetup(ns::Stream & stream, unsigned int inputWidth, u
 }
 
 
+bool DenoiserImpl::resizeInternalGuideLayers(unsigned int inputWidth, unsigned int inputHeight)
+{
+	if ((m_internalGuideWidth == inputWidth) && (m_internalGuideHeight == inputHeight))
+	{
+		return false;
+	}
+
+	m_internalGuideLayers[0].resize(m_allocator, m_internalGuidePixelSize * inputWidth, inputHeight);
+	m_internalGuideLayers[1].resize(m_allocator, m_internalGuidePixelSize * inputWidth, inputHeight);
+	m_internalGuideHeight = inputHeight;
+	m_internalGuideWidth = inputWidth;
+
+	return true;
+}
+
+
 void DenoiserImpl::release()
 {
 	if (m_hDenoiser != nullptr)
@@ -303,7 +452,11 @@ void DenoiserImpl::release()
 		m_internalGuideLayers[0].clear();
 		m_internalGuideLayers[1].clear();
 		m_eModelKind = ModelKind::Normal;
+		m_eGuideSet = GuideAlbedoNormal;
 		m_maxInputWidth = m_maxInputHeight = 0;
+		m_tileWidth = m_tileHeight = m_overlap = 0;
+		m_internalGuideWidth = m_internalGuideHeight = 0;
+		m_allocator = nullptr;
 		m_inputWidth = m_inputHeight = 0;
 		m_hDenoiser = nullptr;
 	}
@@ -25,6 +25,7 @@
 #include "device_context.h"
 #include <nucleus/array_1d.h>
 #include <nucleus/array_2d.h>
+#include <vector>
 
 namespace PHOTON_NAMESPACE
 {
@@ -45,25 +46,44 @@ namespace PHOTON_NAMESPACE
 
 		virtual void release() override;
 		virtual ModelKind modelKind() const override { return m_eModelKind; }
+		virtual GuideSet guideSet() const override { return m_eGuideSet; }
 		virtual unsigned int maxInputWidth() const override { return m_maxInputWidth; }
 		virtual unsigned int maxInputHeight() const override { return m_maxInputHeight; }
+		virtual unsigned int tileWidth() const override { return m_tileWidth; }
+		virtual unsigned int tileHeight() const override { return m_tileHeight; }
+		virtual size_t memoryUsage() const override;
 		virtual std::shared_ptr<class DeviceContext> deviceContext() override { return m_deviceContext; }
 		virtual void nextFrame() override { m_internalGuideLayers[0].swap(m_internalGuideLayers[1]); }
-		virtual void preallocate(ns::AllocPtr pAlloc, ModelKind eModeKind, unsigned int maxInputWidth, unsigned int maxInputHeight) override;
-		virtual void launch(ns::Stream & stream, dev::Ptr2<Color4f> output, dev::Ptr2<const Color4f> input, dev::Ptr2<const Color4f> albedo, dev::Ptr2<const Color4f> normal,
-							dev::Ptr2<const Color4f> previousOutput, dev::Ptr2<const ns::float2> flow, dev::Ptr2<const float> flowTrustworthiness, float blendFactor) override;
+		virtual void preallocate(ns::AllocPtr pAlloc, ModelKind eModeKind, unsigned int maxInputWidth, unsigned int maxInputHeight, GuideSet eGuideSet) override;
+		virtual void preallocateTiled(ns::AllocPtr pAlloc, ModelKind eModeKind, unsigned int tileWidth, unsigned int tileHeight, GuideSet eGuideSet) override;
+		virtual void setup(ns::Stream & stream, unsigned int inputWidth, unsigned int inputHeight) override;
+		virtual void launch(ns::Stream & stream, ns::ArrayProxy<Layer> layers, const GuideLayer & guideLayer, float blendFactor) override;
+
+		using Denoiser::launch;
 
 	protected:
 
+		void createDenoiser(ns::AllocPtr pAlloc, ModelKind eModeKind, GuideSet eGuideSet, unsigned int width, unsigned int height, bool tiled);
+
 		void internalSetup(ns::Stream & stream, unsigned int inputWidth, unsigned int inputHeight);
 
+		bool resizeInternalGuideLayers(unsigned int inputWidth, unsigned int inputHeight);
+
 	protected:
 
 		ModelKind									m_eModelKind;
+		GuideSet									m_eGuideSet;
 		unsigned int								m_inputWidth;
 		unsigned int								m_inputHeight;
 		unsigned int								m_maxInputWidth;
 		unsigned int								m_maxInputHeight;
+		unsigned int								m_tileWidth;
+		unsigned int								m_tileHeight;
+		unsigned int								m_overlap;
+		size_t										m_internalGuidePixelSize;
+		unsigned int								m_internalGuideWidth;
+		unsigned int								m_internalGuideHeight;
+		ns::AllocPtr								m_allocator;
 		unsigned int								m_currInternalGuideLayer;
 		OptixDenoiser								m_hDenoiser;
 		ns::Array<unsigned char>					m_stateCache;
@@ -71,6 +91,9 @@ namespace PHOTON_NAMESPACE
 		ns::Array<unsigned char>					m_avgColorCache;
 		ns::Array<unsigned char>					m_intensityCache;
 		ns::Array2D<unsigned char>					m_internalGuideLayers[2];
+	#if OPTIX_VERSION >= 70300
+		std::vector<OptixDenoiserLayer>				m_denoiserLayers;
+	#endif
 		const std::shared_ptr<DeviceContext>		m_deviceContext;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,281 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "denoiser_pool_impl.h"
+#include <nucleus/logger.h>
+#include <nucleus/stream.h>
+#include <algorithm>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+*****************************    DenoiserPoolImpl    *****************************
+*********************************************************************************/
+
+DenoiserPoolImpl::DenoiserPoolImpl(std::shared_ptr<DeviceContext> deviceContext, ns::AllocPtr pAlloc, size_t memoryBudget, unsigned int resolutionBucket)
+	: m_allocator(pAlloc), m_resolutionBucket(NS_MAX(resolutionBucket, 1u)), m_memoryBudget(memoryBudget), m_memoryUsage(0), m_useCounter(0), m_deviceContext(deviceContext)
+{
+
+}
+
+
+DenoiserPool::Lease DenoiserPoolImpl::acquire(ns::Stream & stream, Denoiser::ModelKind modelKind, unsigned int inputWidth, unsigned int inputHeight, Denoiser::GuideSet guideSet)
+{
+	const unsigned int bucketWidth = ns::align_up(NS_MAX(inputWidth, 1u), m_resolutionBucket);
+	const unsigned int bucketHeight = ns::align_up(NS_MAX(inputHeight, 1u), m_resolutionBucket);
+
+	//	Declared before the lock: evicted entries wait for their last lease after it is released.
+	std::vector<std::unique_ptr<Entry>> evicted;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	//	Prefer a denoiser last used on the same stream: its previous work is already ordered before the new one.
+	Entry * candidate = nullptr;
+
+	for (auto & entry : m_entries)
+	{
+		if (!entry->leased && (entry->modelKind == modelKind) && (entry->guideSet == guideSet) && (entry->bucketWidth == bucketWidth) && (entry->bucketHeight == bucketHeight))
+		{
+			if (entry->stream == stream.handle())
+			{
+				candidate = entry.get();
+
+				break;
+			}
+			else if (candidate == nullptr)
+			{
+				candidate = entry.get();
+			}
+		}
+	}
+
+	if (candidate != nullptr)
+	{
+		if (candidate->stream != stream.handle())
+		{
+			cudaError_t err = cudaStreamWaitEvent(stream.handle(), candidate->event, 0);
+
+			NS_ERROR_LOG_IF(err != cudaSuccess, "%s.", cudaGetErrorString(err));
+
+			candidate->stream = stream.handle();
+		}
+
+		candidate->lastUse = ++m_useCounter;
+		candidate->leased = true;
+
+		return Lease(this, candidate->denoiser.get());
+	}
+
+	auto entry = std::make_unique<Entry>();
+	entry->denoiser = m_deviceContext->createDenoiser();
+	entry->modelKind = modelKind;
+	entry->guideSet = guideSet;
+	entry->bucketWidth = bucketWidth;
+	entry->bucketHeight = bucketHeight;
+	entry->stream = stream.handle();
+	entry->event = nullptr;
+	entry->lastUse = ++m_useCounter;
+	entry->bytes = 0;
+	entry->leased = true;
+
+	cudaError_t err = cudaEventCreateWithFlags(&entry->event, cudaEventDisableTiming);
+
+	if (err != cudaSuccess)
+	{
+		NS_ERROR_LOG("%s.", cudaGetErrorString(err));
+
+		throw OPTIX_ERROR_CUDA_ERROR;
+	}
+
+	//	Creating the denoiser and its state is slow, the other streams can keep on acquiring meanwhile.
+	Entry * newEntry = entry.get();
+
+	m_entries.push_back(std::move(entry));
+
+	lock.unlock();
+
+	try
+	{
+		newEntry->denoiser->preallocate(m_allocator, modelKind, bucketWidth, bucketHeight, guideSet);
+
+		//	Set up for the whole bucket, so that no later lease of this entry pays for the setup.
+		newEntry->denoiser->setup(stream, bucketWidth, bucketHeight);
+	}
+	catch (...)
+	{
+		lock.lock();
+
+		newEntry->leased = false;
+
+		evicted.push_back(this->detach(std::find_if(m_entries.begin(), m_entries.end(), [=](const auto & e) { return e.get() == newEntry; }) - m_entries.begin()));
+
+		throw;
+	}
+
+	lock.lock();
+
+	newEntry->bytes = newEntry->denoiser->memoryUsage();
+
+	m_memoryUsage += newEntry->bytes;
+
+	this->evict(m_memoryBudget, evicted);
+
+	return Lease(this, newEntry->denoiser.get());
+}
+
+
+void DenoiserPoolImpl::recycle(Denoiser * denoiser)
+{
+	std::vector<std::unique_ptr<Entry>> evicted;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto & entry : m_entries)
+	{
+		if (entry->denoiser.get() == denoiser)
+		{
+			NS_ASSERT(entry->leased);
+
+			cudaError_t err = cudaEventRecord(entry->event, entry->stream);
+
+			NS_ERROR_LOG_IF(err != cudaSuccess, "%s.", cudaGetErrorString(err));
+
+			entry->lastUse = ++m_useCounter;
+			entry->leased = false;
+
+			break;
+		}
+	}
+
+	this->evict(m_memoryBudget, evicted);
+}
+
+
+void DenoiserPoolImpl::evict(size_t memoryBudget, std::vector<std::unique_ptr<Entry>> & evicted)
+{
+	while (m_memoryUsage > memoryBudget)
+	{
+		size_t lruIndex = m_entries.size();
+
+		for (size_t i = 0; i < m_entries.size(); i++)
+		{
+			if (!m_entries[i]->leased && ((lruIndex == m_entries.size()) || (m_entries[i]->lastUse < m_entries[lruIndex]->lastUse)))
+			{
+				lruIndex = i;
+			}
+		}
+
+		if (lruIndex == m_entries.size())
+		{
+			break;
+		}
+
+		evicted.push_back(this->detach(lruIndex));
+	}
+}
+
+
+std::unique_ptr<DenoiserPoolImpl::Entry> DenoiserPoolImpl::detach(size_t index)
+{
+	std::unique_ptr<Entry> entry = std::move(m_entries[index]);
+
+	NS_ASSERT(!entry->leased);
+
+	m_memoryUsage -= entry->bytes;
+
+	m_entries.erase(m_entries.begin() + index);
+
+	return entry;
+}
+
+
+DenoiserPoolImpl::Entry::~Entry()
+{
+	//	The memory is freed right away, the last invocation on the stream must be completed first.
+	if (event != nullptr)
+	{
+		cudaError_t err = cudaEventSynchronize(event);
+
+		NS_ERROR_LOG_IF(err != cudaSuccess, "%s.", cudaGetErrorString(err));
+
+		cudaEventDestroy(event);
+	}
+}
+
+
+void DenoiserPoolImpl::setMemoryBudget(size_t bytes)
+{
+	std::vector<std::unique_ptr<Entry>> evicted;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_memoryBudget = bytes;
+
+	this->evict(m_memoryBudget, evicted);
+}
+
+
+size_t DenoiserPoolImpl::memoryBudget() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_memoryBudget;
+}
+
+
+size_t DenoiserPoolImpl::memoryUsage() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_memoryUsage;
+}
+
+
+size_t DenoiserPoolImpl::numDenoisers() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_entries.size();
+}
+
+
+void DenoiserPoolImpl::trim()
+{
+	std::vector<std::unique_ptr<Entry>> evicted;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	this->evict(0, evicted);
+}
+
+
+DenoiserPoolImpl::~DenoiserPoolImpl()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	NS_ERROR_LOG_IF(std::any_of(m_entries.begin(), m_entries.end(), [](const auto & e) { return e->leased; }), "Denoiser pool destroyed with active leases!");
+
+	//	No other thread may use the pool anymore, entries wait for their last lease while the lock is held.
+	m_entries.clear();
+
+	m_memoryUsage = 0;
+}
\ No newline at end of file
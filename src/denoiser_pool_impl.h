@@ -0,0 +1,96 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "denoiser_pool.h"
+#include "device_context.h"
+#include <cuda_runtime.h>
+#include <vector>
+#include <mutex>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	***************************    DenoiserPoolImpl    ***************************
+	*****************************************************************************/
+
+	class DenoiserPoolImpl : public DenoiserPool
+	{
+
+	public:
+
+		DenoiserPoolImpl(std::shared_ptr<DeviceContext> deviceContext, ns::AllocPtr pAlloc, size_t memoryBudget, unsigned int resolutionBucket);
+
+		virtual ~DenoiserPoolImpl();
+
+	public:
+
+		virtual Lease acquire(ns::Stream & stream, Denoiser::ModelKind modelKind, unsigned int inputWidth, unsigned int inputHeight, Denoiser::GuideSet guideSet) override;
+		virtual void setMemoryBudget(size_t bytes) override;
+		virtual size_t memoryBudget() const override;
+		virtual size_t memoryUsage() const override;
+		virtual size_t numDenoisers() const override;
+		virtual void trim() override;
+		virtual std::shared_ptr<class DeviceContext> deviceContext() override { return m_deviceContext; }
+
+	protected:
+
+		virtual void recycle(Denoiser * denoiser) override;
+
+	private:
+
+		//!	A pooled denoiser and the stream it was last leased on.
+		struct Entry
+		{
+			//!	Wait for the last lease before the denoiser memory is freed.
+			~Entry();
+
+			std::unique_ptr<Denoiser>		denoiser;
+			Denoiser::ModelKind				modelKind;
+			Denoiser::GuideSet				guideSet;
+			unsigned int					bucketWidth;
+			unsigned int					bucketHeight;
+			cudaStream_t					stream;				//!	Stream of the last lease.
+			cudaEvent_t						event;				//!	Recorded on `stream` when the last lease ended.
+			uint64_t						lastUse;
+			size_t							bytes;
+			bool							leased;
+		};
+
+		//!	Detach idle entries in LRU order until the memory usage fits the budget (lock must be held).
+		void evict(size_t memoryBudget, std::vector<std::unique_ptr<Entry>> & evicted);
+
+		//!	Remove the entry at `index` from the pool (lock must be held), it is destroyed by the caller once unlocked.
+		std::unique_ptr<Entry> detach(size_t index);
+
+	private:
+
+		mutable std::mutex							m_mutex;
+		ns::AllocPtr								m_allocator;
+		std::vector<std::unique_ptr<Entry>>			m_entries;
+		const unsigned int							m_resolutionBucket;
+		size_t										m_memoryBudget;
+		size_t										m_memoryUsage;
+		uint64_t									m_useCounter;
+		const std::shared_ptr<DeviceContext>		m_deviceContext;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "denoiser_utils.h"
+#include <nucleus/logger.h>
+#include <nucleus/stream.h>
+#include <nucleus/launch_utils.cuh>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+namespace kernels
+{
+	__device__ __forceinline__ unsigned char * PixelAddress(const Denoiser::Image & image, unsigned int x, unsigned int y)
+	{
+		return (unsigned char*)image.data + size_t(y) * image.rowStrideInBytes + size_t(x) * image.pixelStrideInBytes;
+	}
+
+
+	//!	Load a pixel of any 3 or 4-channel format as linear RGBA (alpha is 1 for 3-channel formats).
+	__device__ __forceinline__ ns::float4 LoadPixel(const Denoiser::Image & image, unsigned int x, unsigned int y)
+	{
+		const unsigned char * address = PixelAddress(image, x, y);
+
+		switch (image.format)
+		{
+			case OPTIX_PIXEL_FORMAT_FLOAT4:
+			{
+				const float * p = reinterpret_cast<const float*>(address);
+
+				return ns::float4{ p[0], p[1], p[2], p[3] };
+			}
+			case OPTIX_PIXEL_FORMAT_FLOAT3:
+			{
+				const float * p = reinterpret_cast<const float*>(address);
+
+				return ns::float4{ p[0], p[1], p[2], 1.0f };
+			}
+			case OPTIX_PIXEL_FORMAT_HALF4:
+			{
+				const unsigned short * p = reinterpret_cast<const unsigned short*>(address);
+
+				return ns::float4{ details::halfToFloat(p[0]), details::halfToFloat(p[1]), details::halfToFloat(p[2]), details::halfToFloat(p[3]) };
+			}
+			case OPTIX_PIXEL_FORMAT_HALF3:
+			{
+				const unsigned short * p = reinterpret_cast<const unsigned short*>(address);
+
+				return ns::float4{ details::halfToFloat(p[0]), details::halfToFloat(p[1]), details::halfToFloat(p[2]), 1.0f };
+			}
+			case OPTIX_PIXEL_FORMAT_UCHAR4:
+			{
+				return ns::float4{ address[0] / 255.0f, address[1] / 255.0f, address[2] / 255.0f, address[3] / 255.0f };
+			}
+			default:
+			{
+				return ns::float4{ 0.0f, 0.0f, 0.0f, 1.0f };
+			}
+		}
+	}
+
+
+	__device__ __forceinline__ void StorePixel(const Denoiser::Image & image, unsigned int x, unsigned int y, ns::float4 value)
+	{
+		unsigned char * address = PixelAddress(image, x, y);
+
+		switch (image.format)
+		{
+			case OPTIX_PIXEL_FORMAT_FLOAT4:
+			{
+				*reinterpret_cast<ns::float4*>(address) = value;
+				break;
+			}
+			case OPTIX_PIXEL_FORMAT_FLOAT3:
+			{
+				float * p = reinterpret_cast<float*>(address);
+				p[0] = value.x;		p[1] = value.y;		p[2] = value.z;
+				break;
+			}
+			case OPTIX_PIXEL_FORMAT_HALF4:
+			{
+				unsigned short * p = reinterpret_cast<unsigned short*>(address);
+				p[0] = details::floatToHalf(value.x);		p[1] = details::floatToHalf(value.y);
+				p[2] = details::floatToHalf(value.z);		p[3] = details::floatToHalf(value.w);
+				break;
+			}
+			case OPTIX_PIXEL_FORMAT_HALF3:
+			{
+				unsigned short * p = reinterpret_cast<unsigned short*>(address);
+				p[0] = details::floatToHalf(value.x);		p[1] = details::floatToHalf(value.y);		p[2] = details::floatToHalf(value.z);
+				break;
+			}
+			case OPTIX_PIXEL_FORMAT_UCHAR4:
+			{
+				*reinterpret_cast<Color4ub*>(address) = Color4ub{ details::toUnorm8(value.x), details::toUnorm8(value.y), details::toUnorm8(value.z), details::toUnorm8(value.w) };
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+	}
+
+
+	__global__ void PrepareDenoiserInputs(Denoiser::Image input, Denoiser::Image albedo, Denoiser::Image normal, DenoiserGuideSource source, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		const unsigned int x = i % source.color.width;
+		const unsigned int y = i / source.color.width;
+
+		StorePixel(input, x, y, LoadPixel(source.color, x, y));
+
+		if (!source.albedo.empty())
+		{
+			StorePixel(albedo, x, y, LoadPixel(source.albedo, x, y));
+		}
+
+		if (!source.normal.empty())
+		{
+			ns::float4 n = LoadPixel(source.normal, x, y);
+
+			if (source.transformNormals)
+			{
+				const ns::float4 * rows = source.worldToCamera.rows;
+
+				ns::float4 m;
+				m.x = rows[0].x * n.x + rows[0].y * n.y + rows[0].z * n.z;
+				m.y = rows[1].x * n.x + rows[1].y * n.y + rows[1].z * n.z;
+				m.z = rows[2].x * n.x + rows[2].y * n.y + rows[2].z * n.z;
+				m.w = n.w;
+
+				const float length = sqrtf(m.x * m.x + m.y * m.y + m.z * m.z);
+				const float invLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+
+				n = ns::float4{ m.x * invLength, m.y * invLength, m.z * invLength, m.w };
+			}
+
+			StorePixel(normal, x, y, n);
+		}
+	}
+
+
+	__global__ void TonemapDenoiserOutput(Denoiser::Image output, Denoiser::Image input, TonemapParams params, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		const unsigned int x = i % output.width;
+		const unsigned int y = i / output.width;
+
+		ns::float4 color;
+
+		if (params.downsample2x)
+		{
+			const ns::float4 c00 = LoadPixel(input, 2 * x + 0, 2 * y + 0);
+			const ns::float4 c10 = LoadPixel(input, 2 * x + 1, 2 * y + 0);
+			const ns::float4 c01 = LoadPixel(input, 2 * x + 0, 2 * y + 1);
+			const ns::float4 c11 = LoadPixel(input, 2 * x + 1, 2 * y + 1);
+
+			color.x = 0.25f * (c00.x + c10.x + c01.x + c11.x);
+			color.y = 0.25f * (c00.y + c10.y + c01.y + c11.y);
+			color.z = 0.25f * (c00.z + c10.z + c01.z + c11.z);
+			color.w = 0.25f * (c00.w + c10.w + c01.w + c11.w);
+		}
+		else
+		{
+			color = LoadPixel(input, x, y);
+		}
+
+		color.x = details::tonemap(color.x * params.exposure, params.tonemapOperator);
+		color.y = details::tonemap(color.y * params.exposure, params.tonemapOperator);
+		color.z = details::tonemap(color.z * params.exposure, params.tonemapOperator);
+
+		if (params.srgb)
+		{
+			color.x = details::linearToSrgb(color.x);
+			color.y = details::linearToSrgb(color.y);
+			color.z = details::linearToSrgb(color.z);
+		}
+
+		StorePixel(output, x, y, color);
+	}
+}
+
+/*********************************************************************************
+**************************    prepareDenoiserInputs    ***************************
+*********************************************************************************/
+
+void PHOTON_NAMESPACE::prepareDenoiserInputs(ns::Stream & stream, const Denoiser::Image & input, const Denoiser::GuideLayer & guideLayer, const DenoiserGuideSource & source)
+{
+	const unsigned int count = source.color.width * source.color.height;
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	NS_ASSERT((input.width == source.color.width) && (input.height == source.color.height));
+	NS_ASSERT(source.albedo.empty() || ((guideLayer.albedo.width == source.color.width) && (guideLayer.albedo.height == source.color.height)));
+	NS_ASSERT(source.normal.empty() || ((guideLayer.normal.width == source.color.width) && (guideLayer.normal.height == source.color.height)));
+
+	stream.launch(kernels::PrepareDenoiserInputs, ns::ceil_div(count, 256), 256)(input, guideLayer.albedo, guideLayer.normal, source, count);
+}
+
+
+void PHOTON_NAMESPACE::tonemapDenoiserOutput(ns::Stream & stream, dev::Ptr2<Color4ub> output, const Denoiser::Image & input, const TonemapParams & params)
+{
+	const unsigned int count = output.width() * output.height();
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	NS_ASSERT(output.width() == (params.downsample2x ? input.width / 2 : input.width));
+	NS_ASSERT(output.height() == (params.downsample2x ? input.height / 2 : input.height));
+
+	stream.launch(kernels::TonemapDenoiserOutput, ns::ceil_div(count, 256), 256)(Denoiser::Image(output), input, params, count);
+}
\ No newline at end of file
@@ -22,6 +22,12 @@
 
 #include "pipeline_impl.h"
 #include "denoiser_impl.h"
+#include "denoiser_pool_impl.h"
+#include "broad_phase_impl.h"
+#include "neighbor_search_impl.h"
+#include "ray_query_impl.h"
+#include "spatial_sort_impl.h"
+#include "profiler_impl.h"
 #include "device_context.h"
 #include "accel_struct_impl.h"
 
@@ -57,7 +63,7 @@ static void optixLog(unsigned int level, const char * tag, const char * msg, [[m
 ******************************    DeviceContext    *******************************
 *********************************************************************************/
 
-DeviceContext::DeviceContext(ns::Device * device, int logLevel, [[maybe_unused]] bool validationMode) : m_device(device), m_hContext(nullptr)
+DeviceContext::DeviceContext(ns::Device * device, int logLevel, [[maybe_unused]] bool validationMode) : m_device(device), m_hContext(nullptr), m_devProp{}
 {
 	OptixResult err = optixInit();
 
@@ -99,6 +105,8 @@ DeviceContext::DeviceContext(ns::Device * device, int logLevel, [[maybe_unused]]
 			optixDeviceContextGetProperty(m_hContext, OPTIX_DEVICE_PROPERTY_LIMIT_MAX_STRUCTURED_GRID_RESOLUTION, &m_devProp.maxStructuredGridResolution, sizeof(DeviceProp::maxStructuredGridResolution));
 		#endif
 
+			m_profiler = std::make_unique<ProfilerImpl>();
+
 			NS_INFO_LOG("Creating Optix context on device(%d) successfully, RT-Core version: %d.", device->id(), m_devProp.version);
 
 			return;
@@ -134,8 +142,87 @@ std::shared_ptr<Module> DeviceContext::createModule(const unsigned char * ptxStr
 }
 
 
+#if OPTIX_VERSION >= 70400
+std::shared_ptr<Module> DeviceContext::createModule(const unsigned char * ptxStr, size_t ptxSize,
+													const OptixPipelineCompileOptions & pipelineCompileOptions,
+													ns::ArrayProxy<OptixPayloadType> payloadTypes,
+													OptixModuleCompileOptions moduleCompileOptions)
+{
+	if (pipelineCompileOptions.numPayloadValues != 0)
+	{
+		NS_WARNING_LOG("numPayloadValues must be 0 when payload types are specified!");
+	}
+
+	std::vector<OptixPayloadType> types(payloadTypes.begin(), payloadTypes.end());
+
+	moduleCompileOptions.numPayloadTypes = static_cast<unsigned int>(types.size());
+	moduleCompileOptions.payloadTypes = types.data();
+
+	OptixModule hModule = nullptr;
+
+#if OPTIX_VERSION >= 70700
+	OptixResult err = optixModuleCreate(m_hContext, &moduleCompileOptions, &pipelineCompileOptions, (const char*)ptxStr, ptxSize, nullptr, nullptr, &hModule);
+#else
+	OptixResult err = optixModuleCreateFromPTX(m_hContext, &moduleCompileOptions, &pipelineCompileOptions, (const char*)ptxStr, ptxSize, nullptr, nullptr, &hModule);
+#endif
+
+	if (err == OPTIX_SUCCESS)
+	{
+		return std::make_shared<ModuleImpl>(this->shared_from_this(), hModule, payloadTypes);
+	}
+
+	NS_ERROR_LOG("%s.", optixGetErrorString(err));
+
+	throw err;
+}
+#endif
+
+
+//!	Append the raw bytes of an option struct: padding may only cause spurious cache misses, never false hits.
+template<typename Type> static void appendKey(std::string & key, const Type & value)
+{
+	key.append(reinterpret_cast<const char*>(&value), sizeof(Type));
+}
+
+
+static void appendKey(std::string & key, const OptixPipelineCompileOptions & pipelineCompileOptions)
+{
+	OptixPipelineCompileOptions options = pipelineCompileOptions;
+	options.pipelineLaunchParamsVariableName = nullptr;
+
+	appendKey<OptixPipelineCompileOptions>(key, options);
+
+	if (pipelineCompileOptions.pipelineLaunchParamsVariableName != nullptr)
+	{
+		key.append(pipelineCompileOptions.pipelineLaunchParamsVariableName);
+	}
+
+	key.push_back('\0');
+}
+
+
 std::shared_ptr<Program> DeviceContext::getBuiltinISProgram(OptixBuiltinISOptions builtinISOptions, const OptixPipelineCompileOptions & pipelineCompileOptions)
 {
+	std::string key;
+	appendKey(key, builtinISOptions);
+	appendKey(key, pipelineCompileOptions);
+
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+		auto iter = m_builtinISPrograms.find(key);
+
+		if (iter != m_builtinISPrograms.end())
+		{
+			auto program = iter->second.lock();
+
+			if (program != nullptr)
+			{
+				return program;
+			}
+		}
+	}
+
 	// 1. Get builtin IS module
 	OptixModule hBuiltinModule = nullptr;
 	OptixModuleCompileOptions moduleCompileOptions = {};
@@ -170,7 +257,98 @@ std::shared_ptr<Program> DeviceContext::getBuiltinISProgram(OptixBuiltinISOption
 	}
 
 	// 3. Wrap as ProgramImpl (module = nullptr, since builtin module is self-contained)
-	return std::make_shared<ProgramImpl>(nullptr, hProgramGroup, Program::BuiltinIntersection);
+	std::shared_ptr<Program> program = std::make_shared<ProgramImpl>(nullptr, hProgramGroup, Program::BuiltinIntersection);
+
+	// 4. Publish, unless another thread was faster (ours is then released).
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+	std::erase_if(m_builtinISPrograms, [](const auto & entry) { return entry.second.expired(); });
+
+	auto & cached = m_builtinISPrograms[key];
+
+	if (auto existing = cached.lock())
+	{
+		return existing;
+	}
+
+	cached = program;
+
+	return program;
+}
+
+
+std::shared_ptr<LinkedPipeline> DeviceContext::linkPipeline(ns::ArrayProxy<std::shared_ptr<Program>> programs,
+															const OptixPipelineCompileOptions & pipelineCompileOptions,
+															const OptixPipelineLinkOptions & pipelineLinkOptions)
+{
+	std::vector<OptixProgramGroup> programGroups(programs.size());
+
+	for (size_t i = 0; i < programGroups.size(); i++)
+	{
+		auto progImpl = std::dynamic_pointer_cast<ProgramImpl>(programs[i]);
+
+		if (progImpl == nullptr)
+		{
+			NS_ERROR_LOG("Invalid program!");
+
+			return nullptr;
+		}
+		else
+		{
+			programGroups[i] = progImpl->handle();
+		}
+	}
+
+	std::string key;
+	appendKey(key, pipelineLinkOptions);
+	appendKey(key, pipelineCompileOptions);
+	key.append(reinterpret_cast<const char*>(programGroups.data()), sizeof(OptixProgramGroup) * programGroups.size());
+
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+		auto iter = m_linkedPipelines.find(key);
+
+		if (iter != m_linkedPipelines.end())
+		{
+			auto linkedPipeline = iter->second.lock();
+
+			if (linkedPipeline != nullptr)
+			{
+				return linkedPipeline;
+			}
+		}
+	}
+
+	//	Link without holding the lock, linking may take a while.
+	OptixPipeline hPipeline = nullptr;
+
+	OptixResult err = optixPipelineCreate(m_hContext, &pipelineCompileOptions, &pipelineLinkOptions, programGroups.data(), static_cast<unsigned int>(programGroups.size()), nullptr, nullptr, &hPipeline);
+
+	if (err != OPTIX_SUCCESS)
+	{
+		NS_ERROR_LOG("%s.", optixGetErrorString(err));
+
+		throw err;
+	}
+
+	auto linkedPipeline = std::make_shared<LinkedPipeline>(hPipeline, std::vector<std::shared_ptr<Program>>(programs.begin(), programs.end()));
+
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+	//	Drop entries of destroyed pipelines, their program handles may be reused.
+	std::erase_if(m_linkedPipelines, [](const auto & entry) { return entry.second.expired(); });
+
+	auto & cached = m_linkedPipelines[key];
+
+	if (auto existing = cached.lock())
+	{
+		return existing;
+	}
+
+	cached = linkedPipeline;
+
+	return linkedPipeline;
 }
 
 
@@ -210,8 +388,40 @@ std::unique_ptr<Denoiser> DeviceContext::createDenoiser()
 }
 
 
+std::unique_ptr<DenoiserPool> DeviceContext::createDenoiserPool(ns::AllocPtr pAlloc, size_t memoryBudget, unsigned int resolutionBucket)
+{
+	return std::make_unique<DenoiserPoolImpl>(this->shared_from_this(), pAlloc, memoryBudget, resolutionBucket);
+}
+
+
+std::unique_ptr<BroadPhase> DeviceContext::createBroadPhase()
+{
+	return std::make_unique<BroadPhaseImpl>(this->shared_from_this());
+}
+
+
+std::unique_ptr<NeighborSearch> DeviceContext::createNeighborSearch()
+{
+	return std::make_unique<NeighborSearchImpl>(this->shared_from_this());
+}
+
+
+std::unique_ptr<RayQueryEngine> DeviceContext::createRayQueryEngine()
+{
+	return std::make_unique<RayQueryEngineImpl>(this->shared_from_this());
+}
+
+
+std::unique_ptr<SpatialSort> DeviceContext::createSpatialSort()
+{
+	return std::make_unique<SpatialSortImpl>(this->shared_from_this());
+}
+
+
 DeviceContext::~DeviceContext()
 {
+	m_profiler.reset();
+
 	if (m_hContext != nullptr)
 	{
 		OptixResult err = optixDeviceContextDestroy(m_hContext);
@@ -0,0 +1,217 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "multi_device_context.h"
+#include "device_context.h"
+#include "pipeline_impl.h"
+#include <nucleus/device.h>
+#include <nucleus/logger.h>
+#include <nucleus/stream.h>
+#include <cuda_runtime.h>
+#include <math.h>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+****************************    MultiDeviceContext    ****************************
+*********************************************************************************/
+
+MultiDeviceContext::MultiDeviceContext(ns::ArrayProxy<ns::Device*> devices, int logLevel, bool validationMode)
+{
+	if (devices.empty())
+	{
+		NS_ERROR_LOG("No device!");
+
+		throw OPTIX_ERROR_INVALID_VALUE;
+	}
+
+	for (size_t i = 0; i < devices.size(); i++)
+	{
+		m_contexts.push_back(SharedContext(devices[i], logLevel, validationMode));
+	}
+
+	m_throughputs.assign(m_contexts.size(), 0.0);
+	m_events.assign(2 * m_contexts.size(), nullptr);
+
+	cudaError_t err = cudaSuccess;
+
+	for (size_t i = 0; (i < m_contexts.size()) && (err == cudaSuccess); i++)
+	{
+		ScopedDevice scopedDevice(m_contexts[i]->device()->id());
+
+		err = cudaEventCreate(reinterpret_cast<cudaEvent_t*>(&m_events[2 * i + 0]));
+
+		if (err == cudaSuccess)		err = cudaEventCreate(reinterpret_cast<cudaEvent_t*>(&m_events[2 * i + 1]));
+	}
+
+	if (err != cudaSuccess)
+	{
+		NS_ERROR_LOG("Failed to create timing events: %s.", cudaGetErrorString(err));
+
+		for (void * event : m_events)
+		{
+			if (event != nullptr)	cudaEventDestroy(static_cast<cudaEvent_t>(event));
+		}
+
+		throw OPTIX_ERROR_CUDA_ERROR;
+	}
+}
+
+
+void MultiDeviceContext::forEachDevice(const std::function<void(size_t index, const SharedContext & context)> & func) const
+{
+	for (size_t i = 0; i < m_contexts.size(); i++)
+	{
+		ScopedDevice scopedDevice(m_contexts[i]->device()->id());
+
+		func(i, m_contexts[i]);
+	}
+}
+
+
+std::vector<MultiDeviceContext::LaunchRange> MultiDeviceContext::split(size_t count) const
+{
+	//	Devices not measured yet are assumed as fast as the average measured one.
+	double measuredThroughput = 0.0;
+	size_t numMeasured = 0;
+
+	for (double throughput : m_throughputs)
+	{
+		if (throughput > 0.0)
+		{
+			measuredThroughput += throughput;
+			numMeasured++;
+		}
+	}
+
+	const double defaultThroughput = (numMeasured > 0) ? measuredThroughput / numMeasured : 1.0;
+
+	std::vector<double> throughputs(m_throughputs.size());
+	double totalThroughput = 0.0;
+
+	for (size_t i = 0; i < throughputs.size(); i++)
+	{
+		throughputs[i] = (m_throughputs[i] > 0.0) ? m_throughputs[i] : defaultThroughput;
+		totalThroughput += throughputs[i];
+	}
+
+	std::vector<LaunchRange> ranges(m_contexts.size());
+
+	//	Boundaries are rounded from the cumulative share, so that the ranges cover `count` exactly.
+	double cumulative = 0.0;
+	size_t offset = 0;
+
+	for (size_t i = 0; i < ranges.size(); i++)
+	{
+		cumulative += throughputs[i];
+
+		const size_t end = (i + 1 == ranges.size()) ? count : NS_MIN(count, static_cast<size_t>(llround(count * (cumulative / totalThroughput))));
+
+		ranges[i].device = i;
+		ranges[i].offset = offset;
+		ranges[i].count = end - offset;
+
+		offset = end;
+	}
+
+	return ranges;
+}
+
+
+std::vector<MultiDeviceContext::LaunchRange> MultiDeviceContext::launch(size_t count, const std::function<void(const LaunchRange & range, ns::Stream & stream)> & func)
+{
+	auto ranges = this->split(count);
+
+	//	Enqueue on every device first, the devices then run concurrently.
+	for (const LaunchRange & range : ranges)
+	{
+		if (range.count == 0)
+		{
+			continue;
+		}
+
+		auto & stream = m_contexts[range.device]->device()->defaultStream();
+
+		ScopedDevice scopedDevice(m_contexts[range.device]->device()->id());
+
+		cudaError_t err = cudaEventRecord(static_cast<cudaEvent_t>(m_events[2 * range.device + 0]), stream.handle());
+
+		if (err == cudaSuccess)
+		{
+			func(range, stream);
+
+			err = cudaEventRecord(static_cast<cudaEvent_t>(m_events[2 * range.device + 1]), stream.handle());
+		}
+
+		if (err != cudaSuccess)
+		{
+			NS_ERROR_LOG("%s.", cudaGetErrorString(err));
+
+			throw OPTIX_ERROR_CUDA_ERROR;
+		}
+	}
+
+	for (const LaunchRange & range : ranges)
+	{
+		if (range.count == 0)
+		{
+			continue;
+		}
+
+		float milliseconds = 0.0f;
+
+		cudaError_t err = cudaEventSynchronize(static_cast<cudaEvent_t>(m_events[2 * range.device + 1]));
+
+		if (err == cudaSuccess)
+		{
+			err = cudaEventElapsedTime(&milliseconds, static_cast<cudaEvent_t>(m_events[2 * range.device + 0]), static_cast<cudaEvent_t>(m_events[2 * range.device + 1]));
+		}
+
+		if (err != cudaSuccess)
+		{
+			NS_ERROR_LOG("%s.", cudaGetErrorString(err));
+
+			throw OPTIX_ERROR_CUDA_ERROR;
+		}
+
+		//	Moving average, a single noisy measurement does not swing the next split.
+		if (milliseconds > 0.0f)
+		{
+			const double throughput = range.count / double(milliseconds);
+
+			m_throughputs[range.device] = (m_throughputs[range.device] > 0.0) ? 0.5 * (m_throughputs[range.device] + throughput) : throughput;
+		}
+	}
+
+	return ranges;
+}
+
+
+MultiDeviceContext::~MultiDeviceContext()
+{
+	for (void * event : m_events)
+	{
+		cudaError_t err = cudaEventDestroy(static_cast<cudaEvent_t>(event));
+
+		NS_ERROR_LOG_IF(err != cudaSuccess, "%s.", cudaGetErrorString(err));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "aabb_utils.h"
+#include "neighbor_search_impl.h"
+#include "neighbor_search.optixir.h"
+#include <nucleus/stream.h>
+#include <nucleus/logger.h>
+#include <cub/device/device_scan.cuh>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+****************************    NeighborSearchImpl    ****************************
+*********************************************************************************/
+
+NeighborSearchImpl::NeighborSearchImpl(std::shared_ptr<DeviceContext> deviceContext) : m_sbt{}, m_deviceContext(deviceContext)
+{
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.numPayloadValues = 1;
+	pipelineCompileOptions.numAttributeValues = 2;
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "neighborSearchParams";
+	pipelineCompileOptions.traversableGraphFlags = OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_GAS;
+	pipelineCompileOptions.usesPrimitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_CUSTOM;
+
+	OptixPipelineLinkOptions pipelineLinkOptions = {};
+	pipelineLinkOptions.maxTraceDepth = 1;
+
+	auto module = m_deviceContext->createModule(neighbor_search_optixir, pipelineCompileOptions);
+	auto raygenProg = module->at("__raygen__neighbor_search");
+	auto intersectionProg = module->at("__intersection__neighbor_search");
+	auto missProg = module->at("__miss__neighbor_search");
+
+	//	Program groups are kept alive as long as the pipeline.
+	m_programs = { raygenProg, intersectionProg, missProg };
+	m_pipeline = std::make_unique<Pipeline>(SharedContext(m_deviceContext), m_programs, pipelineCompileOptions, pipelineLinkOptions);
+
+	m_accelStruct = m_deviceContext->createAccelStructAabb();
+	m_spatialSort = m_deviceContext->createSpatialSort();
+
+	//	SBT records: [0] raygen, [1] hit group, [2] miss.
+	auto allocator = m_deviceContext->device()->defaultAllocator();
+	auto & stream = m_deviceContext->device()->defaultStream();
+
+	m_params.resize(allocator, 1);
+	m_sbtRecords.resize(allocator, 3);
+
+	stream.memcpy(&m_sbtRecords.data()[0].header, &raygenProg->header(), 1);
+	stream.memcpy(&m_sbtRecords.data()[1].header, &intersectionProg->header(), 1);
+	stream.memcpy(&m_sbtRecords.data()[2].header, &missProg->header(), 1);
+	stream.sync();
+
+	m_sbt.raygenRecord					= (CUdeviceptr)(m_sbtRecords.data() + 0);
+	m_sbt.hitgroupRecordBase			= (CUdeviceptr)(m_sbtRecords.data() + 1);
+	m_sbt.hitgroupRecordStrideInBytes	= sizeof(EmptyRecord);
+	m_sbt.hitgroupRecordCount			= NeighborSearchRayTypes::hitgroupRecordCount(1);
+	m_sbt.missRecordBase				= (CUdeviceptr)(m_sbtRecords.data() + 2);
+	m_sbt.missRecordStrideInBytes		= sizeof(EmptyRecord);
+	m_sbt.missRecordCount				= NeighborSearchRayTypes::missRecordCount;
+}
+
+
+void NeighborSearchImpl::build(ns::Stream & stream, ns::AllocPtr allocator, const BuildInput & buildInput)
+{
+	NS_ASSERT(buildInput.positions != nullptr);
+
+	m_result = Result{};
+	m_allocator = allocator;
+	m_buildInput = buildInput;
+
+	m_aabbs.resize(allocator, buildInput.numPoints);
+	m_counts.resize(allocator, buildInput.numPoints + 1);
+	m_offsets.resize(allocator, buildInput.numPoints + 1);
+
+	size_t scanTempBytes = 0;
+	cub::DeviceScan::ExclusiveSum(nullptr, scanTempBytes, m_counts.data(), m_offsets.data(), buildInput.numPoints + 1, stream.handle());
+	m_scanTemp.resize(allocator, NS_MAX(scanTempBytes, size_t(1)));
+
+	//	The order is kept until the next build, refit only moves points within it.
+	if (buildInput.reorder)
+	{
+		m_sortedPositions.resize(allocator, buildInput.numPoints);
+		m_spatialSort->sort(stream, allocator, buildInput.positions, buildInput.numPoints, SpatialSort::Hilbert);
+		m_spatialSort->gather(stream, m_sortedPositions.ptr(), buildInput.positions);
+	}
+
+	this->computeAabbs(stream);
+
+	AccelStructAabb::BuildInput aabbInput;
+	aabbInput.aabbBuffer = m_aabbs;
+	aabbInput.numPrimitives = buildInput.numPoints;
+
+	//	Refit is expected between solver steps, keep the GAS updatable.
+	m_accelStruct->build(stream, allocator, aabbInput, 0, true, true);
+}
+
+
+void NeighborSearchImpl::refit(ns::Stream & stream)
+{
+	if (m_buildInput.numPoints == 0)
+	{
+		return;
+	}
+
+	if (m_buildInput.reorder)
+	{
+		m_spatialSort->gather(stream, m_sortedPositions.ptr(), m_buildInput.positions);
+	}
+
+	this->computeAabbs(stream);
+
+	m_accelStruct->refit(stream);
+}
+
+
+const NeighborSearch::Result & NeighborSearchImpl::search(ns::Stream & stream)
+{
+	const unsigned int count = m_buildInput.numPoints;
+
+	if (count == 0)
+	{
+		m_result = Result{};
+
+		return m_result;
+	}
+
+	//	Count pass, `counts[count]` stays zero so the scan also yields the total.
+	stream.memset(m_counts.data(), 0, m_counts.bytes());
+
+	this->launch(stream, false);
+
+	size_t scanTempBytes = m_scanTemp.size();
+	cub::DeviceScan::ExclusiveSum(m_scanTemp.data(), scanTempBytes, m_counts.data(), m_offsets.data(), count + 1, stream.handle());
+
+	unsigned int numIndices = 0;
+	stream.memcpy(&numIndices, m_offsets.data() + count, 1).sync();
+
+	if (numIndices > m_indices.size())
+	{
+		m_indices.resize(m_allocator, ns::align_up(numIndices + numIndices / 4, 1024));
+	}
+
+	//	Fill pass.
+	this->launch(stream, true);
+
+	m_result.offsets = dev::Ptr<const unsigned int>(m_offsets.data(), count + 1);
+	m_result.indices = dev::Ptr<const unsigned int>(m_indices.data(), numIndices);
+	m_result.numIndices = numIndices;
+
+	return m_result;
+}
+
+
+void NeighborSearchImpl::launch(ns::Stream & stream, bool fillPass)
+{
+	NeighborSearchParams params = {};
+	params.counts = m_counts.ptr();
+	params.offsets = m_offsets.ptr();
+	params.indices = m_indices.ptr();
+	params.positions = this->positions();
+	params.remap = m_buildInput.reorder ? m_spatialSort->permutation() : dev::Ptr<const unsigned int>(nullptr);
+	params.traversable = m_accelStruct->handle();
+	params.maxNeighbors = m_buildInput.maxNeighbors;
+	params.fillPass = fillPass ? 1 : 0;
+	params.radius = m_buildInput.radius;
+
+	stream.memcpy(m_params.data(), &params, 1);
+
+	m_pipeline->launch<NeighborSearchParams>(stream, m_params.ptr(), m_sbt, m_buildInput.numPoints);
+}
+
+
+void NeighborSearchImpl::computeAabbs(ns::Stream & stream)
+{
+	//	Point `i` lies in the box of `j` whenever it may be a neighbor of `j`.
+	AabbSource source;
+	source.type = AabbSource::Points;
+	source.vertexBuffer = this->positions();
+	source.radius = m_buildInput.radius;
+	source.numPrimitives = m_buildInput.numPoints;
+
+	PHOTON_NAMESPACE::computeAabbs(stream, m_aabbs, source);
+}
+
+
+NeighborSearchImpl::~NeighborSearchImpl()
+{
+
+}
\ No newline at end of file
@@ -22,9 +22,12 @@
 
 #include "pipeline_impl.h"
 #include "device_context.h"
+#include "profiler.h"
+#include <nucleus/device.h>
 #include <nucleus/logger.h>
 #include <nucleus/stream.h>
 #include <optix_stubs.h>
+#include <string.h>
 
 PHOTON_USING_NAMESPACE
 
@@ -38,7 +41,25 @@ ModuleImpl::ModuleImpl(std::shared_ptr<DeviceContext> deviceContext, OptixModule
 }
 
 
-std::shared_ptr<Program> ModuleImpl::at(const std::string & funcName)
+#if OPTIX_VERSION >= 70400
+ModuleImpl::ModuleImpl(std::shared_ptr<DeviceContext> deviceContext, OptixModule hModule, ns::ArrayProxy<OptixPayloadType> payloadTypes)
+	: m_deviceContext(deviceContext), m_hModule(hModule)
+{
+	//	Keep own copies, program groups created later point into them.
+	m_payloadTypes.resize(payloadTypes.size());
+	m_payloadSemantics.resize(payloadTypes.size());
+
+	for (size_t i = 0; i < payloadTypes.size(); i++)
+	{
+		m_payloadSemantics[i].assign(payloadTypes[i].payloadSemantics, payloadTypes[i].payloadSemantics + payloadTypes[i].numPayloadValues);
+		m_payloadTypes[i].numPayloadValues = payloadTypes[i].numPayloadValues;
+		m_payloadTypes[i].payloadSemantics = m_payloadSemantics[i].data();
+	}
+}
+#endif
+
+
+std::shared_ptr<Program> ModuleImpl::at(std::string_view funcName, unsigned int payloadTypeIndex)
 {
 	// 1. Validation
 	auto progType = ProgramImpl::queryProgramType(funcName);
@@ -51,17 +72,37 @@ std::shared_ptr<Program> ModuleImpl::at(const std::string & funcName)
 	}
 	else if ((progType == Program::Unknow) || (progType == Program::BuiltinIntersection))
 	{
-		NS_ERROR_LOG("Invalid function name: %s", funcName.c_str());
+		NS_ERROR_LOG("Invalid function name: %s", std::string(funcName).c_str());
 
 		return nullptr;
 	}
 
-	// 2. Check
-	auto iter = m_programMap.find(funcName);
+#if OPTIX_VERSION >= 70400
+	if (m_payloadTypes.empty())
+	{
+		payloadTypeIndex = 0;
+	}
+	else if (payloadTypeIndex >= m_payloadTypes.size())
+	{
+		NS_ERROR_LOG("Invalid payload type index %u for %s!", payloadTypeIndex, std::string(funcName).c_str());
+
+		return nullptr;
+	}
+#else
+	payloadTypeIndex = 0;
+#endif
+
+	// 2. Check, only a shared lock of the shard is taken for existing programs.
+	const std::pair<std::string_view, unsigned int> key(funcName, payloadTypeIndex);
+
+	ProgramShard & shard = m_programShards[(std::hash<std::string_view>()(funcName) + payloadTypeIndex) % numProgramShards];
 
-	if (iter != m_programMap.end())
 	{
-		if (!iter->second.expired())
+		std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+		auto iter = shard.programs.find(key);
+
+		if (iter != shard.programs.end())
 		{
 			auto program = iter->second.lock();
 
@@ -72,58 +113,82 @@ std::shared_ptr<Program> ModuleImpl::at(const std::string & funcName)
 		}
 	}
 
+	//	Creation holds the shard exclusively, so that concurrent callers never create the same program twice.
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+	auto iter = shard.programs.find(key);
+
+	if (iter != shard.programs.end())
+	{
+		auto program = iter->second.lock();
+
+		if (program != nullptr)
+		{
+			return program;
+		}
+	}
+
 	// 3. Create single program.
+	const std::string entryFunctionName(funcName);
+
 	OptixProgramGroup hProgramGroup = nullptr;
 	OptixProgramGroupDesc programGroupDesc = { .flags = OPTIX_PROGRAM_GROUP_FLAGS_NONE };
 	OptixProgramGroupOptions programGroupOptions = {};
 
+#if OPTIX_VERSION >= 70400
+	if (!m_payloadTypes.empty())
+	{
+		programGroupOptions.payloadType = &m_payloadTypes[payloadTypeIndex];
+	}
+#endif
+
 	if (progType == Program::Raygen)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_RAYGEN;
 		programGroupDesc.raygen.module = m_hModule;
-		programGroupDesc.raygen.entryFunctionName = funcName.c_str();
+		programGroupDesc.raygen.entryFunctionName = entryFunctionName.c_str();
 	}
 	else if (progType == Program::Miss)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_MISS;
 		programGroupDesc.miss.module = m_hModule;
-		programGroupDesc.miss.entryFunctionName = funcName.c_str();
+		programGroupDesc.miss.entryFunctionName = entryFunctionName.c_str();
 	}
 	else if (progType == Program::AnyHit)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_HITGROUP;
 		programGroupDesc.hitgroup.moduleAH = m_hModule;
-		programGroupDesc.hitgroup.entryFunctionNameAH = funcName.c_str();
+		programGroupDesc.hitgroup.entryFunctionNameAH = entryFunctionName.c_str();
 	}
 	else if (progType == Program::ClosestHit)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_HITGROUP;
 		programGroupDesc.hitgroup.moduleCH = m_hModule;
-		programGroupDesc.hitgroup.entryFunctionNameCH = funcName.c_str();
+		programGroupDesc.hitgroup.entryFunctionNameCH = entryFunctionName.c_str();
 	}
 	else if (progType == Program::Intersection)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_HITGROUP;
 		programGroupDesc.hitgroup.moduleIS = m_hModule;
-		programGroupDesc.hitgroup.entryFunctionNameIS = funcName.c_str();
+		programGroupDesc.hitgroup.entryFunctionNameIS = entryFunctionName.c_str();
 	}
 	else if (progType == Program::DirectCallable)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_CALLABLES;
-		programGroupDesc.callables.entryFunctionNameDC = funcName.c_str();
+		programGroupDesc.callables.entryFunctionNameDC = entryFunctionName.c_str();
 		programGroupDesc.callables.moduleDC = m_hModule;
 	}
 	else if (progType == Program::ContinuationCallable)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_CALLABLES;
-		programGroupDesc.callables.entryFunctionNameCC = funcName.c_str();
+		programGroupDesc.callables.entryFunctionNameCC = entryFunctionName.c_str();
 		programGroupDesc.callables.moduleCC = m_hModule;
 	}
 	else if (progType == Program::Exception)
 	{
 		programGroupDesc.kind = OPTIX_PROGRAM_GROUP_KIND_EXCEPTION;
 		programGroupDesc.exception.module = m_hModule;
-		programGroupDesc.exception.entryFunctionName = funcName.c_str();
+		programGroupDesc.exception.entryFunctionName = entryFunctionName.c_str();
 	}
 
 	OptixResult err = optixProgramGroupCreate(m_deviceContext->handle(), &programGroupDesc, 1, &programGroupOptions, nullptr, nullptr, &hProgramGroup);
@@ -137,7 +202,14 @@ std::shared_ptr<Program> ModuleImpl::at(const std::string & funcName)
 
 	auto program = std::make_shared<ProgramImpl>(this->shared_from_this(), hProgramGroup, progType);
 
-	m_programMap[funcName] = program;
+	if (iter != shard.programs.end())
+	{
+		iter->second = program;
+	}
+	else
+	{
+		shard.programs.emplace(std::make_pair(entryFunctionName, payloadTypeIndex), program);
+	}
 
 	return program;
 }
@@ -201,7 +273,7 @@ std::shared_ptr<Program> Program::combine(std::shared_ptr<Program> program0, std
 }
 
 
-Program::Type ProgramImpl::queryProgramType(const std::string & funcName)
+Program::Type ProgramImpl::queryProgramType(std::string_view funcName)
 {
 	if (funcName.starts_with("__miss__"))							return Program::Miss;
 	else if (funcName.starts_with("__raygen__"))					return Program::Raygen;
@@ -234,45 +306,212 @@ ProgramImpl::~ProgramImpl()
 
 
 /*********************************************************************************
-*********************************    Pipeline    *********************************
+******************************    LinkedPipeline    ******************************
 *********************************************************************************/
 
-Pipeline::Pipeline(SharedContext context, ns::ArrayProxy<std::shared_ptr<Program>> programs,
-				   const OptixPipelineCompileOptions & pipelineCompileOptions, const OptixPipelineLinkOptions & pipelineLinkOptions)
-	: m_context(context), m_hPipeline(nullptr)
+LinkedPipeline::LinkedPipeline(OptixPipeline hPipeline, std::vector<std::shared_ptr<Program>> programs) : m_hPipeline(hPipeline), m_programs(std::move(programs))
 {
-	std::vector<OptixProgramGroup> programGroups(programs.size());
 
-	for (size_t i = 0; i < programGroups.size(); i++)
+}
+
+
+LinkedPipeline::~LinkedPipeline()
+{
+	if (m_hPipeline != nullptr)
 	{
-		auto progImpl = std::dynamic_pointer_cast<ProgramImpl>(programs[i]);
+		OptixResult err = optixPipelineDestroy(m_hPipeline);
+
+		NS_ERROR_LOG_IF(err != OPTIX_SUCCESS, "%s.", optixGetErrorString(err));
+	}
+}
+
+/*********************************************************************************
+*****************************    ChunkedLauncher    ******************************
+*********************************************************************************/
+
+ChunkedLauncher::ChunkedLauncher(ns::Device * device)
+	: m_device(device), m_slotSize(0), m_hostParams(nullptr), m_devParams(nullptr), m_streams{}, m_uploaded{}, m_finished{}, m_ready(nullptr)
+{
+
+}
+
 
-		if (progImpl == nullptr)
+void ChunkedLauncher::reserve(size_t paramsSize)
+{
+	if ((m_ready != nullptr) && (paramsSize <= m_slotSize))
+	{
+		return;
+	}
+
+	ScopedDevice scopedDevice(m_device->id());
+
+	if (m_ready == nullptr)
+	{
+		cudaError_t err = cudaEventCreateWithFlags(&m_ready, cudaEventDisableTiming);
+
+		for (unsigned int i = 0; (i < numStreams) && (err == cudaSuccess); i++)
 		{
-			NS_ERROR_LOG("Invalid program!");
+			err = cudaStreamCreateWithFlags(&m_streams[i], cudaStreamNonBlocking);
 
-			return;
+			if (err == cudaSuccess)		err = cudaEventCreateWithFlags(&m_uploaded[i], cudaEventDisableTiming);
+			if (err == cudaSuccess)		err = cudaEventCreateWithFlags(&m_finished[i], cudaEventDisableTiming);
 		}
-		else
+
+		if (err != cudaSuccess)
 		{
-			programGroups[i] = progImpl->handle();
+			NS_ERROR_LOG("Failed to create streams of chunked launches: %s.", cudaGetErrorString(err));
+
+			for (unsigned int i = 0; i < numStreams; i++)
+			{
+				if (m_streams[i] != nullptr)	cudaStreamDestroy(m_streams[i]);
+				if (m_uploaded[i] != nullptr)	cudaEventDestroy(m_uploaded[i]);
+				if (m_finished[i] != nullptr)	cudaEventDestroy(m_finished[i]);
+			}
+
+			if (m_ready != nullptr)		cudaEventDestroy(m_ready);
+
+			m_streams = {};
+			m_uploaded = {};
+			m_finished = {};
+			m_ready = nullptr;
+
+			throw OPTIX_ERROR_CUDA_ERROR;
 		}
 	}
 
-	OptixResult err = optixPipelineCreate(context->handle(), &pipelineCompileOptions, &pipelineLinkOptions, programGroups.data(), programs.size(), nullptr, nullptr, &m_hPipeline);
+	if (paramsSize > m_slotSize)
+	{
+		//	Slots may still be read by chunks of a previous launch.
+		for (unsigned int i = 0; i < numStreams; i++)
+		{
+			cudaStreamSynchronize(m_streams[i]);
+		}
 
-	if (err != OPTIX_SUCCESS)
+		cudaFreeHost(m_hostParams);
+		cudaFree(m_devParams);
+
+		m_hostParams = nullptr;
+		m_devParams = nullptr;
+		m_slotSize = ns::align_up(paramsSize, OPTIX_SBT_RECORD_ALIGNMENT);
+
+		if ((cudaMallocHost(&m_hostParams, numStreams * m_slotSize) != cudaSuccess) || (cudaMalloc(&m_devParams, numStreams * m_slotSize) != cudaSuccess))
+		{
+			NS_ERROR_LOG("Failed to allocate launch parameters of chunked launches.");
+
+			m_slotSize = 0;
+
+			throw OPTIX_ERROR_HOST_OUT_OF_MEMORY;
+		}
+	}
+}
+
+
+void ChunkedLauncher::launch(OptixPipeline hPipeline, cudaStream_t stream, const void * hostParams, size_t paramsSize, size_t chunkOffset, const OptixShaderBindingTable & sbt, size_t count, size_t chunkSize)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	this->reserve(paramsSize);
+
+	//	Chunks start after the work already enqueued on the caller stream.
+	cudaEventRecord(m_ready, stream);
+
+	for (unsigned int i = 0; i < numStreams; i++)
 	{
-		NS_ERROR_LOG("%s.", optixGetErrorString(err));
+		cudaStreamWaitEvent(m_streams[i], m_ready, 0);
+	}
 
-		throw err;
+	const size_t numChunks = ns::ceil_div(count, chunkSize);
+
+	for (size_t chunk = 0; chunk < numChunks; chunk++)
+	{
+		const unsigned int slot = chunk % numStreams;
+
+		LaunchChunk launchChunk = {};
+		launchChunk.offset = chunk * chunkSize;
+		launchChunk.count = NS_MIN(chunkSize, count - launchChunk.offset);
+
+		unsigned char * hostSlot = m_hostParams + slot * m_slotSize;
+		unsigned char * devSlot = m_devParams + slot * m_slotSize;
+
+		//	The upload of this chunk overlaps the execution of the previous one, on another stream.
+		cudaEventSynchronize(m_uploaded[slot]);
+
+		memcpy(hostSlot, hostParams, paramsSize);
+		memcpy(hostSlot + chunkOffset, &launchChunk, sizeof(LaunchChunk));
+
+		cudaMemcpyAsync(devSlot, hostSlot, paramsSize, cudaMemcpyHostToDevice, m_streams[slot]);
+		cudaEventRecord(m_uploaded[slot], m_streams[slot]);
+
+		OptixResult err = optixLaunch(hPipeline, m_streams[slot], CUdeviceptr(devSlot), paramsSize, &sbt, static_cast<unsigned int>(launchChunk.count), 1, 1);
+
+		if (err != OPTIX_SUCCESS)
+		{
+			NS_ERROR_LOG("%s.", optixGetErrorString(err));
+
+			throw err;
+		}
+	}
+
+	//	Work enqueued afterwards on the caller stream starts after the last chunk.
+	for (unsigned int i = 0; i < numStreams; i++)
+	{
+		cudaEventRecord(m_finished[i], m_streams[i]);
+		cudaStreamWaitEvent(stream, m_finished[i], 0);
+	}
+}
+
+
+ChunkedLauncher::~ChunkedLauncher()
+{
+	if (m_ready != nullptr)
+	{
+		for (unsigned int i = 0; i < numStreams; i++)
+		{
+			cudaStreamSynchronize(m_streams[i]);
+			cudaStreamDestroy(m_streams[i]);
+			cudaEventDestroy(m_uploaded[i]);
+			cudaEventDestroy(m_finished[i]);
+		}
+
+		cudaEventDestroy(m_ready);
+		cudaFreeHost(m_hostParams);
+		cudaFree(m_devParams);
 	}
 }
 
+/*********************************************************************************
+*********************************    Pipeline    *********************************
+*********************************************************************************/
 
-void Pipeline::doLaunch(ns::Stream & stream, const void * pipelineParams, size_t pipelineParamsSize, const OptixShaderBindingTable & sbt, unsigned int width, unsigned int height, unsigned int depth)
+Pipeline::Pipeline(SharedContext context, ns::ArrayProxy<std::shared_ptr<Program>> programs,
+				   const OptixPipelineCompileOptions & pipelineCompileOptions, const OptixPipelineLinkOptions & pipelineLinkOptions)
+	: m_context(context), m_hPipeline(nullptr)
 {
-	OptixResult err = optixLaunch(m_hPipeline, stream.handle(), CUdeviceptr(pipelineParams), pipelineParamsSize, &sbt, width, height, depth);
+	m_linkedPipeline = context->linkPipeline(programs, pipelineCompileOptions, pipelineLinkOptions);
+
+	if (m_linkedPipeline != nullptr)
+	{
+		m_hPipeline = m_linkedPipeline->handle();
+	}
+
+	m_chunkedLauncher = std::make_unique<ChunkedLauncher>(context->device());
+}
+
+
+void Pipeline::doLaunch(ns::Stream & stream, const void * pipelineParams, size_t pipelineParamsSize, const OptixShaderBindingTable & sbt, size_t width, size_t height, size_t depth)
+{
+	//	Each factor is checked first, so that the products cannot overflow.
+	if ((width > maxLaunchSize) || (height > maxLaunchSize) || (depth > maxLaunchSize) || (width * height > maxLaunchSize) || (width * height * depth > maxLaunchSize))
+	{
+		NS_ERROR_LOG("Launch size %zux%zux%zu exceeds the OptiX limit, use `Pipeline::launchChunked()`.", width, height, depth);
+
+		throw OPTIX_ERROR_INVALID_VALUE;
+	}
+
+	Profiler::Scope scope(m_context->profiler(), stream, "optixLaunch", this);
+
+	OptixResult err = optixLaunch(m_hPipeline, stream.handle(), CUdeviceptr(pipelineParams), pipelineParamsSize, &sbt,
+								  static_cast<unsigned int>(width), static_cast<unsigned int>(height), static_cast<unsigned int>(depth));
 
 	if (err != OPTIX_SUCCESS)
 	{
@@ -283,12 +522,22 @@ void Pipeline::doLaunch(ns::Stream & stream, const void * pipelineParams, size_t
 }
 
 
-Pipeline::~Pipeline()
+void Pipeline::doLaunchChunked(ns::Stream & stream, const void * hostParams, size_t pipelineParamsSize, size_t chunkOffset, const OptixShaderBindingTable & sbt, size_t count, size_t chunkSize)
 {
-	if (m_hPipeline != nullptr)
+	if (count == 0)
 	{
-		OptixResult err = optixPipelineDestroy(m_hPipeline);
-
-		NS_ERROR_LOG_IF(err != OPTIX_SUCCESS, "%s.", optixGetErrorString(err));
+		return;
 	}
+
+	chunkSize = NS_MIN(NS_MAX(chunkSize, size_t(1)), size_t(maxLaunchSize));
+
+	Profiler::Scope scope(m_context->profiler(), stream, "optixLaunch (chunked)", this);
+
+	m_chunkedLauncher->launch(m_hPipeline, stream.handle(), hostParams, pipelineParamsSize, chunkOffset, sbt, count, chunkSize);
+}
+
+
+Pipeline::~Pipeline()
+{
+
 }
\ No newline at end of file
@@ -23,6 +23,11 @@
 
 #include "pipeline.h"
 #include <optix.h>
+#include <cuda_runtime.h>
+#include <shared_mutex>
+#include <mutex>
+#include <vector>
+#include <array>
 #include <map>
 
 namespace PHOTON_NAMESPACE
@@ -41,17 +46,47 @@ namespace PHOTON_NAMESPACE
 
 		ModuleImpl(std::shared_ptr<DeviceContext> deviceContext, OptixModule hModule);
 
+	#if OPTIX_VERSION >= 70400
+		ModuleImpl(std::shared_ptr<DeviceContext> deviceContext, OptixModule hModule, ns::ArrayProxy<OptixPayloadType> payloadTypes);
+	#endif
+
 		~ModuleImpl();
 
 	public:
 
-		virtual std::shared_ptr<Program> at(const std::string & funcName) override;
+		virtual std::shared_ptr<Program> at(std::string_view funcName, unsigned int payloadTypeIndex) override;
 
 		std::shared_ptr<DeviceContext> deviceContext() const { return m_deviceContext; }
 
 	private:
 
-		std::map<std::string, std::weak_ptr<ProgramImpl>>		m_programMap;
+		//!	Orders `(name, payloadTypeIndex)` keys, transparent so that lookups by `std::string_view` do not allocate.
+		struct ProgramKeyLess
+		{
+			using is_transparent = void;
+
+			template<typename Key0, typename Key1> bool operator()(const Key0 & key0, const Key1 & key1) const
+			{
+				return std::pair<std::string_view, unsigned int>(key0.first, key0.second) < std::pair<std::string_view, unsigned int>(key1.first, key1.second);
+			}
+		};
+
+		//!	Programs are spread over shards by name hash, so that concurrent loaders rarely contend on the same lock.
+		struct ProgramShard
+		{
+			std::shared_mutex																			mutex;
+			std::map<std::pair<std::string, unsigned int>, std::weak_ptr<ProgramImpl>, ProgramKeyLess>	programs;
+		};
+
+		static constexpr size_t numProgramShards = 8;
+
+		std::array<ProgramShard, numProgramShards>				m_programShards;
+
+	#if OPTIX_VERSION >= 70400
+		std::vector<OptixPayloadType>							m_payloadTypes;
+
+		std::vector<std::vector<unsigned int>>					m_payloadSemantics;
+	#endif
 
 		const std::shared_ptr<DeviceContext>					m_deviceContext;
 
@@ -77,7 +112,7 @@ namespace PHOTON_NAMESPACE
 
 		virtual const SbtHeader & header() const override { return m_header; }
 
-		static Program::Type queryProgramType(const std::string & funcName);
+		static Program::Type queryProgramType(std::string_view funcName);
 
 		std::shared_ptr<DeviceContext> deviceContext() const;
 
@@ -93,4 +128,100 @@ namespace PHOTON_NAMESPACE
 
 		SbtHeader								m_header;
 	};
+
+	/*****************************************************************************
+	****************************    LinkedPipeline    ****************************
+	*****************************************************************************/
+
+	//!	An `OptixPipeline` shared by the `Pipeline` objects created from the same programs and options.
+	class LinkedPipeline
+	{
+		NS_NONCOPYABLE(LinkedPipeline)
+
+	public:
+
+		LinkedPipeline(OptixPipeline hPipeline, std::vector<std::shared_ptr<Program>> programs);
+
+		~LinkedPipeline();
+
+	public:
+
+		OptixPipeline handle() const { return m_hPipeline; }
+
+	private:
+
+		const OptixPipeline								m_hPipeline;
+
+		const std::vector<std::shared_ptr<Program>>		m_programs;		//!	Kept alive, their handles are part of the cache key.
+	};
+
+	/*****************************************************************************
+	*****************************    ScopedDevice    *****************************
+	*****************************************************************************/
+
+	//!	Makes a device current for the lifetime of the object and restores the previous one.
+	class ScopedDevice
+	{
+		NS_NONCOPYABLE(ScopedDevice)
+
+	public:
+
+		explicit ScopedDevice(int deviceId) : m_previousId(deviceId)
+		{
+			cudaGetDevice(&m_previousId);
+
+			if (m_previousId != deviceId)
+			{
+				cudaSetDevice(deviceId);
+			}
+		}
+
+		~ScopedDevice()
+		{
+			cudaSetDevice(m_previousId);
+		}
+
+	private:
+
+		int			m_previousId;
+	};
+
+	/*****************************************************************************
+	***************************    ChunkedLauncher    ****************************
+	*****************************************************************************/
+
+	//!	Enqueues the chunks of `Pipeline::launchChunked()` over a small pool of streams.
+	class ChunkedLauncher
+	{
+		NS_NONCOPYABLE(ChunkedLauncher)
+
+	public:
+
+		explicit ChunkedLauncher(ns::Device * device);
+
+		~ChunkedLauncher();
+
+	public:
+
+		void launch(OptixPipeline hPipeline, cudaStream_t stream, const void * hostParams, size_t paramsSize, size_t chunkOffset, const OptixShaderBindingTable & sbt, size_t count, size_t chunkSize);
+
+	private:
+
+		//!	Create the streams and grow the parameter slots to `paramsSize` (lock must be held).
+		void reserve(size_t paramsSize);
+
+	private:
+
+		static constexpr unsigned int					numStreams = 3;
+
+		std::mutex										m_mutex;
+		ns::Device * const								m_device;
+		size_t											m_slotSize;				//!	Bytes per parameter slot, one slot per stream.
+		unsigned char *									m_hostParams;			//!	Pinned staging of the slots.
+		unsigned char *									m_devParams;
+		std::array<cudaStream_t, numStreams>			m_streams;
+		std::array<cudaEvent_t, numStreams>				m_uploaded;				//!	Staging slot of a stream may be overwritten.
+		std::array<cudaEvent_t, numStreams>				m_finished;
+		cudaEvent_t										m_ready;				//!	Work enqueued before the launch on the caller stream.
+	};
 }
\ No newline at end of file
@@ -0,0 +1,325 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "profiler_impl.h"
+#include <nucleus/logger.h>
+#include <nucleus/stream.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+*******************************    ProfilerImpl    *******************************
+*********************************************************************************/
+
+ProfilerImpl::ProfilerImpl() : m_enabled(false), m_origin(nullptr), m_nextRecord(0)
+{
+	const char * env = getenv("PHOTON_PROFILE");
+
+	if ((env != nullptr) && (env[0] != '\0') && (strcmp(env, "0") != 0))
+	{
+		if (strcmp(env, "1") != 0)
+		{
+			m_tracePath = env;
+		}
+
+		this->setEnabled(true);
+	}
+}
+
+
+cudaEvent_t ProfilerImpl::acquireEvent()
+{
+	cudaEvent_t event = nullptr;
+
+	if (!m_freeEvents.empty())
+	{
+		event = m_freeEvents.back();
+
+		m_freeEvents.pop_back();
+	}
+	else
+	{
+		cudaError_t err = cudaEventCreate(&event);
+
+		NS_ERROR_LOG_IF(err != cudaSuccess, "%s.", cudaGetErrorString(err));
+	}
+
+	return event;
+}
+
+
+void ProfilerImpl::setEnabled(bool enabled)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+void ProfilerImpl::setLabel(const void * object, const char * label)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_labels[object] = label;
+}
+
+
+std::string ProfilerImpl::label(const void * object) const
+{
+	auto iter = m_labels.find(object);
+
+	if (iter != m_labels.end())
+	{
+		return iter->second;
+	}
+
+	char address[32] = {};
+
+	snprintf(address, sizeof(address), "%p", object);
+
+	return address;
+}
+
+
+size_t ProfilerImpl::begin(ns::Stream & stream, const char * operation, const void * object)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	PendingRecord				record;
+	record.operation			= operation;
+	record.object				= object;
+	record.stream				= stream.handle();
+	record.start				= this->acquireEvent();
+	record.stop					= this->acquireEvent();
+	record.ended				= false;
+
+	//	All timestamps of the trace are relative to this event, recorded on the first profiled stream rather than
+	//	on the legacy null stream, which would synchronize with every blocking stream of the device.
+	if (m_origin == nullptr)
+	{
+		m_origin = this->acquireEvent();
+
+		cudaEventRecord(m_origin, record.stream);
+	}
+
+	cudaEventRecord(record.start, record.stream);
+
+	m_pendingRecords.emplace(m_nextRecord, record);
+
+	return m_nextRecord++;
+}
+
+
+void ProfilerImpl::end(size_t record)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto iter = m_pendingRecords.find(record);
+
+	if (iter != m_pendingRecords.end())
+	{
+		cudaEventRecord(iter->second.stop, iter->second.stream);
+
+		iter->second.ended = true;
+	}
+
+	//	Keep the number of events bounded when statistics are never queried.
+	if (m_pendingRecords.size() >= 1024)
+	{
+		this->resolve(false);
+	}
+}
+
+
+void ProfilerImpl::resolve(bool wait)
+{
+	for (auto iter = m_pendingRecords.begin(); iter != m_pendingRecords.end();)
+	{
+		PendingRecord & record = iter->second;
+
+		if (!record.ended || (!wait && (cudaEventQuery(record.stop) != cudaSuccess)))
+		{
+			++iter;
+
+			continue;
+		}
+
+		float startMs = 0.0f, durationMs = 0.0f;
+
+		cudaEventSynchronize(record.stop);
+		cudaEventElapsedTime(&startMs, m_origin, record.start);
+		cudaEventElapsedTime(&durationMs, record.start, record.stop);
+
+		Stats & stats = m_stats[std::make_pair(std::string(record.operation), record.object)];
+
+		if (stats.count == 0)
+		{
+			stats.operation = record.operation;
+			stats.minMs = durationMs;
+			stats.maxMs = durationMs;
+		}
+
+		const double durationUs = 1e3 * durationMs;
+		const unsigned int bin = (durationUs < 1.0) ? 0 : static_cast<unsigned int>(log2(durationUs)) + 1;
+
+		stats.histogram[NS_MIN(bin, numHistogramBins - 1)]++;
+		stats.minMs = NS_MIN(stats.minMs, double(durationMs));
+		stats.maxMs = NS_MAX(stats.maxMs, double(durationMs));
+		stats.totalMs += durationMs;
+		stats.count++;
+
+		if (m_traceEvents.size() < maxTraceEvents)
+		{
+			const unsigned int track = m_tracks.emplace(record.stream, static_cast<unsigned int>(m_tracks.size())).first->second;
+
+			m_traceEvents.push_back(TraceEvent{ record.operation, record.object, track, 1e3 * startMs, durationUs });
+		}
+
+		m_freeEvents.push_back(record.start);
+		m_freeEvents.push_back(record.stop);
+
+		iter = m_pendingRecords.erase(iter);
+	}
+}
+
+
+std::vector<Profiler::Stats> ProfilerImpl::stats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	this->resolve(true);
+
+	std::vector<Stats> result;
+	result.reserve(m_stats.size());
+
+	for (const auto & iter : m_stats)
+	{
+		result.push_back(iter.second);
+
+		result.back().object = this->label(iter.first.second);
+	}
+
+	return result;
+}
+
+
+void ProfilerImpl::reset()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	this->resolve(true);
+
+	m_traceEvents.clear();
+	m_tracks.clear();
+	m_stats.clear();
+}
+
+
+//!	Write `str` as a JSON string literal.
+static void writeJsonString(FILE * file, const char * str)
+{
+	fputc('"', file);
+
+	for (; *str != '\0'; str++)
+	{
+		if ((*str == '"') || (*str == '\\'))		fputc('\\', file);
+
+		if (static_cast<unsigned char>(*str) >= 0x20)	fputc(*str, file);
+	}
+
+	fputc('"', file);
+}
+
+
+bool ProfilerImpl::writeChromeTrace(const char * path)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	this->resolve(true);
+
+	FILE * file = fopen(path, "w");
+
+	if (file == nullptr)
+	{
+		NS_ERROR_LOG("Failed to open trace file: %s.", path);
+
+		return false;
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+	//	Track names and events share the array, every entry but the first is preceded by a separator.
+	const char * separator = "";
+
+	for (const auto & iter : m_tracks)
+	{
+		fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"stream %p\"}}", separator, iter.second, static_cast<void*>(iter.first));
+
+		separator = ",";
+	}
+
+	for (const TraceEvent & event : m_traceEvents)
+	{
+		fprintf(file, "%s\n{\"name\":", separator);
+		writeJsonString(file, event.operation);
+		fprintf(file, ",\"cat\":\"photon\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"object\":", event.track, event.startUs, event.durationUs);
+		writeJsonString(file, this->label(event.object).c_str());
+		fprintf(file, "}}");
+
+		separator = ",";
+	}
+
+	fprintf(file, "\n]}\n");
+
+	return fclose(file) == 0;
+}
+
+
+ProfilerImpl::~ProfilerImpl()
+{
+	if (!m_tracePath.empty())
+	{
+		this->writeChromeTrace(m_tracePath.c_str());
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto & iter : m_pendingRecords)
+	{
+		cudaEventDestroy(iter.second.start);
+		cudaEventDestroy(iter.second.stop);
+	}
+
+	for (cudaEvent_t event : m_freeEvents)
+	{
+		cudaEventDestroy(event);
+	}
+
+	if (m_origin != nullptr)
+	{
+		cudaEventDestroy(m_origin);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "profiler.h"
+#include <cuda_runtime.h>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <map>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	*****************************    ProfilerImpl    *****************************
+	*****************************************************************************/
+
+	class ProfilerImpl : public Profiler
+	{
+
+	public:
+
+		ProfilerImpl();
+
+		virtual ~ProfilerImpl();
+
+	public:
+
+		virtual void setEnabled(bool enabled) override;
+		virtual bool isEnabled() const override { return m_enabled.load(std::memory_order_relaxed); }
+		virtual void setLabel(const void * object, const char * label) override;
+		virtual std::vector<Stats> stats() override;
+		virtual void reset() override;
+		virtual bool writeChromeTrace(const char * path) override;
+
+	protected:
+
+		virtual size_t begin(ns::Stream & stream, const char * operation, const void * object) override;
+		virtual void end(size_t record) override;
+
+	private:
+
+		//!	An operation whose events have not been resolved yet.
+		struct PendingRecord
+		{
+			const char *			operation;
+			const void *			object;
+			cudaStream_t			stream;
+			cudaEvent_t				start;
+			cudaEvent_t				stop;
+			bool					ended;
+		};
+
+		//!	A resolved operation, kept for the trace.
+		struct TraceEvent
+		{
+			const char *			operation;
+			const void *			object;
+			unsigned int			track;
+			double					startUs;
+			double					durationUs;
+		};
+
+		cudaEvent_t acquireEvent();
+
+		//!	Fold the completed records into statistics and trace, waiting for them if `wait` (lock must be held).
+		void resolve(bool wait);
+
+		std::string label(const void * object) const;
+
+	private:
+
+		static constexpr size_t maxTraceEvents = 1 << 20;
+
+		std::mutex													m_mutex;
+		std::atomic<bool>											m_enabled;
+		cudaEvent_t													m_origin;
+		size_t														m_nextRecord;
+		std::string													m_tracePath;
+		std::vector<cudaEvent_t>									m_freeEvents;
+		std::map<size_t, PendingRecord>								m_pendingRecords;
+		std::vector<TraceEvent>										m_traceEvents;
+		std::unordered_map<cudaStream_t, unsigned int>				m_tracks;
+		std::unordered_map<const void*, std::string>				m_labels;
+		std::map<std::pair<std::string, const void*>, Stats>		m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "trace.cuh"
+#include "broad_phase_params.h"
+#include <optix_device.h>
+
+PHOTON_USING_NAMESPACE
+
+__RT_CONSTANT__ BroadPhaseParams broadPhaseParams;
+
+/*********************************************************************************
+********************************    Candidates    ********************************
+*********************************************************************************/
+
+//!	Partners of one particle, gathered in the intersection program and flushed by the ray-generation program.
+struct Candidates
+{
+	static constexpr unsigned int capacity = 16;
+
+	unsigned int	count;
+	unsigned int	partners[capacity];
+};
+
+//!	Pointer to the per-ray `Candidates` (on the stack of the ray-generation program), packed into payload 0-1.
+using CandidatesPayload = Payload<Candidates*, 0, 1>;
+
+
+__device__ __forceinline__ float particleRadius(unsigned int i)
+{
+	return (broadPhaseParams.radii != nullptr) ? broadPhaseParams.radii[i] + broadPhaseParams.radius : broadPhaseParams.radius;
+}
+
+
+//!	`threadIdx` is not meaningful in OptiX programs, read the lane index directly.
+__device__ __forceinline__ unsigned int laneIndex()
+{
+	unsigned int laneId;		asm volatile("mov.u32 %0, %%laneid;" : "=r"(laneId));		return laneId;
+}
+
+
+//!	`i` and `j` are indices of the (possibly sorted) particles, pairs are written with the original ones.
+__device__ __forceinline__ void appendPair(unsigned int slot, unsigned int i, unsigned int j)
+{
+	if (slot < broadPhaseParams.capacity)
+	{
+		if (broadPhaseParams.remap != nullptr)
+		{
+			i = broadPhaseParams.remap[i];
+			j = broadPhaseParams.remap[j];
+		}
+
+		broadPhaseParams.pairs[slot] = BroadPhase::ContactPair{ NS_MIN(i, j), NS_MAX(i, j) };
+	}
+}
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+__RT_KERNEL__ void __raygen__broad_phase()
+{
+	const unsigned int i = optixGetLaunchIndex().x;
+	const ns::float3_16a p = broadPhaseParams.positions[i];
+
+	Candidates candidates;
+	candidates.count = 0;
+
+	CandidatesPayload payload = &candidates;
+
+	trace<BroadPhaseRayTypes::Ray<BroadPhaseRay>>(broadPhaseParams.traversable, float3{ p.x, p.y, p.z }, float3{ 1.0f, 0.0f, 0.0f }, 0.0f, 1e-6f, payload);
+
+	//	Warp-aggregated append: one atomic per warp instead of one per pair.
+	const unsigned int count = NS_MIN(candidates.count, Candidates::capacity);
+	const unsigned int activeMask = __activemask();
+	const unsigned int laneId = laneIndex();
+	const unsigned int leader = __ffs(activeMask) - 1;
+
+	unsigned int offset = 0;
+	unsigned int total = 0;
+
+	//	Lanes may be inactive after the trace, so walk the active mask instead of a shuffle-up scan.
+	for (unsigned int mask = activeMask; mask != 0; mask &= mask - 1)
+	{
+		const unsigned int lane = __ffs(mask) - 1;
+		const unsigned int value = __shfl_sync(activeMask, count, lane);
+
+		offset += (lane < laneId) ? value : 0;
+		total += value;
+	}
+
+	unsigned int base = 0;
+
+	if (laneId == leader)
+	{
+		base = atomicAdd(broadPhaseParams.numPairs.data(), total);
+	}
+
+	base = __shfl_sync(activeMask, base, leader) + offset;
+
+	for (unsigned int k = 0; k < count; k++)
+	{
+		appendPair(base + k, i, candidates.partners[k]);
+	}
+}
+
+
+__RT_KERNEL__ void __intersection__broad_phase()
+{
+	const unsigned int i = optixGetLaunchIndex().x;
+	const unsigned int j = optixGetPrimitiveIndex();
+
+	//	Each pair is visited from both sides, keep the one from the lower index.
+	if (j <= i)		return;
+
+	const ns::float3_16a pi = broadPhaseParams.positions[i];
+	const ns::float3_16a pj = broadPhaseParams.positions[j];
+	const float dx = pj.x - pi.x;
+	const float dy = pj.y - pi.y;
+	const float dz = pj.z - pi.z;
+	const float r = particleRadius(i) + particleRadius(j);
+
+	bool overlap = false;
+
+	if (broadPhaseParams.shape == BroadPhase::Sphere)
+	{
+		overlap = (dx * dx + dy * dy + dz * dz) < (r * r);
+	}
+	else
+	{
+		overlap = (fabsf(dx) < r) && (fabsf(dy) < r) && (fabsf(dz) < r);
+	}
+
+	if (overlap)
+	{
+		Candidates * candidates = get_payload<CandidatesPayload>();
+
+		if (candidates->count < Candidates::capacity)
+		{
+			candidates->partners[candidates->count] = j;
+		}
+		else
+		{
+			//	Rare: too many partners for the local list, fall back to a direct append.
+			appendPair(atomicAdd(broadPhaseParams.numPairs.data(), 1u), i, j);
+		}
+
+		candidates->count++;
+	}
+}
+
+
+__RT_KERNEL__ void __miss__broad_phase()
+{
+
+}
\ No newline at end of file
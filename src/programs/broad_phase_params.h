@@ -0,0 +1,60 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "broad_phase.h"
+#include "ray_types.h"
+#include <optix_types.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	**************************    BroadPhaseRayTypes    **************************
+	*****************************************************************************/
+
+	//!	Overlap query: a zero-length ray, only intersection programs are invoked.
+	struct BroadPhaseRay
+	{
+		static constexpr unsigned int rayFlags = OPTIX_RAY_FLAG_DISABLE_ANYHIT | OPTIX_RAY_FLAG_DISABLE_CLOSESTHIT;
+	};
+
+	//!	Ray types of the built-in broad-phase pipeline, shared by the raygen program and the SBT.
+	using BroadPhaseRayTypes = RayTypeTable<BroadPhaseRay>;
+
+	/*****************************************************************************
+	***************************    BroadPhaseParams    ***************************
+	*****************************************************************************/
+
+	//!	Launch parameters of the built-in broad-phase pipeline (see `broad_phase.cu`).
+	struct BroadPhaseParams
+	{
+		dev::Ptr<BroadPhase::ContactPair>		pairs;				//!	Output pairs, `capacity` elements.
+		dev::Ptr<unsigned int>					numPairs;			//!	Total number of pairs found (may exceed `capacity`).
+		dev::Ptr<const ns::float3_16a>			positions;			//!	Particle positions.
+		dev::Ptr<const float>					radii;				//!	[optional] Per-particle radius.
+		dev::Ptr<const unsigned int>			remap;				//!	[optional] Original index of each (sorted) particle.
+		OptixTraversableHandle					traversable;		//!	AABB GAS over all particles.
+		BroadPhase::Shape						shape;				//!	Overlap test.
+		unsigned int							capacity;			//!	Size of `pairs`.
+		float									radius;				//!	Uniform radius, used if `radii` is nullptr.
+	};
+}
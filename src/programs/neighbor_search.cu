@@ -0,0 +1,98 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "trace.cuh"
+#include "neighbor_search_params.h"
+#include <optix_device.h>
+
+PHOTON_USING_NAMESPACE
+
+__RT_CONSTANT__ NeighborSearchParams neighborSearchParams;
+
+//!	Number of neighbors found so far for the current ray, in payload 0.
+using CountPayload = Payload<unsigned int, 0>;
+
+
+//!	Original index of a (possibly sorted) point, CSR rows and entries always use original indices.
+__device__ __forceinline__ unsigned int originalIndex(unsigned int i)
+{
+	return (neighborSearchParams.remap != nullptr) ? neighborSearchParams.remap[i] : i;
+}
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+__RT_KERNEL__ void __raygen__neighbor_search()
+{
+	const unsigned int i = optixGetLaunchIndex().x;
+	const ns::float3_16a p = neighborSearchParams.positions[i];
+
+	CountPayload count = 0u;
+
+	trace<NeighborSearchRayTypes::Ray<NeighborSearchRay>>(neighborSearchParams.traversable, float3{ p.x, p.y, p.z }, float3{ 1.0f, 0.0f, 0.0f }, 0.0f, 1e-6f, count);
+
+	if (!neighborSearchParams.fillPass)
+	{
+		neighborSearchParams.counts[originalIndex(i)] = count;
+	}
+}
+
+
+__RT_KERNEL__ void __intersection__neighbor_search()
+{
+	const unsigned int i = optixGetLaunchIndex().x;
+	const unsigned int j = optixGetPrimitiveIndex();
+
+	if (j == i)		return;
+
+	unsigned int count = get_payload<0>();
+
+	if ((neighborSearchParams.maxNeighbors != 0) && (count >= neighborSearchParams.maxNeighbors))
+	{
+		return;
+	}
+
+	const ns::float3_16a pi = neighborSearchParams.positions[i];
+	const ns::float3_16a pj = neighborSearchParams.positions[j];
+	const float dx = pj.x - pi.x;
+	const float dy = pj.y - pi.y;
+	const float dz = pj.z - pi.z;
+	const float r = neighborSearchParams.radius;
+
+	if ((dx * dx + dy * dy + dz * dz) < (r * r))
+	{
+		//	Both passes see the same neighbors, so the fill pass writes exactly `counts[i]` entries.
+		if (neighborSearchParams.fillPass)
+		{
+			neighborSearchParams.indices[neighborSearchParams.offsets[originalIndex(i)] + count] = originalIndex(j);
+		}
+
+		set_payload<0>(count + 1);
+	}
+}
+
+
+__RT_KERNEL__ void __miss__neighbor_search()
+{
+
+}
\ No newline at end of file
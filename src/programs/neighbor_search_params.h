@@ -0,0 +1,62 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "fwd.h"
+#include "ray_types.h"
+#include <optix_types.h>
+#include <nucleus/vector_types.h>
+#include <nucleus/device_pointer.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	************************    NeighborSearchRayTypes    ************************
+	*****************************************************************************/
+
+	//!	Overlap query: a zero-length ray, only intersection programs are invoked.
+	struct NeighborSearchRay
+	{
+		static constexpr unsigned int rayFlags = OPTIX_RAY_FLAG_DISABLE_ANYHIT | OPTIX_RAY_FLAG_DISABLE_CLOSESTHIT;
+	};
+
+	//!	Ray types of the built-in neighbor-search pipeline, shared by the raygen program and the SBT.
+	using NeighborSearchRayTypes = RayTypeTable<NeighborSearchRay>;
+
+	/*****************************************************************************
+	*************************    NeighborSearchParams    *************************
+	*****************************************************************************/
+
+	//!	Launch parameters of the built-in neighbor-search pipeline (see `neighbor_search.cu`).
+	struct NeighborSearchParams
+	{
+		dev::Ptr<unsigned int>					counts;				//!	Count pass: number of neighbors of each point.
+		dev::Ptr<const unsigned int>			offsets;			//!	Fill pass: CSR offsets.
+		dev::Ptr<unsigned int>					indices;			//!	Fill pass: CSR neighbor indices.
+		dev::Ptr<const ns::float3_16a>			positions;			//!	Point positions.
+		dev::Ptr<const unsigned int>			remap;				//!	[optional] Original index of each (sorted) point.
+		OptixTraversableHandle					traversable;		//!	AABB GAS over all points.
+		unsigned int							maxNeighbors;		//!	Cap of each list (0 for unlimited).
+		unsigned int							fillPass;			//!	0 for the count pass, 1 for the fill pass.
+		float									radius;				//!	Search radius.
+	};
+}
\ No newline at end of file
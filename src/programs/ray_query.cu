@@ -0,0 +1,78 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "trace.cuh"
+#include "ray_query_params.h"
+#include <optix_device.h>
+
+PHOTON_USING_NAMESPACE
+
+__RT_CONSTANT__ RayQueryParams rayQueryParams;
+
+//!	Closest hit of the current ray, in payloads 0-4.
+using HitPayload = Payload<RayQueryHit, 0, 1, 2, 3, 4>;
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+__RT_KERNEL__ void __raygen__ray_query()
+{
+	const unsigned long long i = rayQueryParams.chunk.offset + optixGetLaunchIndex().x;
+	const ns::float3 origin = rayQueryParams.origins[i];
+	const ns::float3 direction = rayQueryParams.directions[i];
+	const float tmin = (rayQueryParams.tmins != nullptr) ? rayQueryParams.tmins[i] : rayQueryParams.tmin;
+	const float tmax = (rayQueryParams.tmaxs != nullptr) ? rayQueryParams.tmaxs[i] : rayQueryParams.tmax;
+
+	HitPayload payload = RayQueryHit{ RayQueryEngine::missDistance, RayQueryEngine::invalidIndex, RayQueryEngine::invalidIndex, 0.0f, 0.0f };
+
+	trace<RayQueryRayTypes::Ray<RayQueryRay>>(rayQueryParams.traversable, float3{ origin.x, origin.y, origin.z }, float3{ direction.x, direction.y, direction.z }, tmin, tmax, payload);
+
+	//	Unrequested attributes are skipped, the output is bandwidth bound.
+	const RayQueryHit hit = payload;
+
+	if (rayQueryParams.t != nullptr)				rayQueryParams.t[i] = hit.t;
+	if (rayQueryParams.primIndices != nullptr)		rayQueryParams.primIndices[i] = hit.primIndex;
+	if (rayQueryParams.instanceIds != nullptr)		rayQueryParams.instanceIds[i] = hit.instanceId;
+	if (rayQueryParams.barycentrics != nullptr)		rayQueryParams.barycentrics[i] = ns::float2{ hit.u, hit.v };
+}
+
+
+__RT_KERNEL__ void __closesthit__ray_query()
+{
+	const float2 barycentrics = optixGetTriangleBarycentrics();
+
+	RayQueryHit hit;
+	hit.t = optixGetRayTmax();
+	hit.primIndex = optixGetPrimitiveIndex();
+	hit.instanceId = (optixGetTransformListSize() > 0) ? optixGetInstanceId() : RayQueryEngine::invalidIndex;
+	hit.u = barycentrics.x;
+	hit.v = barycentrics.y;
+
+	set_payload(HitPayload(hit));
+}
+
+
+__RT_KERNEL__ void __miss__ray_query()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "ray_query.h"
+#include "ray_types.h"
+#include "launch_chunk.h"
+#include <optix_types.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	***************************    RayQueryRayTypes    ***************************
+	*****************************************************************************/
+
+	//!	Closest-hit query, there is no any-hit program.
+	struct RayQueryRay
+	{
+		static constexpr unsigned int rayFlags = OPTIX_RAY_FLAG_DISABLE_ANYHIT;
+	};
+
+	//!	Ray types of the built-in ray-query pipeline, shared by the raygen program and the SBT.
+	using RayQueryRayTypes = RayTypeTable<RayQueryRay>;
+
+	/*****************************************************************************
+	*****************************    RayQueryHit    ******************************
+	*****************************************************************************/
+
+	//!	Closest hit of a ray, carried in payload slots 0-4.
+	struct RayQueryHit
+	{
+		float									t;
+		unsigned int							primIndex;
+		unsigned int							instanceId;
+		float									u, v;
+	};
+
+	/*****************************************************************************
+	****************************    RayQueryParams    ****************************
+	*****************************************************************************/
+
+	//!	Launch parameters of the built-in ray-query pipeline (see `ray_query.cu`).
+	struct RayQueryParams
+	{
+		LaunchChunk								chunk;				//!	Rays of this launch, written by `launchChunked()`.
+		dev::Ptr<const ns::float3>				origins;			//!	Ray origins.
+		dev::Ptr<const ns::float3>				directions;			//!	Ray directions.
+		dev::Ptr<const float>					tmins;				//!	[optional] Per-ray minimum distance.
+		dev::Ptr<const float>					tmaxs;				//!	[optional] Per-ray maximum distance.
+		dev::Ptr<float>							t;					//!	[optional] Hit distances.
+		dev::Ptr<unsigned int>					primIndices;		//!	[optional] Primitive indices.
+		dev::Ptr<unsigned int>					instanceIds;		//!	[optional] Instance IDs.
+		dev::Ptr<ns::float2>					barycentrics;		//!	[optional] Triangle barycentrics.
+		OptixTraversableHandle					traversable;		//!	Scene to trace against.
+		float									tmin;				//!	Minimum distance, used if `tmins` is nullptr.
+		float									tmax;				//!	Maximum distance, used if `tmaxs` is nullptr.
+	};
+}
\ No newline at end of file
@@ -0,0 +1,403 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "ray_query_impl.h"
+#include "pipeline_impl.h"
+#include "profiler.h"
+#include "ray_query.optixir.h"
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/logger.h>
+#include <string.h>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+****************************    RayQueryEngineImpl    ****************************
+*********************************************************************************/
+
+RayQueryEngineImpl::StagingLayout::StagingLayout(size_t capacity)
+{
+	//	Attributes are aligned to 16 bytes, the parameters to what OptiX expects.
+	bytes = 0;
+	origins = bytes;			bytes += ns::align_up(capacity * sizeof(ns::float3), 16);
+	directions = bytes;			bytes += ns::align_up(capacity * sizeof(ns::float3), 16);
+	tmins = bytes;				bytes += ns::align_up(capacity * sizeof(float), 16);
+	tmaxs = bytes;				bytes += ns::align_up(capacity * sizeof(float), 16);
+	t = bytes;					bytes += ns::align_up(capacity * sizeof(float), 16);
+	primIndices = bytes;		bytes += ns::align_up(capacity * sizeof(unsigned int), 16);
+	instanceIds = bytes;		bytes += ns::align_up(capacity * sizeof(unsigned int), 16);
+	barycentrics = bytes;		bytes += ns::align_up(capacity * sizeof(ns::float2), OPTIX_SBT_RECORD_ALIGNMENT);
+	params = bytes;				bytes += sizeof(RayQueryParams);
+}
+
+
+RayQueryEngineImpl::RayQueryEngineImpl(std::shared_ptr<DeviceContext> deviceContext)
+	: m_batchSize(1 << 18), m_stagingCapacity(0), m_numSbtEntries(0), m_sbt{}, m_ready(nullptr), m_deviceContext(deviceContext)
+{
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.numPayloadValues = 5;
+	pipelineCompileOptions.numAttributeValues = 2;
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "rayQueryParams";
+	pipelineCompileOptions.traversableGraphFlags = OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_ANY;
+	pipelineCompileOptions.usesPrimitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_TRIANGLE;
+
+	OptixPipelineLinkOptions pipelineLinkOptions = {};
+	pipelineLinkOptions.maxTraceDepth = 1;
+
+	auto module = m_deviceContext->createModule(ray_query_optixir, pipelineCompileOptions);
+	auto raygenProg = module->at("__raygen__ray_query");
+	auto closesthitProg = module->at("__closesthit__ray_query");
+	auto missProg = module->at("__miss__ray_query");
+
+	//	Program groups are kept alive as long as the pipeline.
+	m_programs = { raygenProg, missProg, closesthitProg };
+	m_pipeline = std::make_unique<Pipeline>(SharedContext(m_deviceContext), m_programs, pipelineCompileOptions, pipelineLinkOptions);
+
+	auto & stream = m_deviceContext->device()->defaultStream();
+
+	this->reserveSbt(stream, 1);
+}
+
+
+void RayQueryEngineImpl::reserveSbt(ns::Stream & stream, unsigned int numSbtEntries)
+{
+	if (numSbtEntries <= m_numSbtEntries)
+	{
+		return;
+	}
+
+	//	SBT records: [0] raygen, [1] miss, [2...] one hit group per SBT entry, all the same program.
+	const unsigned int numHitRecords = RayQueryRayTypes::hitgroupRecordCount(numSbtEntries);
+
+	std::vector<EmptyRecord> records(2 + numHitRecords);
+	records[0].header = m_programs[0]->header();
+	records[1].header = m_programs[1]->header();
+
+	for (unsigned int i = 0; i < numHitRecords; i++)
+	{
+		records[2 + i].header = m_programs[2]->header();
+	}
+
+	//	The old records may still be read by queries in flight.
+	stream.sync();
+
+	m_sbtRecords.resize(m_deviceContext->device()->defaultAllocator(), records.size());
+
+	stream.memcpy(m_sbtRecords.data(), records.data(), records.size()).sync();
+
+	m_sbt.raygenRecord					= (CUdeviceptr)(m_sbtRecords.data() + 0);
+	m_sbt.missRecordBase				= (CUdeviceptr)(m_sbtRecords.data() + 1);
+	m_sbt.missRecordStrideInBytes		= sizeof(EmptyRecord);
+	m_sbt.missRecordCount				= RayQueryRayTypes::missRecordCount;
+	m_sbt.hitgroupRecordBase			= (CUdeviceptr)(m_sbtRecords.data() + 2);
+	m_sbt.hitgroupRecordStrideInBytes	= sizeof(EmptyRecord);
+	m_sbt.hitgroupRecordCount			= numHitRecords;
+
+	m_numSbtEntries = numSbtEntries;
+}
+
+
+size_t RayQueryEngineImpl::batchSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_batchSize;
+}
+
+
+void RayQueryEngineImpl::setBatchSize(size_t batchSize)
+{
+	if ((batchSize == 0) || (batchSize > maxLaunchSize))
+	{
+		NS_ERROR_LOG("Invalid batch size: %zu.", batchSize);
+
+		throw OPTIX_ERROR_INVALID_VALUE;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_batchSize = batchSize;
+}
+
+
+void RayQueryEngineImpl::query(ns::Stream & stream, OptixTraversableHandle traversable, const Rays & rays, const Hits & hits, unsigned int numSbtEntries)
+{
+	if (rays.count == 0)
+	{
+		return;
+	}
+
+	NS_ASSERT((rays.origins != nullptr) && (rays.directions != nullptr));
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	this->reserveSbt(stream, numSbtEntries);
+
+	RayQueryParams params = {};
+	params.origins = rays.origins;
+	params.directions = rays.directions;
+	params.tmins = rays.tmins;
+	params.tmaxs = rays.tmaxs;
+	params.t = hits.t;
+	params.primIndices = hits.primIndices;
+	params.instanceIds = hits.instanceIds;
+	params.barycentrics = hits.barycentrics;
+	params.traversable = traversable;
+	params.tmin = rays.tmin;
+	params.tmax = rays.tmax;
+
+	m_pipeline->launchChunked<RayQueryParams>(stream, params, &RayQueryParams::chunk, m_sbt, rays.count);
+}
+
+
+void RayQueryEngineImpl::reserveStaging()
+{
+	if ((m_ready != nullptr) && (m_stagingCapacity == m_batchSize))
+	{
+		return;
+	}
+
+	ScopedDevice scopedDevice(m_deviceContext->device()->id());
+
+	if (m_ready == nullptr)
+	{
+		cudaError_t err = cudaEventCreateWithFlags(&m_ready, cudaEventDisableTiming);
+
+		for (size_t i = 0; (i < m_slots.size()) && (err == cudaSuccess); i++)
+		{
+			err = cudaStreamCreateWithFlags(&m_slots[i].stream, cudaStreamNonBlocking);
+
+			if (err == cudaSuccess)		err = cudaEventCreateWithFlags(&m_slots[i].finished, cudaEventDisableTiming);
+		}
+
+		if (err != cudaSuccess)
+		{
+			NS_ERROR_LOG("Failed to create streams of ray queries: %s.", cudaGetErrorString(err));
+
+			for (auto & slot : m_slots)
+			{
+				if (slot.stream != nullptr)		cudaStreamDestroy(slot.stream);
+				if (slot.finished != nullptr)	cudaEventDestroy(slot.finished);
+
+				slot.stream = nullptr;
+				slot.finished = nullptr;
+			}
+
+			if (m_ready != nullptr)		cudaEventDestroy(m_ready);
+
+			m_ready = nullptr;
+
+			throw OPTIX_ERROR_CUDA_ERROR;
+		}
+	}
+
+	if (m_stagingCapacity == m_batchSize)
+	{
+		return;
+	}
+
+	//	No batch is in flight between two calls of `queryHost()`, device buffers are replaced by `resize()`.
+	this->releaseStaging();
+
+	const StagingLayout layout(m_batchSize);
+
+	for (auto & slot : m_slots)
+	{
+		if (cudaMallocHost(&slot.hostStaging, layout.bytes) != cudaSuccess)
+		{
+			NS_ERROR_LOG("Failed to allocate staging buffers of ray queries.");
+
+			this->releaseStaging();
+
+			throw OPTIX_ERROR_HOST_OUT_OF_MEMORY;
+		}
+
+		slot.devStaging.resize(m_deviceContext->device()->defaultAllocator(), layout.bytes);
+	}
+
+	m_stagingCapacity = m_batchSize;
+}
+
+
+void RayQueryEngineImpl::releaseStaging()
+{
+	for (auto & slot : m_slots)
+	{
+		cudaFreeHost(slot.hostStaging);
+
+		slot.hostStaging = nullptr;
+	}
+
+	m_stagingCapacity = 0;
+}
+
+
+void RayQueryEngineImpl::queryHost(ns::Stream & stream, OptixTraversableHandle traversable, const HostRays & rays, const HostHits & hits, unsigned int numSbtEntries)
+{
+	if (rays.count == 0)
+	{
+		return;
+	}
+
+	NS_ASSERT((rays.origins != nullptr) && (rays.directions != nullptr));
+
+	//	Held until all hits are written: the staging slots serve one call at a time.
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	this->reserveSbt(stream, numSbtEntries);
+
+	this->reserveStaging();
+
+	const StagingLayout layout(m_stagingCapacity);
+
+	//	Batches are launched on internal streams, the caller stream only brackets them: the scope ends once
+	//	all hits are downloaded, so the recorded duration covers staging, tracing and copies.
+	Profiler::Scope scope(m_deviceContext->profiler(), stream, "optixLaunch (host rays)", this);
+
+	//	Batches start after the work already enqueued on the caller stream.
+	cudaEventRecord(m_ready, stream.handle());
+
+	for (auto & slot : m_slots)
+	{
+		cudaStreamWaitEvent(slot.stream, m_ready, 0);
+	}
+
+	const size_t numBatches = ns::ceil_div(rays.count, m_stagingCapacity);
+
+	for (size_t batch = 0; batch < numBatches; batch++)
+	{
+		Slot & slot = m_slots[batch % numSlots];
+
+		//	The other slot is traced meanwhile, so staging this batch overlaps its execution.
+		this->retire(slot, hits);
+
+		const size_t offset = batch * m_stagingCapacity;
+		const size_t count = NS_MIN(m_stagingCapacity, rays.count - offset);
+
+		unsigned char * host = slot.hostStaging;
+		unsigned char * dev = slot.devStaging.data();
+
+		auto upload = [&](size_t layoutOffset, const void * src, size_t elementSize)
+		{
+			memcpy(host + layoutOffset, static_cast<const unsigned char*>(src) + offset * elementSize, count * elementSize);
+
+			cudaMemcpyAsync(dev + layoutOffset, host + layoutOffset, count * elementSize, cudaMemcpyHostToDevice, slot.stream);
+		};
+
+		upload(layout.origins, rays.origins, sizeof(ns::float3));
+		upload(layout.directions, rays.directions, sizeof(ns::float3));
+
+		if (rays.tmins != nullptr)		upload(layout.tmins, rays.tmins, sizeof(float));
+		if (rays.tmaxs != nullptr)		upload(layout.tmaxs, rays.tmaxs, sizeof(float));
+
+		RayQueryParams & params = *reinterpret_cast<RayQueryParams*>(host + layout.params);
+		params = {};
+		params.chunk.offset = 0;
+		params.chunk.count = count;
+		params.origins = dev::Ptr<const ns::float3>(reinterpret_cast<const ns::float3*>(dev + layout.origins), count);
+		params.directions = dev::Ptr<const ns::float3>(reinterpret_cast<const ns::float3*>(dev + layout.directions), count);
+		params.tmins = (rays.tmins != nullptr) ? dev::Ptr<const float>(reinterpret_cast<const float*>(dev + layout.tmins), count) : nullptr;
+		params.tmaxs = (rays.tmaxs != nullptr) ? dev::Ptr<const float>(reinterpret_cast<const float*>(dev + layout.tmaxs), count) : nullptr;
+		params.t = (hits.t != nullptr) ? dev::Ptr<float>(reinterpret_cast<float*>(dev + layout.t), count) : nullptr;
+		params.primIndices = (hits.primIndices != nullptr) ? dev::Ptr<unsigned int>(reinterpret_cast<unsigned int*>(dev + layout.primIndices), count) : nullptr;
+		params.instanceIds = (hits.instanceIds != nullptr) ? dev::Ptr<unsigned int>(reinterpret_cast<unsigned int*>(dev + layout.instanceIds), count) : nullptr;
+		params.barycentrics = (hits.barycentrics != nullptr) ? dev::Ptr<ns::float2>(reinterpret_cast<ns::float2*>(dev + layout.barycentrics), count) : nullptr;
+		params.traversable = traversable;
+		params.tmin = rays.tmin;
+		params.tmax = rays.tmax;
+
+		cudaMemcpyAsync(dev + layout.params, host + layout.params, sizeof(RayQueryParams), cudaMemcpyHostToDevice, slot.stream);
+
+		OptixResult err = optixLaunch(m_pipeline->handle(), slot.stream, CUdeviceptr(dev + layout.params), sizeof(RayQueryParams), &m_sbt, static_cast<unsigned int>(count), 1, 1);
+
+		if (err != OPTIX_SUCCESS)
+		{
+			NS_ERROR_LOG("%s.", optixGetErrorString(err));
+
+			//	Drop the batches in flight, their hits are not copied back.
+			for (auto & other : m_slots)
+			{
+				cudaStreamSynchronize(other.stream);
+
+				other.pendingCount = 0;
+			}
+
+			throw err;
+		}
+
+		if (hits.t != nullptr)				cudaMemcpyAsync(host + layout.t, dev + layout.t, count * sizeof(float), cudaMemcpyDeviceToHost, slot.stream);
+		if (hits.primIndices != nullptr)	cudaMemcpyAsync(host + layout.primIndices, dev + layout.primIndices, count * sizeof(unsigned int), cudaMemcpyDeviceToHost, slot.stream);
+		if (hits.instanceIds != nullptr)	cudaMemcpyAsync(host + layout.instanceIds, dev + layout.instanceIds, count * sizeof(unsigned int), cudaMemcpyDeviceToHost, slot.stream);
+		if (hits.barycentrics != nullptr)	cudaMemcpyAsync(host + layout.barycentrics, dev + layout.barycentrics, count * sizeof(ns::float2), cudaMemcpyDeviceToHost, slot.stream);
+
+		cudaEventRecord(slot.finished, slot.stream);
+
+		slot.pendingOffset = offset;
+		slot.pendingCount = count;
+	}
+
+	for (auto & slot : m_slots)
+	{
+		this->retire(slot, hits);
+	}
+}
+
+
+void RayQueryEngineImpl::retire(Slot & slot, const HostHits & hits)
+{
+	if (slot.pendingCount == 0)
+	{
+		return;
+	}
+
+	cudaEventSynchronize(slot.finished);
+
+	const StagingLayout layout(m_stagingCapacity);
+	const size_t offset = slot.pendingOffset;
+	const size_t count = slot.pendingCount;
+
+	if (hits.t != nullptr)				memcpy(hits.t + offset, slot.hostStaging + layout.t, count * sizeof(float));
+	if (hits.primIndices != nullptr)	memcpy(hits.primIndices + offset, slot.hostStaging + layout.primIndices, count * sizeof(unsigned int));
+	if (hits.instanceIds != nullptr)	memcpy(hits.instanceIds + offset, slot.hostStaging + layout.instanceIds, count * sizeof(unsigned int));
+	if (hits.barycentrics != nullptr)	memcpy(hits.barycentrics + offset, slot.hostStaging + layout.barycentrics, count * sizeof(ns::float2));
+
+	slot.pendingCount = 0;
+}
+
+
+RayQueryEngineImpl::~RayQueryEngineImpl()
+{
+	if (m_ready != nullptr)
+	{
+		for (auto & slot : m_slots)
+		{
+			cudaStreamSynchronize(slot.stream);
+			cudaStreamDestroy(slot.stream);
+			cudaEventDestroy(slot.finished);
+		}
+
+		cudaEventDestroy(m_ready);
+	}
+
+	this->releaseStaging();
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "pipeline.h"
+#include "ray_query.h"
+#include "device_context.h"
+#include "ray_query_params.h"
+#include <nucleus/array_1d.h>
+#include <cuda_runtime.h>
+#include <vector>
+#include <array>
+#include <mutex>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	**************************    RayQueryEngineImpl    **************************
+	*****************************************************************************/
+
+	class RayQueryEngineImpl : public RayQueryEngine
+	{
+
+	public:
+
+		RayQueryEngineImpl(std::shared_ptr<DeviceContext> deviceContext);
+
+		virtual ~RayQueryEngineImpl();
+
+	public:
+
+		virtual size_t batchSize() const override;
+		virtual std::shared_ptr<class DeviceContext> deviceContext() const override { return m_deviceContext; }
+		virtual void setBatchSize(size_t batchSize) override;
+		virtual void query(ns::Stream & stream, OptixTraversableHandle traversable, const Rays & rays, const Hits & hits, unsigned int numSbtEntries) override;
+		virtual void queryHost(ns::Stream & stream, OptixTraversableHandle traversable, const HostRays & rays, const HostHits & hits, unsigned int numSbtEntries) override;
+
+	private:
+
+		//!	Byte offsets of the attributes within a staging buffer of `capacity` rays, the same on host and device.
+		struct StagingLayout
+		{
+			explicit StagingLayout(size_t capacity);
+
+			size_t		origins, directions, tmins, tmaxs, t, primIndices, instanceIds, barycentrics, params, bytes;
+		};
+
+		//!	One of the two batches in flight of `queryHost()`.
+		struct Slot
+		{
+			cudaStream_t					stream = nullptr;
+			cudaEvent_t						finished = nullptr;			//!	Download of the pending batch completed.
+			unsigned char *					hostStaging = nullptr;		//!	Pinned, laid out as `StagingLayout`.
+			ns::Array<unsigned char>		devStaging;
+			size_t							pendingOffset = 0;			//!	First ray of the batch being traced.
+			size_t							pendingCount = 0;			//!	Zero if no batch is in flight.
+		};
+
+		//!	Grow the hit group records to cover `numSbtEntries`.
+		void reserveSbt(ns::Stream & stream, unsigned int numSbtEntries);
+
+		//!	Create the streams and allocate the staging buffers for `m_batchSize` rays.
+		void reserveStaging();
+
+		//!	Wait for the pending batch of `slot` and copy its hits to `hits`.
+		void retire(Slot & slot, const HostHits & hits);
+
+		void releaseStaging();
+
+	private:
+
+		static constexpr unsigned int				numSlots = 2;
+
+		mutable std::mutex							m_mutex;				//!	Guards the SBT, the batch size and the staging slots.
+		size_t										m_batchSize;
+		size_t										m_stagingCapacity;		//!	Rays per slot of the current staging buffers.
+		unsigned int								m_numSbtEntries;
+		OptixShaderBindingTable						m_sbt;
+		ns::Array<EmptyRecord>						m_sbtRecords;
+		std::array<Slot, numSlots>					m_slots;
+		cudaEvent_t									m_ready;				//!	Work enqueued before `queryHost()` on the caller stream.
+		std::vector<std::shared_ptr<Program>>		m_programs;
+		std::unique_ptr<Pipeline>					m_pipeline;
+		const std::shared_ptr<DeviceContext>		m_deviceContext;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "accel_struct.h"
+#include "spatial_sort_impl.h"
+#include <nucleus/stream.h>
+#include <nucleus/logger.h>
+#include <nucleus/launch_utils.cuh>
+#include <cub/device/device_radix_sort.cuh>
+
+PHOTON_USING_NAMESPACE
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+namespace kernels
+{
+	//!	Monotonic mapping of floats to unsigned integers, so that bounds can be reduced with integer atomics.
+	__device__ __forceinline__ unsigned int OrderedBits(float value)
+	{
+		unsigned int bits = __float_as_uint(value);
+
+		return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	}
+
+
+	__device__ __forceinline__ float OrderedFloat(unsigned int bits)
+	{
+		return __uint_as_float((bits & 0x80000000u) ? (bits & 0x7FFFFFFFu) : ~bits);
+	}
+
+
+	//!	Spread the lower 21 bits of `v` so that there are two zero bits between each of them.
+	__host__ __device__ __forceinline__ uint64_t ExpandBits(uint64_t v)
+	{
+		v &= 0x1FFFFF;
+		v = (v | (v << 32)) & 0x1F00000000FFFFull;
+		v = (v | (v << 16)) & 0x1F0000FF0000FFull;
+		v = (v | (v << 8))  & 0x100F00F00F00F00Full;
+		v = (v | (v << 4))  & 0x10C30C30C30C30C3ull;
+		v = (v | (v << 2))  & 0x1249249249249249ull;
+		return v;
+	}
+
+
+	__host__ __device__ __forceinline__ uint64_t MortonKey(unsigned int x, unsigned int y, unsigned int z)
+	{
+		return (ExpandBits(x) << 2) | (ExpandBits(y) << 1) | ExpandBits(z);
+	}
+
+
+	//!	Hilbert key of a 21-bit cell, see J. Skilling, "Programming the Hilbert curve" (AxesToTranspose).
+	__host__ __device__ __forceinline__ uint64_t HilbertKey(unsigned int x, unsigned int y, unsigned int z)
+	{
+		unsigned int X[3] = { x, y, z };
+
+		//	Inverse undo.
+		for (unsigned int Q = 1u << 20; Q > 1; Q >>= 1)
+		{
+			unsigned int P = Q - 1;
+
+			for (int i = 0; i < 3; i++)
+			{
+				if (X[i] & Q)
+				{
+					X[0] ^= P;
+				}
+				else
+				{
+					unsigned int t = (X[0] ^ X[i]) & P;
+					X[0] ^= t;
+					X[i] ^= t;
+				}
+			}
+		}
+
+		//	Gray encode.
+		X[1] ^= X[0];
+		X[2] ^= X[1];
+
+		unsigned int t = 0;
+
+		for (unsigned int Q = 1u << 20; Q > 1; Q >>= 1)
+		{
+			if (X[2] & Q)
+			{
+				t ^= Q - 1;
+			}
+		}
+
+		X[0] ^= t;
+		X[1] ^= t;
+		X[2] ^= t;
+
+		//	Transposed form to key: bits of X[0] are the most significant of each triplet.
+		return MortonKey(X[0], X[1], X[2]);
+	}
+
+
+	__global__ void ComputeBounds(dev::Ptr<unsigned int> bounds, dev::Ptr<const ns::float3_16a> points, unsigned int count)
+	{
+		const unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+		const ns::float3_16a p = points[NS_MIN(i, count - 1)];
+
+		float lower[3] = { p.x, p.y, p.z };
+		float upper[3] = { p.x, p.y, p.z };
+
+		//	Warp reduction first, one atomic per warp and component.
+		for (int offset = 16; offset > 0; offset >>= 1)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				lower[k] = fminf(lower[k], __shfl_xor_sync(0xFFFFFFFFu, lower[k], offset));
+				upper[k] = fmaxf(upper[k], __shfl_xor_sync(0xFFFFFFFFu, upper[k], offset));
+			}
+		}
+
+		if ((threadIdx.x & 31) == 0)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				atomicMin(&bounds[k], OrderedBits(lower[k]));
+				atomicMax(&bounds[k + 3], OrderedBits(upper[k]));
+			}
+		}
+	}
+
+
+	__global__ void ComputeKeys(dev::Ptr<uint64_t> keys, dev::Ptr<unsigned int> indices, dev::Ptr<const ns::float3_16a> points, dev::Ptr<const unsigned int> bounds, SpatialSort::Curve curve, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		const ns::float3_16a p = points[i];
+		const float lower[3] = { OrderedFloat(bounds[0]), OrderedFloat(bounds[1]), OrderedFloat(bounds[2]) };
+		const float upper[3] = { OrderedFloat(bounds[3]), OrderedFloat(bounds[4]), OrderedFloat(bounds[5]) };
+		const float extent = fmaxf(fmaxf(upper[0] - lower[0], upper[1] - lower[1]), fmaxf(upper[2] - lower[2], 1e-30f));
+
+		//	Uniform scale keeps cells cubic, so that the curve preserves isotropic locality.
+		const float scale = float((1u << 21) - 1) / extent;
+		const unsigned int x = static_cast<unsigned int>(fminf(fmaxf((p.x - lower[0]) * scale, 0.0f), float((1u << 21) - 1)));
+		const unsigned int y = static_cast<unsigned int>(fminf(fmaxf((p.y - lower[1]) * scale, 0.0f), float((1u << 21) - 1)));
+		const unsigned int z = static_cast<unsigned int>(fminf(fmaxf((p.z - lower[2]) * scale, 0.0f), float((1u << 21) - 1)));
+
+		keys[i] = (curve == SpatialSort::Hilbert) ? HilbertKey(x, y, z) : MortonKey(x, y, z);
+		indices[i] = i;
+	}
+
+
+	__global__ void Permute(uint32_t * dst, const uint32_t * src, dev::Ptr<const unsigned int> permutation, unsigned int numWords, bool scatter, unsigned int count)
+	{
+		CUDA_for(i, count);
+
+		const size_t from = size_t(scatter ? i : permutation[i]) * numWords;
+		const size_t to = size_t(scatter ? permutation[i] : i) * numWords;
+
+		for (unsigned int k = 0; k < numWords; k++)
+		{
+			dst[to + k] = src[from + k];
+		}
+	}
+}
+
+/*********************************************************************************
+*****************************    SpatialSortImpl    ******************************
+*********************************************************************************/
+
+SpatialSortImpl::SpatialSortImpl(std::shared_ptr<DeviceContext> deviceContext) : m_count(0), m_current(0), m_deviceContext(deviceContext)
+{
+
+}
+
+
+void SpatialSortImpl::sort(ns::Stream & stream, ns::AllocPtr allocator, dev::Ptr<const ns::float3_16a> points, unsigned int count, Curve curve)
+{
+	m_count = count;
+	m_current = 0;
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (m_keys[0].size() < count)
+	{
+		for (int k = 0; k < 2; k++)
+		{
+			m_keys[k].resize(allocator, count);
+			m_indices[k].resize(allocator, count);
+		}
+	}
+
+	m_bounds.resize(allocator, 6);
+
+	//	Empty bounds: lower = max, upper = min (in ordered bits).
+	stream.memset(m_bounds.data(), 0xFF, 3 * sizeof(unsigned int));
+	stream.memset(m_bounds.data() + 3, 0x00, 3 * sizeof(unsigned int));
+
+	stream.launch(kernels::ComputeBounds, ns::ceil_div(count, 256), 256)(m_bounds, points, count);
+	stream.launch(kernels::ComputeKeys, ns::ceil_div(count, 256), 256)(m_keys[0], m_indices[0], points, m_bounds, curve, count);
+
+	cub::DoubleBuffer<uint64_t> keys(m_keys[0].data(), m_keys[1].data());
+	cub::DoubleBuffer<unsigned int> values(m_indices[0].data(), m_indices[1].data());
+
+	size_t sortTempBytes = 0;
+	cub::DeviceRadixSort::SortPairs(nullptr, sortTempBytes, keys, values, count, 0, 63, stream.handle());
+
+	if (m_sortTemp.size() < sortTempBytes)
+	{
+		m_sortTemp.resize(allocator, sortTempBytes);
+	}
+
+	cub::DeviceRadixSort::SortPairs(m_sortTemp.data(), sortTempBytes, keys, values, count, 0, 63, stream.handle());
+
+	m_current = keys.selector;
+}
+
+
+void SpatialSortImpl::writeRemap(ns::Stream & stream, GeomAccelStruct & accelStruct) const
+{
+	auto header = accelStruct.headerBuffer();
+
+	if (header.size() < remapHeaderSize(m_count))
+	{
+		NS_ERROR_LOG("GAS header is too small for the primitive remap (%zu < %zu bytes)!", header.size(), remapHeaderSize(m_count));
+
+		return;
+	}
+
+	stream.memcpy<void>(header.data(), m_indices[m_current].data(), remapHeaderSize(m_count));
+}
+
+
+void SpatialSortImpl::permute(ns::Stream & stream, void * dst, const void * src, unsigned int numWords, bool scatter) const
+{
+	if (m_count == 0)
+	{
+		return;
+	}
+
+	stream.launch(kernels::Permute, ns::ceil_div(m_count, 256), 256)(static_cast<uint32_t*>(dst), static_cast<const uint32_t*>(src), this->permutation(), numWords, scatter, m_count);
+}
+
+
+SpatialSortImpl::~SpatialSortImpl()
+{
+
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include "spatial_sort.h"
+#include "device_context.h"
+#include <nucleus/array_1d.h>
+
+namespace PHOTON_NAMESPACE
+{
+	/*****************************************************************************
+	***************************    SpatialSortImpl    ****************************
+	*****************************************************************************/
+
+	class SpatialSortImpl : public SpatialSort
+	{
+
+	public:
+
+		SpatialSortImpl(std::shared_ptr<DeviceContext> deviceContext);
+
+		virtual ~SpatialSortImpl();
+
+	public:
+
+		virtual unsigned int size() const override { return m_count; }
+		virtual dev::Ptr<const uint64_t> sortedKeys() const override { return dev::Ptr<const uint64_t>(m_keys[m_current].data(), m_count); }
+		virtual dev::Ptr<const unsigned int> permutation() const override { return dev::Ptr<const unsigned int>(m_indices[m_current].data(), m_count); }
+		virtual std::shared_ptr<class DeviceContext> deviceContext() const override { return m_deviceContext; }
+		virtual void sort(ns::Stream & stream, ns::AllocPtr allocator, dev::Ptr<const ns::float3_16a> points, unsigned int count, Curve curve) override;
+		virtual void writeRemap(ns::Stream & stream, GeomAccelStruct & accelStruct) const override;
+
+	protected:
+
+		virtual void permute(ns::Stream & stream, void * dst, const void * src, unsigned int numWords, bool scatter) const override;
+
+	private:
+
+		unsigned int								m_count;
+		unsigned int								m_current;
+		ns::Array<unsigned int>						m_bounds;
+		ns::Array<uint64_t>							m_keys[2];
+		ns::Array<unsigned int>						m_indices[2];
+		ns::Array<unsigned char>					m_sortTemp;
+		const std::shared_ptr<DeviceContext>		m_deviceContext;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <random>
+#include <cstring>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/aabb_utils.h>
+#include <photon/accel_struct.h>
+#include <photon/device_context.h>
+
+/*********************************************************************************
+*****************************    aabb_utils_test    ******************************
+*********************************************************************************/
+
+void aabb_utils_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	//	Several times the per-thread minimum of the host path, so that it is split across threads.
+	const size_t count = 4 * 16384 + 123;
+	std::default_random_engine e;
+	std::uniform_real_distribution<float> d;
+	std::vector<ns::float3_16a> points(count);
+	std::vector<float> radii(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		points[i] = ns::float3_16a{ d(e), d(e), d(e) };
+		radii[i] = 1e-3f * d(e);
+	}
+
+	//	host path, threaded and scalar
+	std::vector<pt::Aabb> hostAabbs(count);
+	std::vector<pt::Aabb> scalarAabbs(count);
+	pt::computePointAabbs(hostAabbs.data(), points.data(), radii.data(), 1e-2f, count, 4);
+	pt::computePointAabbs(scalarAabbs.data(), points.data(), radii.data(), 1e-2f, count, 1);
+
+	assert(memcmp(hostAabbs.data(), scalarAabbs.data(), count * sizeof(pt::Aabb)) == 0);
+
+	//	device path
+	ns::Array<float>				devRadii(allocator, count);
+	ns::Array<ns::float3_16a>		devPoints(allocator, count);
+	ns::Array<pt::Aabb>				devAabbs(allocator, count);
+	stream.memcpy(devRadii.data(), radii.data(), count);
+	stream.memcpy(devPoints.data(), points.data(), count);
+
+	pt::AabbSource source;
+	source.type = pt::AabbSource::Spheres;
+	source.vertexBuffer = devPoints;
+	source.radiusBuffer = devRadii;
+	source.radius = 1e-2f;
+	source.numPrimitives = static_cast<unsigned int>(count);
+	pt::computeAabbs(stream, devAabbs, source);
+
+	std::vector<pt::Aabb> deviceAabbs(count);
+	stream.memcpy(deviceAabbs.data(), devAabbs.data(), count).sync();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		assert(hostAabbs[i].lower.x == deviceAabbs[i].lower.x);
+		assert(hostAabbs[i].lower.y == deviceAabbs[i].lower.y);
+		assert(hostAabbs[i].lower.z == deviceAabbs[i].lower.z);
+		assert(hostAabbs[i].upper.x == deviceAabbs[i].upper.x);
+		assert(hostAabbs[i].upper.y == deviceAabbs[i].upper.y);
+		assert(hostAabbs[i].upper.z == deviceAabbs[i].upper.z);
+	}
+
+	//	fused refit
+	auto accelStruct = deviceContext->createAccelStructAabb();
+	pt::AccelStructAabb::BuildInput buildInput;
+	buildInput.aabbBuffer = devAabbs;
+	buildInput.numPrimitives = static_cast<unsigned int>(count);
+	accelStruct->build(stream, allocator, buildInput, 0, false, true);
+
+	source.radius = 2e-2f;
+	pt::refitAabbs(stream, *accelStruct, devAabbs, source);
+	stream.sync();
+
+	assert(!accelStruct->empty());
+}
\ No newline at end of file
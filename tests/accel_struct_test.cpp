@@ -56,4 +56,75 @@ void accel_struct_test()
 #endif
 
 	accelStrutAabb->refit(stream);
+
+	//	Repeated builds: same layout (addresses patched), grown, then shrunk back (cached memory usage).
+	std::vector<pt::Aabb> hostAabbs(4);
+
+	for (size_t i = 0; i < hostAabbs.size(); i++)
+	{
+		hostAabbs[i].lower = ns::float3{ float(i), 0.0f, 0.0f };
+		hostAabbs[i].upper = ns::float3{ float(i) + 0.5f, 1.0f, 1.0f };
+	}
+
+	ns::Array<pt::Aabb> devAabbs(allocator, hostAabbs.size());
+	stream.memcpy(devAabbs.data(), hostAabbs.data(), hostAabbs.size());
+
+	for (unsigned int numPrimitives : { 2u, 2u, 4u, 2u })
+	{
+		pt::AccelStructAabb::BuildInput buildInput;
+		buildInput.aabbBuffer = devAabbs;
+		buildInput.numPrimitives = numPrimitives;
+
+		accelStrutAabb->build(stream, allocator, buildInput, 0, true, true);
+		accelStrutAabb->refit(stream);
+
+		assert(accelStrutAabb->handle() != 0);
+		assert(accelStrutAabb->buildInputs().size() == 1);
+		assert(accelStrutAabb->buildInputs()[0].numPrimitives == numPrimitives);
+	}
+
+	//	Same sequence for triangles (a strip of quads), with default and explicit per-SBT-record flags.
+	std::vector<ns::float3_16a> hostVertices;
+	std::vector<ns::int3_16a> hostTriangles;
+
+	for (int i = 0; i < 4; i++)
+	{
+		hostVertices.push_back(ns::float3_16a{ float(i), 0.0f, 0.0f });
+		hostVertices.push_back(ns::float3_16a{ float(i), 1.0f, 0.0f });
+		hostTriangles.push_back(ns::int3_16a{ 2 * i, 2 * i + 2, 2 * i + 1 });
+		hostTriangles.push_back(ns::int3_16a{ 2 * i + 1, 2 * i + 2, 2 * i + 3 });
+	}
+
+	hostVertices.push_back(ns::float3_16a{ 4.0f, 0.0f, 0.0f });
+	hostVertices.push_back(ns::float3_16a{ 4.0f, 1.0f, 0.0f });
+
+	ns::Array<ns::float3_16a> devVertices(allocator, hostVertices.size());
+	ns::Array<ns::int3_16a> devTriangles(allocator, hostTriangles.size());
+	stream.memcpy(devVertices.data(), hostVertices.data(), hostVertices.size());
+	stream.memcpy(devTriangles.data(), hostTriangles.data(), hostTriangles.size());
+
+	const pt::GeomAccelStruct::GeomFlags disableAnyHit = pt::GeomAccelStruct::DisableAnyhit;
+
+	for (unsigned int numTriangles : { 2u, 2u, 8u, 2u })
+	{
+		pt::AccelStructTriangle::BuildInput buildInput;
+		buildInput.vertexBuffer = devVertices;
+		buildInput.indexBuffer = devTriangles;
+		buildInput.numVertices = static_cast<unsigned int>(hostVertices.size());
+		buildInput.numIndexTriplets = numTriangles;
+
+		if (numTriangles == 8)
+		{
+			buildInput.perSbtRecordFlags = disableAnyHit;
+		}
+
+		accelStrutTriangle->build(stream, allocator, buildInput, 0, true, true);
+		accelStrutTriangle->refit(stream);
+
+		assert(accelStrutTriangle->handle() != 0);
+		assert(accelStrutTriangle->buildInputs().size() == 1);
+		assert(accelStrutTriangle->buildInputs()[0].numIndexTriplets == numTriangles);
+	}
+
+	stream.sync();
 }
\ No newline at end of file
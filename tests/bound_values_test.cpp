@@ -0,0 +1,81 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <photon/bound_values.h>
+#include <stddef.h>
+
+/*********************************************************************************
+****************************    bound_values_test    *****************************
+*********************************************************************************/
+
+void bound_values_test()
+{
+#if OPTIX_VERSION >= 70200
+	struct Shading { unsigned int flags; float exposure; };
+	struct Params { unsigned long long handle; float radius; int maxDepth; Shading shading; bool enableShadows; unsigned int numSamples; };
+
+	pt::BoundValues<Params> boundValues;
+	boundValues.bind(&Params::radius, 0.5f).bind(&Params::enableShadows, true, "enableShadows");
+	boundValues.bind(offsetof(Params, shading) + offsetof(Shading, flags), 7u);
+	boundValues.bind(&Params::radius, 0.25f);					//	rebinding replaces the value
+
+	assert(boundValues.size() == 3);
+
+	OptixModuleCompileOptions moduleCompileOptions = {};
+	moduleCompileOptions.maxRegisterCount = 64;
+	moduleCompileOptions = boundValues.apply(moduleCompileOptions);
+
+	assert(moduleCompileOptions.maxRegisterCount == 64);
+	assert(moduleCompileOptions.numBoundValues == 3);
+
+	const OptixModuleCompileBoundValueEntry & radius = moduleCompileOptions.boundValues[0];
+	const OptixModuleCompileBoundValueEntry & enableShadows = moduleCompileOptions.boundValues[1];
+	const OptixModuleCompileBoundValueEntry & flags = moduleCompileOptions.boundValues[2];
+
+	assert(radius.pipelineParamOffsetInBytes == offsetof(Params, radius));
+	assert(radius.sizeInBytes == sizeof(float));
+	assert(*static_cast<const float*>(radius.boundValuePtr) == 0.25f);
+	assert(radius.annotation == nullptr);
+
+	assert(enableShadows.pipelineParamOffsetInBytes == offsetof(Params, enableShadows));
+	assert(enableShadows.sizeInBytes == sizeof(bool));
+	assert(*static_cast<const bool*>(enableShadows.boundValuePtr) == true);
+	assert(strcmp(enableShadows.annotation, "enableShadows") == 0);
+
+	assert(flags.pipelineParamOffsetInBytes == offsetof(Params, shading.flags));
+	assert(*static_cast<const unsigned int*>(flags.boundValuePtr) == 7u);
+
+	boundValues.clear();
+	moduleCompileOptions = boundValues.apply();
+
+	assert(moduleCompileOptions.numBoundValues == 0);
+	assert(moduleCompileOptions.boundValues == nullptr);
+
+	//	The field type alone selects the value type, the literal is converted.
+	boundValues.bind(&Params::numSamples, 5);
+	moduleCompileOptions = boundValues.apply();
+
+	assert(moduleCompileOptions.numBoundValues == 1);
+	assert(moduleCompileOptions.boundValues[0].sizeInBytes == sizeof(unsigned int));
+	assert(*static_cast<const unsigned int*>(moduleCompileOptions.boundValues[0].boundValuePtr) == 5u);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <set>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/broad_phase.h>
+#include <photon/device_context.h>
+
+/*********************************************************************************
+*****************************    broad_phase_test    *****************************
+*********************************************************************************/
+
+void broad_phase_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	const size_t count = 4000;
+	const float radius = 1e-2f;
+	std::default_random_engine e;
+	std::uniform_real_distribution<float> d;
+	std::vector<ns::float3_16a> points(count);
+	std::vector<float> radii(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		points[i] = ns::float3_16a{ d(e), d(e), d(e) };
+		radii[i] = 2e-2f * d(e);
+	}
+
+	ns::Array<float>				devRadii(allocator, count);
+	ns::Array<ns::float3_16a>		devPoints(allocator, count);
+	stream.memcpy(devRadii.data(), radii.data(), count);
+	stream.memcpy(devPoints.data(), points.data(), count);
+
+	auto broadPhase = deviceContext->createBroadPhase();
+
+	for (auto shape : { pt::BroadPhase::Sphere, pt::BroadPhase::Box })
+	{
+		pt::BroadPhase::BuildInput buildInput;
+		buildInput.positions = devPoints;
+		buildInput.radii = devRadii;
+		buildInput.radius = radius;
+		buildInput.numParticles = static_cast<unsigned int>(count);
+		buildInput.shape = shape;
+
+		//	Tiny initial capacity to exercise the overflow retry.
+		broadPhase->build(stream, allocator, buildInput, 16);
+
+		auto devPairs = broadPhase->detect(stream);
+		std::vector<pt::BroadPhase::ContactPair> pairs(broadPhase->numContacts());
+		stream.memcpy(pairs.data(), devPairs.data(), pairs.size()).sync();
+
+		assert(broadPhase->capacity() >= pairs.size());
+
+		//	Brute force, with a small margin to be robust to FMA contraction on device.
+		auto distance = [&](size_t i, size_t j)
+		{
+			float dx = std::abs(points[i].x - points[j].x);
+			float dy = std::abs(points[i].y - points[j].y);
+			float dz = std::abs(points[i].z - points[j].z);
+
+			return (shape == pt::BroadPhase::Sphere) ? std::sqrt(dx * dx + dy * dy + dz * dz) : std::max({ dx, dy, dz });
+		};
+
+		std::set<std::pair<unsigned int, unsigned int>> found;
+
+		for (auto & pair : pairs)
+		{
+			assert(pair.i < pair.j);
+			assert(pair.j < count);
+			assert(distance(pair.i, pair.j) < (radii[pair.i] + radii[pair.j] + 2.0f * radius) * 1.0001f);
+			assert(found.insert({ pair.i, pair.j }).second);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			for (size_t j = i + 1; j < count; j++)
+			{
+				if (distance(i, j) < (radii[i] + radii[j] + 2.0f * radius) * 0.9999f)
+				{
+					assert(found.count({ static_cast<unsigned int>(i), static_cast<unsigned int>(j) }) == 1);
+				}
+			}
+		}
+
+		//	Refit without any motion must reproduce the same pairs.
+		broadPhase->refit(stream);
+		broadPhase->detect(stream);
+		stream.sync();
+
+		assert(broadPhase->numContacts() == pairs.size());
+	}
+}
\ No newline at end of file
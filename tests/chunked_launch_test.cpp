@@ -0,0 +1,123 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <vector>
+#include <utility>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/pipeline.h>
+#include <photon/device_context.h>
+
+#include "launch_params.h"
+#include "rt_program.optixir.h"
+
+/*********************************************************************************
+***************************    chunked_launch_test    ****************************
+*********************************************************************************/
+
+void chunked_launch_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto context = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.usesPrimitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_SPHERE;
+
+	auto module = context->createModule(rt_program_optixir, pipelineCompileOptions);
+	auto raygenProg = module->at("__raygen__");
+	auto missProg = module->at("__miss__");
+
+	ns::Array<LaunchParams>			launchParams(allocator, 1);
+	ns::Array<pt::EmptyRecord>		raygenRecord(allocator, 1);
+	ns::Array<pt::EmptyRecord>		missRecord(allocator, 1);
+
+	OptixShaderBindingTable sbt = {};
+	sbt.raygenRecord = CUdeviceptr(raygenRecord.data());
+	sbt.missRecordBase = CUdeviceptr(missRecord.data());
+	sbt.missRecordStrideInBytes = sizeof(pt::EmptyRecord);
+	sbt.missRecordCount = 1;
+
+	stream.memcpy<void>(missRecord.data(), missProg->header().storage, sizeof(pt::SbtHeader));
+	stream.memcpy<void>(raygenRecord.data(), raygenProg->header().storage, sizeof(pt::SbtHeader));
+
+	pt::Pipeline pipeline(context, { raygenProg, missProg }, pipelineCompileOptions);
+
+	//	Launches beyond the OptiX limit are rejected instead of wrapping.
+	bool rejected = false;
+
+	try
+	{
+		pipeline.launch<LaunchParams>(stream, launchParams, sbt, pt::maxLaunchSize, 2);
+	}
+	catch (OptixResult)
+	{
+		rejected = true;
+	}
+
+	assert(rejected);
+
+	//	Chunked launches, with uneven last chunks and more chunks than internal streams:
+	//	every global index must be launched exactly once, by a chunk of the expected size.
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "chunkedParams";
+
+	auto chunkedModule = context->createModule(rt_program_optixir, pipelineCompileOptions);
+	auto chunkedRaygenProg = chunkedModule->at("__raygen__chunked");
+	auto chunkedMissProg = chunkedModule->at("__miss__");
+
+	ns::Array<pt::EmptyRecord> chunkedRaygenRecord(allocator, 1);
+	stream.memcpy<void>(chunkedRaygenRecord.data(), chunkedRaygenProg->header().storage, sizeof(pt::SbtHeader));
+
+	OptixShaderBindingTable chunkedSbt = sbt;
+	chunkedSbt.raygenRecord = CUdeviceptr(chunkedRaygenRecord.data());
+
+	pt::Pipeline chunkedPipeline(context, { chunkedRaygenProg, chunkedMissProg }, pipelineCompileOptions);
+
+	const std::pair<size_t, size_t> launches[] = { { 10, 3 }, { 40, 7 }, { 1000, 333 }, { 5, 8 }, { 0, 4 } };
+
+	for (auto [count, chunkSize] : launches)
+	{
+		ns::Array<unsigned int> counts(allocator, count + 1);
+		stream.memset(counts.data(), 0, counts.bytes());
+
+		ChunkedParams params = {};
+		params.counts = counts.data();
+		params.count = count;
+
+		chunkedPipeline.launchChunked(stream, params, &ChunkedParams::chunk, chunkedSbt, count, chunkSize);
+
+		std::vector<unsigned int> hostCounts(count + 1);
+		stream.memcpy(hostCounts.data(), counts.data(), count + 1).sync();
+
+		for (size_t i = 0; i < count; i++)
+		{
+			assert(hostCounts[i] == 1);
+		}
+
+		assert(hostCounts[count] == 0);
+	}
+}
\ No newline at end of file
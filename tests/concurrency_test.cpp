@@ -0,0 +1,121 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+
+#include <photon/pipeline.h>
+#include <photon/accel_struct.h>
+#include <photon/device_context.h>
+
+#include "rt_program.optixir.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*********************************************************************************
+*****************************    concurrency_test    *****************************
+*********************************************************************************/
+
+void concurrency_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto context = pt::SharedContext(device);
+
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.usesPrimitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_SPHERE;
+
+	auto module = context->createModule(rt_program_optixir, pipelineCompileOptions);
+
+	const char * funcNames[] = { "__raygen__", "__miss__", "__closesthit__", "__anyhit__", "__intersection__", "__exception__", "__direct_callable__", "__continuation_callable__" };
+	const size_t numFuncs = std::size(funcNames);
+	const unsigned int numThreads = std::max(4u, std::thread::hardware_concurrency());
+
+	std::vector<std::vector<std::shared_ptr<pt::Program>>> programs(numThreads, std::vector<std::shared_ptr<pt::Program>>(numFuncs));
+	std::atomic<unsigned int> numFailures = 0;
+	std::atomic<unsigned int> numReady = 0;
+	std::vector<std::thread> threads;
+
+	for (unsigned int t = 0; t < numThreads; t++)
+	{
+		threads.emplace_back([&, t]()
+		{
+			//	Start together, so that first lookups race on creation.
+			numReady++;
+
+			while (numReady < numThreads)		std::this_thread::yield();
+
+			for (unsigned int iter = 0; iter < 1000; iter++)
+			{
+				const size_t i = (t + iter) % numFuncs;
+				const std::string funcName = funcNames[i];		//	Lookups by `std::string` and by `const char*` must agree.
+
+				auto program = (iter % 2) ? module->at(funcName) : module->at(funcNames[i]);
+
+				if ((program == nullptr) || ((programs[t][i] != nullptr) && (programs[t][i] != program)))
+				{
+					numFailures++;
+				}
+
+				programs[t][i] = program;
+			}
+
+			//	Object creation from many threads.
+			auto accelStruct = context->createAccelStructAabb();
+			auto instAccelStruct = context->createInstAccelStruct();
+
+			if ((accelStruct == nullptr) || (instAccelStruct == nullptr))
+			{
+				numFailures++;
+			}
+
+			OptixBuiltinISOptions builtinISOptions = {};
+			builtinISOptions.builtinISModuleType = OPTIX_PRIMITIVE_TYPE_SPHERE;
+
+			if (context->getBuiltinISProgram(builtinISOptions, pipelineCompileOptions) == nullptr)
+			{
+				numFailures++;
+			}
+
+			pt::Pipeline pipeline(context, { programs[t][0], programs[t][1], programs[t][2] }, pipelineCompileOptions);
+		});
+	}
+
+	for (auto & thread : threads)
+	{
+		thread.join();
+	}
+
+	assert(numFailures == 0);
+
+	//	Every thread observed the same program instances.
+	for (unsigned int t = 1; t < numThreads; t++)
+	{
+		for (size_t i = 0; i < numFuncs; i++)
+		{
+			assert(programs[t][i] == programs[0][i]);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/allocator.h>
+#include <nucleus/array_2d.h>
+
+#include <photon/denoiser_pool.h>
+#include <photon/device_context.h>
+
+/*********************************************************************************
+****************************    denoiser_pool_test    ****************************
+*********************************************************************************/
+
+void denoiser_pool_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto denoiserPool = deviceContext->createDenoiserPool(device->defaultAllocator(), size_t(1) << 30);
+	auto & stream = device->defaultStream();
+
+	const pt::Denoiser * denoiser = nullptr;
+	{
+		auto lease0 = denoiserPool->acquire(stream, pt::Denoiser::Normal, 1000, 700);
+		auto lease1 = denoiserPool->acquire(stream, pt::Denoiser::Normal, 1000, 700);
+
+		assert(lease0 && lease1 && (lease0.get() != lease1.get()));
+		assert(lease0->maxInputWidth() == 1024);
+		assert(lease0->maxInputHeight() == 768);
+		assert(denoiserPool->numDenoisers() == 2);
+		assert(denoiserPool->memoryUsage() == lease0->memoryUsage() + lease1->memoryUsage());
+
+		denoiser = lease0.get();
+	}
+
+	//	Same resolution bucket: reuse an idle denoiser.
+	{
+		auto lease = denoiserPool->acquire(stream, pt::Denoiser::Normal, 1024, 768);
+
+		assert(lease.get() == denoiser);
+		assert(denoiserPool->numDenoisers() == 2);
+	}
+
+	//	Leased launch on one stream, then reuse of the same denoiser on another stream.
+	{
+		const unsigned int width = 500, height = 300;
+
+		ns::Stream streamA(device), streamB(device);
+
+		//	0x3E bytes are the float 0.186, a flat positive image.
+		ns::Array2D<ns::float4>			color(device->defaultAllocator(), width, height);
+		ns::Array2D<ns::float4>			albedo(device->defaultAllocator(), width, height);
+		ns::Array2D<ns::float4>			normal(device->defaultAllocator(), width, height);
+		ns::Array2D<ns::float4>			output(device->defaultAllocator(), width, height);
+		streamA.memset(color.data(), 0x3E, color.pitch() * height);
+		streamA.memset(albedo.data(), 0x3E, albedo.pitch() * height);
+		streamA.memset(normal.data(), 0x3E, normal.pitch() * height);
+		streamA.memset(output.data(), 0xFF, output.pitch() * height);
+
+		//	Check that the output prefilled with 0xFF bytes (NaN) was overwritten, in the order of `stream`.
+		auto isWritten = [&](ns::Stream & stream)
+		{
+			std::vector<unsigned char> bytes(output.pitch() * height);
+			stream.memcpy(bytes.data(), reinterpret_cast<const unsigned char*>(output.data()), bytes.size()).sync();
+
+			for (unsigned int y = 0; y < height; y++)
+			{
+				const ns::float4 * row = reinterpret_cast<const ns::float4*>(bytes.data() + y * output.pitch());
+
+				for (unsigned int x = 0; x < width; x++)
+				{
+					if (!std::isfinite(row[x].x) || !std::isfinite(row[x].y) || !std::isfinite(row[x].z))
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		};
+
+		const pt::Denoiser * leased = nullptr;
+		{
+			auto lease = denoiserPool->acquire(streamA, pt::Denoiser::Normal, width, height);
+
+			assert(lease->maxInputWidth() == 512);
+			assert(lease->maxInputHeight() == 512);
+			assert(denoiserPool->numDenoisers() == 3);
+
+			lease.launch(streamA, output.ptr(), color.ptr(), albedo.ptr(), normal.ptr(), nullptr, nullptr, nullptr, 0.0f);
+
+			leased = lease.get();
+		}
+
+		//	The only idle denoiser of the bucket: streamB must wait for the launch on streamA before using it.
+		{
+			auto lease = denoiserPool->acquire(streamB, pt::Denoiser::Normal, width, height);
+
+			assert(lease.get() == leased);
+			assert(denoiserPool->numDenoisers() == 3);
+
+			assert(isWritten(streamB));
+
+			streamB.memset(output.data(), 0xFF, output.pitch() * height);
+
+			lease.launch(streamB, output.ptr(), color.ptr(), albedo.ptr(), normal.ptr(), nullptr, nullptr, nullptr, 0.0f);
+
+			assert(isWritten(streamB));
+		}
+	}
+
+	denoiserPool->setMemoryBudget(0);
+
+	assert(denoiserPool->numDenoisers() == 0);
+	assert(denoiserPool->memoryUsage() == 0);
+}
\ No newline at end of file
@@ -20,23 +20,87 @@
  *	SOFTWARE.
  */
 
+#include <cmath>
+#include <vector>
+
 #include <nucleus/device.h>
+#include <nucleus/stream.h>
 #include <nucleus/context.h>
 #include <nucleus/allocator.h>
+#include <nucleus/array_1d.h>
+#include <nucleus/array_2d.h>
 
 #include <photon/denoiser.h>
+#include <photon/denoiser_utils.h>
+#include <photon/payload_codec.h>
 #include <photon/device_context.h>
 
 /*********************************************************************************
 ******************************    denoiser_test    *******************************
 *********************************************************************************/
 
+//	Describes a tightly packed image on linear device memory.
+template<typename Type> static pt::Denoiser::Image makeImage(const ns::Array<Type> & array, unsigned int width, unsigned int height)
+{
+	pt::Denoiser::Image image;
+	image.data = array.data();
+	image.width = width;
+	image.height = height;
+	image.rowStrideInBytes = width * sizeof(Type);
+	image.pixelStrideInBytes = sizeof(Type);
+	image.format = pt::DenoiserPixelFormat<Type>::value;
+	return image;
+}
+
+
+//	Check that the first `count` pixels of an output prefilled with 0xFF bytes (NaN) were overwritten.
+static bool isWritten(ns::Stream & stream, const ns::Array<pt::Color4f> & devOutput, size_t count)
+{
+	std::vector<pt::Color4f> output(count);
+	stream.memcpy(output.data(), devOutput.data(), count).sync();
+
+	for (const auto & pixel : output)
+	{
+		if (!std::isfinite(pixel.r) || !std::isfinite(pixel.g) || !std::isfinite(pixel.b))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
 void denoiser_test()
 {
 	auto device = ns::Context::getInstance()->device(0);
 	auto deviceContext = pt::SharedContext(device);
 	auto denoiser = deviceContext->createDenoiser();
 	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	//	Noisy gray image with flat guides, large enough for every launch below.
+	const unsigned int width = 1300, height = 700;
+
+	std::vector<pt::Color4f> noisy(width * height);
+	std::vector<pt::Color4f> albedo(width * height, pt::Color4f{ 0.8f, 0.8f, 0.8f, 1.0f });
+	std::vector<pt::Color4f> normal(width * height, pt::Color4f{ 0.0f, 0.0f, 1.0f, 0.0f });
+
+	for (size_t i = 0; i < noisy.size(); i++)
+	{
+		float value = 0.25f + 0.5f * ((i * 7919) % 101) / 100.0f;
+
+		noisy[i] = pt::Color4f{ value, value, value, 1.0f };
+	}
+
+	ns::Array<pt::Color4f>		devNoisy(allocator, noisy.size());
+	ns::Array<pt::Color4f>		devAlbedo(allocator, albedo.size());
+	ns::Array<pt::Color4f>		devNormal(allocator, normal.size());
+	ns::Array<pt::Color4f>		devOutput(allocator, noisy.size());
+	ns::Array<pt::Color4f>		devAovOutput(allocator, noisy.size());
+	stream.memcpy(devNoisy.data(), noisy.data(), noisy.size());
+	stream.memcpy(devAlbedo.data(), albedo.data(), albedo.size());
+	stream.memcpy(devNormal.data(), normal.data(), normal.size());
 
 #if OPTIX_VERSION > 70500
 	denoiser->preallocate(allocator, pt::Denoiser::TemporalUpscale2x, 1024, 1024);
@@ -49,4 +113,260 @@ void denoiser_test()
 
 	assert(denoiser->maxInputWidth() == 1024);
 	assert(denoiser->maxInputHeight() == 1024);
+	assert(denoiser->guideSet() == pt::Denoiser::GuideAlbedoNormal);
+
+	denoiser->preallocate(allocator, pt::Denoiser::Normal, 1024, 1024, pt::Denoiser::GuideNone);
+
+	assert(denoiser->guideSet() == pt::Denoiser::GuideNone);
+
+	//	No guide is read, albedo and normal may be left empty.
+	{
+		stream.memset(devOutput.data(), 0xFF, devOutput.bytes());
+
+		denoiser->launch(stream, makeImage(devOutput, 1000, 600), makeImage(devNoisy, 1000, 600), nullptr, nullptr, nullptr, nullptr, nullptr, 0.0f);
+
+		assert(isWritten(stream, devOutput, 1000 * 600));
+	}
+
+#if OPTIX_VERSION >= 70300
+	denoiser->preallocateTiled(allocator, pt::Denoiser::Normal, 512, 256);
+
+	assert(denoiser->tileWidth() == 512);
+	assert(denoiser->tileHeight() == 256);
+	assert(denoiser->maxInputWidth() == 0);
+
+	//	Image larger than a tile and not a multiple of the tile size.
+	{
+		stream.memset(devOutput.data(), 0xFF, devOutput.bytes());
+
+		denoiser->launch(stream, makeImage(devOutput, width, height), makeImage(devNoisy, width, height),
+						 makeImage(devAlbedo, width, height), makeImage(devNormal, width, height), nullptr, nullptr, nullptr, 0.0f);
+
+		assert(isWritten(stream, devOutput, width * height));
+	}
+
+	denoiser->preallocate(allocator, pt::Denoiser::Normal, 1024, 1024);
+
+	assert(denoiser->tileWidth() == 0);
+	assert(denoiser->maxInputWidth() == 1024);
+
+	//	Beauty and diffuse AOV in a single invoke, sharing the guides.
+	{
+		stream.memset(devOutput.data(), 0xFF, devOutput.bytes());
+		stream.memset(devAovOutput.data(), 0xFF, devAovOutput.bytes());
+
+		std::vector<pt::Denoiser::Layer> layers(2);
+		layers[0].input = makeImage(devNoisy, 1000, 600);
+		layers[0].output = makeImage(devOutput, 1000, 600);
+		layers[0].type = pt::Denoiser::AovBeauty;
+		layers[1].input = makeImage(devNoisy, 1000, 600);
+		layers[1].output = makeImage(devAovOutput, 1000, 600);
+		layers[1].type = pt::Denoiser::AovDiffuse;
+
+		pt::Denoiser::GuideLayer guideLayer;
+		guideLayer.albedo = makeImage(devAlbedo, 1000, 600);
+		guideLayer.normal = makeImage(devNormal, 1000, 600);
+
+		denoiser->launch(stream, layers, guideLayer, 0.0f);
+
+		assert(isWritten(stream, devOutput, 1000 * 600));
+		assert(isWritten(stream, devAovOutput, 1000 * 600));
+	}
+#endif
+
+	pt::Denoiser::Image halfImage = dev::Ptr2<const pt::Color4h>(nullptr);
+	pt::Denoiser::Image byteImage = dev::Ptr2<pt::Color4ub>(nullptr);
+
+	assert(halfImage.empty() && (halfImage.format == OPTIX_PIXEL_FORMAT_HALF4) && (halfImage.pixelStrideInBytes == 8));
+	assert(byteImage.empty() && (byteImage.format == OPTIX_PIXEL_FORMAT_UCHAR4) && (byteImage.pixelStrideInBytes == 4));
+
+	//	Half-precision input and guides, half-precision and 8-bit outputs.
+	{
+		std::vector<pt::Color4h> halfNoisy(1000 * 600), halfAlbedo(1000 * 600), halfNormal(1000 * 600);
+
+		for (size_t i = 0; i < halfNoisy.size(); i++)
+		{
+			auto toHalf = [](const pt::Color4f & color)
+			{
+				return pt::Color4h{ pt::details::floatToHalf(color.r), pt::details::floatToHalf(color.g), pt::details::floatToHalf(color.b), pt::details::floatToHalf(color.a) };
+			};
+
+			halfNoisy[i] = toHalf(noisy[i]);
+			halfAlbedo[i] = toHalf(albedo[i]);
+			halfNormal[i] = toHalf(normal[i]);
+		}
+
+		ns::Array<pt::Color4h>		devHalfNoisy(allocator, halfNoisy.size());
+		ns::Array<pt::Color4h>		devHalfAlbedo(allocator, halfAlbedo.size());
+		ns::Array<pt::Color4h>		devHalfNormal(allocator, halfNormal.size());
+		ns::Array<pt::Color4h>		devHalfOutput(allocator, halfNoisy.size());
+		ns::Array<pt::Color4ub>		devByteOutput(allocator, halfNoisy.size());
+		stream.memcpy(devHalfNoisy.data(), halfNoisy.data(), halfNoisy.size());
+		stream.memcpy(devHalfAlbedo.data(), halfAlbedo.data(), halfAlbedo.size());
+		stream.memcpy(devHalfNormal.data(), halfNormal.data(), halfNormal.size());
+		stream.memset(devHalfOutput.data(), 0xFF, devHalfOutput.bytes());
+		stream.memset(devByteOutput.data(), 0x00, devByteOutput.bytes());
+
+		denoiser->preallocate(allocator, pt::Denoiser::Normal, 1024, 1024);
+
+		denoiser->launch(stream, makeImage(devHalfOutput, 1000, 600), makeImage(devHalfNoisy, 1000, 600),
+						 makeImage(devHalfAlbedo, 1000, 600), makeImage(devHalfNormal, 1000, 600), nullptr, nullptr, nullptr, 0.0f);
+
+		denoiser->launch(stream, makeImage(devByteOutput, 1000, 600), makeImage(devHalfNoisy, 1000, 600),
+						 makeImage(devHalfAlbedo, 1000, 600), makeImage(devHalfNormal, 1000, 600), nullptr, nullptr, nullptr, 0.0f);
+
+		std::vector<pt::Color4h> halfOutput(halfNoisy.size());
+		std::vector<pt::Color4ub> byteOutput(halfNoisy.size());
+		stream.memcpy(halfOutput.data(), devHalfOutput.data(), halfOutput.size());
+		stream.memcpy(byteOutput.data(), devByteOutput.data(), byteOutput.size()).sync();
+
+		for (size_t i = 0; i < halfOutput.size(); i++)
+		{
+			assert(std::isfinite(pt::details::halfToFloat(halfOutput[i].r)) && std::isfinite(pt::details::halfToFloat(halfOutput[i].g)));
+
+			//	The input is gray in [0.25, 0.75], the 8-bit output cannot be black.
+			assert((byteOutput[i].r != 0) && (byteOutput[i].g != 0) && (byteOutput[i].b != 0));
+		}
+	}
+
+	//	Fused input and output passes on a small image, compared with the host reference.
+	{
+		const unsigned int w = 6, h = 4;
+
+		std::vector<pt::Color4f> color(w * h), normals(w * h);
+		std::vector<pt::Color4h> halfAlbedo(w * h);
+
+		for (unsigned int i = 0; i < w * h; i++)
+		{
+			color[i] = pt::Color4f{ 0.1f * i, 0.05f * (i % 7), 2.0f - 0.08f * i, 0.5f + 0.02f * i };
+			halfAlbedo[i] = pt::Color4h{ pt::details::floatToHalf(0.03f * i), pt::details::floatToHalf(0.5f), pt::details::floatToHalf(1.0f - 0.04f * i), pt::details::floatToHalf(1.0f) };
+			normals[i] = pt::Color4f{ 1.0f + (i % 3), 2.0f, -1.0f - 0.1f * i, 0.0f };
+		}
+
+		ns::Array<pt::Color4f>		devColor(allocator, color.size());
+		ns::Array<pt::Color4h>		devSourceAlbedo(allocator, halfAlbedo.size());
+		ns::Array<pt::Color4f>		devSourceNormal(allocator, normals.size());
+		ns::Array<pt::Color4h>		devInput(allocator, color.size());
+		ns::Array<pt::Color4f>		devGuideAlbedo(allocator, color.size());
+		ns::Array<pt::Color4f>		devGuideNormal(allocator, color.size());
+		stream.memcpy(devColor.data(), color.data(), color.size());
+		stream.memcpy(devSourceAlbedo.data(), halfAlbedo.data(), halfAlbedo.size());
+		stream.memcpy(devSourceNormal.data(), normals.data(), normals.size());
+
+		//	Rotation of 90 degrees around z: (x, y, z) -> (-y, x, z).
+		pt::DenoiserGuideSource source;
+		source.color = makeImage(devColor, w, h);
+		source.albedo = makeImage(devSourceAlbedo, w, h);
+		source.normal = makeImage(devSourceNormal, w, h);
+		source.worldToCamera.rows[0] = ns::float4{ 0.0f, -1.0f, 0.0f, 0.0f };
+		source.worldToCamera.rows[1] = ns::float4{ 1.0f, 0.0f, 0.0f, 0.0f };
+		source.worldToCamera.rows[2] = ns::float4{ 0.0f, 0.0f, 1.0f, 0.0f };
+		source.worldToCamera.rows[3] = ns::float4{ 0.0f, 0.0f, 0.0f, 1.0f };
+		source.transformNormals = true;
+
+		pt::Denoiser::GuideLayer guideLayer;
+		guideLayer.albedo = makeImage(devGuideAlbedo, w, h);
+		guideLayer.normal = makeImage(devGuideNormal, w, h);
+
+		pt::prepareDenoiserInputs(stream, makeImage(devInput, w, h), guideLayer, source);
+
+		std::vector<pt::Color4h> input(w * h);
+		std::vector<pt::Color4f> guideAlbedo(w * h), guideNormal(w * h);
+		stream.memcpy(input.data(), devInput.data(), input.size());
+		stream.memcpy(guideAlbedo.data(), devGuideAlbedo.data(), guideAlbedo.size());
+		stream.memcpy(guideNormal.data(), devGuideNormal.data(), guideNormal.size()).sync();
+
+		for (unsigned int i = 0; i < w * h; i++)
+		{
+			//	RGBA32F -> RGBA16F and RGBA16F -> RGBA32F are exact with the shared conversion routines.
+			assert(input[i].r == pt::details::floatToHalf(color[i].r) && input[i].g == pt::details::floatToHalf(color[i].g));
+			assert(input[i].b == pt::details::floatToHalf(color[i].b) && input[i].a == pt::details::floatToHalf(color[i].a));
+			assert(guideAlbedo[i].r == pt::details::halfToFloat(halfAlbedo[i].r) && guideAlbedo[i].g == pt::details::halfToFloat(halfAlbedo[i].g));
+			assert(guideAlbedo[i].b == pt::details::halfToFloat(halfAlbedo[i].b) && guideAlbedo[i].a == pt::details::halfToFloat(halfAlbedo[i].a));
+
+			const float length = std::sqrt(normals[i].r * normals[i].r + normals[i].g * normals[i].g + normals[i].b * normals[i].b);
+
+			assert(std::abs(guideNormal[i].r + normals[i].g / length) < 1e-5f);
+			assert(std::abs(guideNormal[i].g - normals[i].r / length) < 1e-5f);
+			assert(std::abs(guideNormal[i].b - normals[i].b / length) < 1e-5f);
+			assert(guideNormal[i].a == normals[i].a);
+		}
+
+		//	Host reference of the output pass, the device may differ by one step of rounding in powf.
+		auto checkOutput = [&](const ns::Array2D<pt::Color4ub> & devOutput, const pt::TonemapParams & params)
+		{
+			const unsigned int scale = params.downsample2x ? 2 : 1;
+
+			std::vector<unsigned char> bytes(devOutput.pitch() * devOutput.height());
+			stream.memcpy(bytes.data(), reinterpret_cast<const unsigned char*>(devOutput.data()), bytes.size()).sync();
+
+			for (unsigned int y = 0; y < h / scale; y++)
+			{
+				for (unsigned int x = 0; x < w / scale; x++)
+				{
+					float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+
+					for (unsigned int k = 0; k < scale * scale; k++)
+					{
+						const pt::Color4h & texel = input[(scale * y + k / scale) * w + scale * x + k % scale];
+
+						r += pt::details::halfToFloat(texel.r) / (scale * scale);
+						g += pt::details::halfToFloat(texel.g) / (scale * scale);
+						b += pt::details::halfToFloat(texel.b) / (scale * scale);
+						a += pt::details::halfToFloat(texel.a) / (scale * scale);
+					}
+
+					auto encode = [&](float value)
+					{
+						value = pt::details::tonemap(value * params.exposure, params.tonemapOperator);
+
+						return pt::details::toUnorm8(params.srgb ? pt::details::linearToSrgb(value) : value);
+					};
+
+					const pt::Color4ub reference = { encode(r), encode(g), encode(b), pt::details::toUnorm8(a) };
+					const pt::Color4ub & pixel = reinterpret_cast<const pt::Color4ub*>(bytes.data() + y * devOutput.pitch())[x];
+
+					assert(std::abs(pixel.r - reference.r) <= 1 && std::abs(pixel.g - reference.g) <= 1);
+					assert(std::abs(pixel.b - reference.b) <= 1 && std::abs(pixel.a - reference.a) <= 1);
+				}
+			}
+		};
+
+		pt::TonemapParams params;
+		params.tonemapOperator = pt::TonemapParams::Reinhard;
+		params.exposure = 2.0f;
+		params.downsample2x = true;
+
+		ns::Array2D<pt::Color4ub> devHalfSize(allocator, w / 2, h / 2);
+		pt::tonemapDenoiserOutput(stream, devHalfSize.ptr(), makeImage(devInput, w, h), params);
+		checkOutput(devHalfSize, params);
+
+		params.tonemapOperator = pt::TonemapParams::Clamp;
+		params.exposure = 1.0f;
+		params.srgb = false;
+		params.downsample2x = false;
+
+		ns::Array2D<pt::Color4ub> devFullSize(allocator, w, h);
+		pt::tonemapDenoiserOutput(stream, devFullSize.ptr(), makeImage(devInput, w, h), params);
+		checkOutput(devFullSize, params);
+	}
+
+	//	Pixel math of the fused output pass.
+	assert(pt::details::toUnorm8(pt::details::linearToSrgb(0.0f)) == 0);
+	assert(pt::details::toUnorm8(pt::details::linearToSrgb(1.0f)) == 255);
+	assert(pt::details::toUnorm8(pt::details::linearToSrgb(0.5f)) == 188);
+
+	for (int op = pt::TonemapParams::Clamp; op <= pt::TonemapParams::Aces; op++)
+	{
+		float previous = 0.0f;
+
+		for (float x = 0.0f; x < 16.0f; x += 0.125f)
+		{
+			float y = pt::details::tonemap(x, pt::TonemapParams::Operator(op));
+
+			assert((y >= previous) && (y <= 1.0f));
+
+			previous = y;
+		}
+	}
 }
\ No newline at end of file
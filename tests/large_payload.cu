@@ -0,0 +1,79 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+#pragma once
+
+#include <photon/trace.cuh>
+#include <photon/ray_types.h>
+#include "launch_params.h"
+
+struct PrimaryRay {};
+
+using RayTypes = pt::RayTypeTable<PrimaryRay>;
+using StatePayload = pt::LargePayload<float3, LargeState, 3>;		//	hot: 3-5, cold pointer: 6-7
+
+__RT_CONSTANT__ LargePayloadParams largePayloadParams;
+
+/*********************************************************************************
+*********************************    kernels    **********************************
+*********************************************************************************/
+
+__RT_KERNEL__ void __raygen__large()
+{
+	const unsigned int index = optixGetLaunchIndex().x;
+
+	StatePayload payload = StatePayload::fromScratch(float3{ float(index), 0.0f, 0.0f }, largePayloadParams.scratch);
+
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		payload.cold()->values[i] = index + i;
+	}
+
+	pt::trace<RayTypes::Ray<PrimaryRay>>(largePayloadParams.handle, float3{ 0, 0, 0 }, float3{ 0, 0, 1 }, 0.0f, 1e16f, payload);
+
+	const float3 hot = payload.hot();
+
+	bool valid = (payload.cold() == largePayloadParams.scratch + index) && (hot.x == float(index)) && (hot.y == float(index) + 1.0f);
+
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		valid = valid && (payload.cold()->values[i] == 2 * (index + i));
+	}
+
+	largePayloadParams.results[index] = valid ? 1 : 0;
+}
+
+
+__RT_KERNEL__ void __miss__large()
+{
+	StatePayload payload = pt::get_payload<StatePayload>();
+
+	for (unsigned int i = 0; i < 40; i++)
+	{
+		payload.cold()->values[i] *= 2;
+	}
+
+	float3 hot = payload.hot();
+	hot.y = hot.x + 1.0f;
+	payload.setHot(hot);
+
+	pt::set_payload(payload);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <vector>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/pipeline.h>
+#include <photon/device_context.h>
+
+#include "launch_params.h"
+#include "large_payload.optixir.h"
+
+/*********************************************************************************
+****************************    large_payload_test    ****************************
+*********************************************************************************/
+
+void large_payload_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto context = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "largePayloadParams";
+	pipelineCompileOptions.numPayloadValues = 8;				//	3 unused, 3 hot, 2 for the cold pointer
+
+	auto module = context->createModule(large_payload_optixir, pipelineCompileOptions);
+	auto raygenProg = module->at("__raygen__large");
+	auto missProg = module->at("__miss__large");
+
+	const unsigned int count = 1000;
+
+	ns::Array<pt::EmptyRecord>			raygenRecord(allocator, 1);
+	ns::Array<pt::EmptyRecord>			missRecord(allocator, 1);
+	ns::Array<LargePayloadParams>		launchParams(allocator, 1);
+	ns::Array<LargeState>				scratch(allocator, count);
+	ns::Array<unsigned int>				results(allocator, count);
+
+	stream.memcpy<void>(raygenRecord.data(), raygenProg->header().storage, sizeof(pt::SbtHeader));
+	stream.memcpy<void>(missRecord.data(), missProg->header().storage, sizeof(pt::SbtHeader));
+
+	OptixShaderBindingTable sbt = {};
+	sbt.raygenRecord = CUdeviceptr(raygenRecord.data());
+	sbt.missRecordBase = CUdeviceptr(missRecord.data());
+	sbt.missRecordStrideInBytes = sizeof(pt::EmptyRecord);
+	sbt.missRecordCount = 1;
+
+	LargePayloadParams params = {};
+	params.handle = 0;
+	params.scratch = scratch.data();
+	params.results = results.data();
+
+	stream.memcpy(launchParams.data(), &params, 1);
+	stream.memset(results.data(), 0, results.bytes());
+
+	pt::Pipeline pipeline(context, { raygenProg, missProg }, pipelineCompileOptions);
+
+	pipeline.launch<LargePayloadParams>(stream, launchParams, sbt, count);
+
+	//	Hot slots and the 40 words of cold state written by the miss program come back to the raygen.
+	std::vector<unsigned int> hostResults(count);
+	std::vector<LargeState> hostScratch(count);
+	stream.memcpy(hostResults.data(), results.data(), count);
+	stream.memcpy(hostScratch.data(), scratch.data(), count).sync();
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		assert(hostResults[i] == 1);
+		assert(hostScratch[i].values[39] == 2 * (i + 39));
+	}
+}
\ No newline at end of file
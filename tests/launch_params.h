@@ -21,8 +21,40 @@
  */
 #pragma once
 
+#include <photon/launch_chunk.h>
+#include <optix_types.h>
 
 struct LaunchParams
 {
 	int seed;
 };
+
+
+struct ChunkedParams
+{
+	pt::LaunchChunk				chunk;
+	unsigned int *				counts;			//	Launches per global index, `count + 1` elements (the last one counts invalid indices).
+	unsigned long long			count;
+};
+
+
+struct ReorderParams
+{
+	OptixTraversableHandle		handle;			//	Zero, so every ray misses.
+	float *						results;		//	Payload written by the miss programs, one per launch index.
+	bool						enableReorder;	//	`DeviceContext::supportsShaderExecutionReordering()`.
+};
+
+
+struct LargeState
+{
+	unsigned int				values[40];		//	More than the 32 payload slots.
+};
+
+
+struct LargePayloadParams
+{
+	OptixTraversableHandle		handle;			//	Zero, so every ray misses.
+	LargeState *				scratch;		//	Cold parts of the payloads, one per launch index.
+	unsigned int *				results;		//	1 where the payload came back as written by the miss program.
+};
\ No newline at end of file
@@ -28,13 +28,41 @@
 
 extern void pipeline_test();
 extern void denoiser_test();
+extern void denoiser_pool_test();
 extern void accel_struct_test();
+extern void aabb_utils_test();
+extern void broad_phase_test();
+extern void neighbor_search_test();
+extern void spatial_sort_test();
+extern void payload_layout_test();
+extern void large_payload_test();
+extern void payload_codec_test();
+extern void profiler_test();
+extern void concurrency_test();
+extern void bound_values_test();
+extern void multi_device_test();
+extern void chunked_launch_test();
+extern void ray_query_test();
 
 int main()
 {
 	pipeline_test();
 	denoiser_test();
+	denoiser_pool_test();
 	accel_struct_test();
+	aabb_utils_test();
+	broad_phase_test();
+	neighbor_search_test();
+	spatial_sort_test();
+	payload_layout_test();
+	large_payload_test();
+	payload_codec_test();
+	profiler_test();
+	concurrency_test();
+	bound_values_test();
+	multi_device_test();
+	chunked_launch_test();
+	ray_query_test();
 	system("pause");
 
 	return 0;
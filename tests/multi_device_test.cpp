@@ -0,0 +1,171 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <vector>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/pipeline.h>
+#include <photon/device_context.h>
+#include <photon/multi_device_context.h>
+
+#include "launch_params.h"
+#include "rt_program.optixir.h"
+
+/*********************************************************************************
+****************************    multi_device_test    *****************************
+*********************************************************************************/
+
+void multi_device_test()
+{
+	//	Three logical devices, all GPUs of the node would be listed in production.
+	auto device = ns::Context::getInstance()->device(0);
+	pt::MultiDeviceContext multiContext({ device, device, device });
+
+	assert(multiContext.size() == 3);
+
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.usesPrimitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_SPHERE;
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "chunkedParams";
+
+	constexpr size_t count = 1 << 16;
+
+	struct Replica
+	{
+		std::shared_ptr<pt::Pipeline>			pipeline;
+		ChunkedParams							hostParams;
+		ns::Array<ChunkedParams>				launchParams;
+		ns::Array<unsigned int>					counts;				//	Launches per global index on this device.
+		ns::Array<pt::EmptyRecord>				raygenRecord;
+		ns::Array<pt::EmptyRecord>				missRecord;
+		OptixShaderBindingTable					sbt;
+	};
+
+	auto replicas = multiContext.replicate([&](size_t, const pt::SharedContext & context)
+	{
+		auto allocator = context->device()->defaultAllocator();
+		auto & stream = context->device()->defaultStream();
+		auto module = context->createModule(rt_program_optixir, pipelineCompileOptions);
+		auto raygenProg = module->at("__raygen__chunked");
+		auto missProg = module->at("__miss__");
+
+		auto replica = std::make_shared<Replica>();
+		replica->pipeline = std::make_shared<pt::Pipeline>(context, std::vector<std::shared_ptr<pt::Program>>{ raygenProg, missProg }, pipelineCompileOptions);
+		replica->launchParams.resize(allocator, 1);
+		replica->counts.resize(allocator, count + 1);
+		replica->raygenRecord.resize(allocator, 1);
+		replica->missRecord.resize(allocator, 1);
+		replica->sbt = {};
+		replica->sbt.raygenRecord = CUdeviceptr(replica->raygenRecord.data());
+		replica->sbt.missRecordBase = CUdeviceptr(replica->missRecord.data());
+		replica->sbt.missRecordStrideInBytes = sizeof(pt::EmptyRecord);
+		replica->sbt.missRecordCount = 1;
+
+		stream.memcpy<void>(replica->raygenRecord.data(), raygenProg->header().storage, sizeof(pt::SbtHeader));
+		stream.memcpy<void>(replica->missRecord.data(), missProg->header().storage, sizeof(pt::SbtHeader));
+
+		return replica;
+	});
+
+	assert(replicas.size() == 3);
+	assert(replicas[0]->pipeline->handle() != replicas[1]->pipeline->handle());		//	one pipeline per context
+
+	//	Unmeasured devices get equal shares, the ranges always cover the launch exactly.
+	auto ranges = multiContext.split(1000);
+
+	assert(ranges.size() == 3);
+	assert((ranges[0].offset == 0) && (ranges[0].count == 333));
+	assert((ranges[1].offset == 333) && (ranges[1].count == 334));
+	assert((ranges[2].offset == 667) && (ranges[2].count == 333));
+
+	for (int frame = 0; frame < 4; frame++)
+	{
+		ranges = multiContext.launch(count, [&](const pt::MultiDeviceContext::LaunchRange & range, ns::Stream & stream)
+		{
+			auto & replica = *replicas[range.device];
+
+			replica.hostParams = {};
+			replica.hostParams.chunk.offset = range.offset;
+			replica.hostParams.chunk.count = range.count;
+			replica.hostParams.counts = replica.counts.data();
+			replica.hostParams.count = count;
+
+			stream.memset(replica.counts.data(), 0, replica.counts.bytes());
+			stream.memcpy(replica.launchParams.data(), &replica.hostParams, 1);
+
+			replica.pipeline->launch<ChunkedParams>(stream, replica.launchParams, replica.sbt, range.count);
+		});
+
+		//	Gather the counts of all devices: every global index is launched exactly once.
+		std::vector<unsigned int> counts(count + 1, 0), deviceCounts(count + 1);
+		size_t launched = 0;
+
+		for (const auto & range : ranges)
+		{
+			if (range.count != 0)
+			{
+				auto & replica = *replicas[range.device];
+
+				multiContext.context(range.device)->device()->defaultStream().memcpy(deviceCounts.data(), replica.counts.data(), count + 1).sync();
+
+				for (size_t i = 0; i <= count; i++)
+				{
+					counts[i] += deviceCounts[i];
+				}
+			}
+
+			assert(range.offset == launched);
+
+			launched += range.count;
+		}
+
+		assert(launched == count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			assert(counts[i] == 1);
+		}
+
+		assert(counts[count] == 0);
+	}
+
+	for (double throughput : multiContext.throughputs())
+	{
+		assert(throughput > 0.0);
+	}
+
+	//	Shares follow the throughputs.
+	multiContext.setThroughput(0, 1.0);
+	multiContext.setThroughput(1, 2.0);
+	multiContext.setThroughput(2, 1.0);
+
+	ranges = multiContext.split(400);
+
+	assert((ranges[0].count == 100) && (ranges[1].count == 200) && (ranges[2].count == 100));
+
+	ranges = multiContext.split(1);
+
+	assert(ranges[0].count + ranges[1].count + ranges[2].count == 1);
+}
\ No newline at end of file
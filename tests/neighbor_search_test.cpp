@@ -0,0 +1,133 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <cmath>
+#include <random>
+#include <iterator>
+#include <algorithm>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/device_context.h>
+#include <photon/neighbor_search.h>
+
+/*********************************************************************************
+***************************    neighbor_search_test    ***************************
+*********************************************************************************/
+
+void neighbor_search_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	//	Non-uniform distribution: dense cluster plus sparse background.
+	const size_t count = 3000;
+	std::default_random_engine e;
+	std::uniform_real_distribution<float> d;
+	std::normal_distribution<float> n(0.5f, 0.02f);
+	std::vector<ns::float3_16a> points(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		points[i] = (i % 2 == 0) ? ns::float3_16a{ n(e), n(e), n(e) } : ns::float3_16a{ d(e), d(e), d(e) };
+	}
+
+	ns::Array<ns::float3_16a> devPoints(allocator, count);
+	stream.memcpy(devPoints.data(), points.data(), count);
+
+	auto neighborSearch = deviceContext->createNeighborSearch();
+
+	for (unsigned int maxNeighbors : { 0u, 8u })
+	{
+		pt::NeighborSearch::BuildInput buildInput;
+		buildInput.positions = devPoints;
+		buildInput.numPoints = static_cast<unsigned int>(count);
+		buildInput.maxNeighbors = maxNeighbors;
+		buildInput.radius = 2e-2f;
+		neighborSearch->build(stream, allocator, buildInput);
+		neighborSearch->refit(stream);
+
+		auto & result = neighborSearch->search(stream);
+		std::vector<unsigned int> offsets(count + 1);
+		std::vector<unsigned int> indices(result.numIndices);
+		stream.memcpy(offsets.data(), result.offsets.data(), offsets.size());
+		stream.memcpy(indices.data(), result.indices.data(), indices.size()).sync();
+
+		assert(offsets[0] == 0);
+		assert(offsets[count] == result.numIndices);
+
+		const float r2 = buildInput.radius * buildInput.radius;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			//	Same predicate as the kernel, but the device may contract the sum into FMAs: pairs within
+			//	rounding of the radius may go either way and are left out of the comparison.
+			std::vector<unsigned int> expected, boundary;
+
+			for (size_t j = 0; j < count; j++)
+			{
+				float dx = points[j].x - points[i].x;
+				float dy = points[j].y - points[i].y;
+				float dz = points[j].z - points[i].z;
+				float d2 = dx * dx + dy * dy + dz * dz;
+
+				if (i == j)
+				{
+					continue;
+				}
+				else if (std::abs(d2 - r2) <= 1e-5f * r2)
+				{
+					boundary.push_back(static_cast<unsigned int>(j));
+				}
+				else if (d2 < r2)
+				{
+					expected.push_back(static_cast<unsigned int>(j));
+				}
+			}
+
+			std::vector<unsigned int> actual(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]);
+			std::sort(actual.begin(), actual.end());
+
+			assert(std::adjacent_find(actual.begin(), actual.end()) == actual.end());
+
+			std::vector<unsigned int> strict;
+			std::set_difference(actual.begin(), actual.end(), boundary.begin(), boundary.end(), std::back_inserter(strict));
+
+			//	Capped lists hold any `maxNeighbors` of the neighbors.
+			if (maxNeighbors != 0)
+			{
+				assert(actual.size() >= std::min<size_t>(expected.size(), maxNeighbors));
+				assert(actual.size() <= std::min<size_t>(expected.size() + boundary.size(), maxNeighbors));
+				assert(std::includes(expected.begin(), expected.end(), strict.begin(), strict.end()));
+			}
+			else
+			{
+				assert(strict == expected);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <cmath>
+#include <random>
+#include <cassert>
+#include <algorithm>
+
+#include <photon/payload_codec.h>
+
+/*********************************************************************************
+****************************    payload_codec_test    ****************************
+*********************************************************************************/
+
+void payload_codec_test()
+{
+	std::default_random_engine e;
+	std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+
+	//	Octahedral unit vectors: angular error must stay below 1e-4 radians.
+	static_assert(pt::PayloadCodec<pt::OctNormal>::numSlots == 1);
+
+	for (int i = 0; i < 100000; i++)
+	{
+		float3 n = { d(e), d(e), d(e) };
+		float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+
+		if (length < 1e-3f)		continue;
+
+		n = float3{ n.x / length, n.y / length, n.z / length };
+
+		unsigned int slot = 0;
+		pt::PayloadCodec<pt::OctNormal>::encode(n, &slot);
+		float3 r = pt::PayloadCodec<pt::OctNormal>::decode(&slot);
+
+		double cx = double(n.y) * r.z - double(n.z) * r.y;
+		double cy = double(n.z) * r.x - double(n.x) * r.z;
+		double cz = double(n.x) * r.y - double(n.y) * r.x;
+		double cosine = double(n.x) * r.x + double(n.y) * r.y + double(n.z) * r.z;
+		assert(std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), cosine) < 1e-4);
+	}
+
+	for (float3 n : { float3{ 0, 0, 1 }, float3{ 0, 0, -1 }, float3{ 1, 0, 0 }, float3{ 0, -1, 0 } })
+	{
+		unsigned int slot = 0;
+		pt::PayloadCodec<pt::OctNormal>::encode(n, &slot);
+		float3 r = pt::PayloadCodec<pt::OctNormal>::decode(&slot);
+		assert(std::abs(r.x - n.x) < 1e-4f && std::abs(r.y - n.y) < 1e-4f && std::abs(r.z - n.z) < 1e-4f);
+	}
+
+	//	Half precision: relative error within half an ulp (2^-11), exact for representable values.
+	static_assert(pt::PayloadCodec<pt::Half2>::numSlots == 1);
+
+	for (int i = 0; i < 100000; i++)
+	{
+		float2 v = { d(e) * 1000.0f, d(e) * 1e-3f };
+
+		unsigned int slot = 0;
+		pt::PayloadCodec<pt::Half2>::encode(v, &slot);
+		float2 r = pt::PayloadCodec<pt::Half2>::decode(&slot);
+
+		assert(std::abs(r.x - v.x) <= std::abs(v.x) * 0x1p-11f);
+		assert(std::abs(r.y - v.y) <= std::max(std::abs(v.y) * 0x1p-11f, 0x1p-25f));
+	}
+
+	for (float x : { 0.0f, 1.0f, -2.5f, 0.25f, 65504.0f, 0x1p-24f })
+	{
+		unsigned int slot = 0;
+		pt::PayloadCodec<pt::Half2>::encode(float2{ x, -x }, &slot);
+		float2 r = pt::PayloadCodec<pt::Half2>::decode(&slot);
+		assert(r.x == x && r.y == -x);
+	}
+
+	assert(pt::details::floatToHalf(1.0f) == 0x3C00);
+	assert(pt::details::floatToHalf(65520.0f) == 0x7C00);
+	assert(pt::details::floatToHalf(1.0f + 0x1p-11f) == 0x3C00);				//	tie, rounds to even
+	assert(pt::details::floatToHalf(1.0f + 3 * 0x1p-11f) == 0x3C02);			//	tie, rounds to even
+	assert(std::isnan(pt::details::halfToFloat(pt::details::floatToHalf(NAN))));
+
+	//	Bitfields: exact round trip, values truncated to their width.
+	using Codec = pt::PayloadCodec<pt::Bitfield<1, 7, 24>>;
+
+	static_assert(Codec::numSlots == 1);
+
+	for (unsigned int i = 0; i < 1000; i++)
+	{
+		Codec::value_type fields = {};
+		fields[0] = i & 1;
+		fields[1] = i % 128;
+		fields[2] = i * 16777;
+
+		unsigned int slot = 0;
+		Codec::encode(fields, &slot);
+		Codec::value_type r = Codec::decode(&slot);
+
+		assert(r[0] == fields[0] && r[1] == fields[1] && r[2] == (fields[2] & 0xFFFFFFu));
+	}
+
+	Codec::value_type full = {};
+	full[0] = 1;		full[1] = 127;		full[2] = 0xFFFFFF;
+	unsigned int slot = 0;
+	Codec::encode(full, &slot);
+	assert(slot == 0xFFFFFFFFu);
+
+	//	Raw codec: bitwise copy.
+	float3 p = { 1.0f, -2.0f, 3.5f };
+	unsigned int slots[pt::PayloadCodec<float3>::numSlots] = {};
+	pt::PayloadCodec<float3>::encode(p, slots);
+	float3 q = pt::PayloadCodec<float3>::decode(slots);
+	assert(q.x == p.x && q.y == p.y && q.z == p.z);
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <vector>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/pipeline.h>
+#include <photon/payload_layout.h>
+#include <photon/device_context.h>
+
+#include "launch_params.h"
+#include "payload_test.optixir.h"
+
+/*********************************************************************************
+***************************    payload_layout_test    ****************************
+*********************************************************************************/
+
+#if OPTIX_VERSION >= 70400
+
+namespace
+{
+	constexpr unsigned int ReadWriteAll = OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_READ_WRITE | OPTIX_PAYLOAD_SEMANTICS_CH_READ_WRITE |
+										  OPTIX_PAYLOAD_SEMANTICS_MS_READ_WRITE | OPTIX_PAYLOAD_SEMANTICS_AH_READ_WRITE | OPTIX_PAYLOAD_SEMANTICS_IS_READ_WRITE;
+
+	using RayDir = pt::Payload<float3, 0, 1, 2>;
+	using Depth = pt::Payload<unsigned int, 5>;
+	using Flags = pt::Payload<unsigned int, 0>;
+
+	using Layout = pt::PayloadLayout<pt::PayloadField<RayDir, OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_READ | OPTIX_PAYLOAD_SEMANTICS_MS_WRITE>,
+									 pt::PayloadField<Depth, OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_WRITE | OPTIX_PAYLOAD_SEMANTICS_CH_READ>,
+									 pt::PayloadField<Flags, OPTIX_PAYLOAD_SEMANTICS_CH_WRITE>>;
+
+	static_assert(Layout::numPayloadValues == 6);
+	static_assert(Layout::semantics[0] == (OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_READ | OPTIX_PAYLOAD_SEMANTICS_MS_WRITE | OPTIX_PAYLOAD_SEMANTICS_CH_WRITE));
+	static_assert(Layout::semantics[2] == (OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_READ | OPTIX_PAYLOAD_SEMANTICS_MS_WRITE));
+	static_assert(Layout::semantics[3] == 0);
+	static_assert(Layout::semantics[4] == 0);
+	static_assert(Layout::semantics[5] == (OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_WRITE | OPTIX_PAYLOAD_SEMANTICS_CH_READ));
+
+	struct PathHistory { float3 vertices[32]; };
+
+	using PathPayload = pt::LargePayload<float3, PathHistory, 6>;		//	hot: 6-8, cold pointer: 9-10
+
+	using SpillLayout = pt::PayloadLayout<pt::PayloadField<Depth, OPTIX_PAYLOAD_SEMANTICS_TRACE_CALLER_WRITE | OPTIX_PAYLOAD_SEMANTICS_CH_READ>,
+										  pt::PayloadField<PathPayload, ReadWriteAll>>;
+
+	static_assert(SpillLayout::numPayloadValues == 11);
+	static_assert(SpillLayout::semantics[0] == 0);
+	static_assert(SpillLayout::semantics[6] == ReadWriteAll);
+	static_assert(SpillLayout::semantics[10] == ReadWriteAll);
+}
+
+void payload_layout_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto context = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	OptixPipelineCompileOptions pipelineCompileOptions = {};
+	pipelineCompileOptions.pipelineLaunchParamsVariableName = "reorderParams";
+	pipelineCompileOptions.numPayloadValues = 0;
+	pipelineCompileOptions.numAttributeValues = 2;				//	OctNormal + Half2 reported by __intersection__
+
+	using ProgramLayout = pt::PayloadLayout<pt::PayloadField<RayDir, ReadWriteAll>>;
+
+	auto module = context->createModule(payload_test_optixir, pipelineCompileOptions, { ProgramLayout::payloadType() });
+
+	auto raygen = module->at("__raygen__", 0);
+	auto miss0 = module->at("__miss__", 0);
+	auto miss1 = module->at("__miss__");
+	auto invalid = module->at("__miss__", 1);				//	error: only one payload type
+
+	assert(raygen != nullptr);
+	assert(miss0 != nullptr);
+	assert(miss0 == miss1);
+	assert(invalid == nullptr);
+
+	pt::Pipeline pipeline(context, { raygen, miss0 }, pipelineCompileOptions);
+
+	//	Shader execution reordering where supported, and the plain trace fallback.
+	auto reorderRaygen = module->at("__raygen__reorder", 0);
+
+	ns::Array<pt::EmptyRecord>		raygenRecord(allocator, 1);
+	ns::Array<pt::EmptyRecord>		missRecord(allocator, 1);
+	ns::Array<ReorderParams>		reorderParams(allocator, 1);
+	ns::Array<float>				results(allocator, 256);
+
+	stream.memcpy<void>(raygenRecord.data(), reorderRaygen->header().storage, sizeof(pt::SbtHeader));
+	stream.memcpy<void>(missRecord.data(), miss0->header().storage, sizeof(pt::SbtHeader));
+
+	OptixShaderBindingTable sbt = {};
+	sbt.raygenRecord = CUdeviceptr(raygenRecord.data());
+	sbt.missRecordBase = CUdeviceptr(missRecord.data());
+	sbt.missRecordStrideInBytes = sizeof(pt::EmptyRecord);
+	sbt.missRecordCount = 1;
+
+	pt::Pipeline reorderPipeline(context, { reorderRaygen, miss0 }, pipelineCompileOptions);
+
+	for (bool enableReorder : { context->supportsShaderExecutionReordering(), false })
+	{
+		ReorderParams params = {};
+		params.handle = 0;
+		params.results = results.data();
+		params.enableReorder = enableReorder;
+
+		stream.memcpy(reorderParams.data(), &params, 1);
+		stream.memset(results.data(), 0, results.bytes());
+
+		reorderPipeline.launch<ReorderParams>(stream, reorderParams, sbt, results.size());
+
+		std::vector<float> hostResults(results.size());
+		stream.memcpy(hostResults.data(), results.data(), results.size()).sync();
+
+		for (float result : hostResults)
+		{
+			assert(result == 2.0f);
+		}
+	}
+}
+
+#else
+
+void payload_layout_test() {}
+
+#endif
\ No newline at end of file
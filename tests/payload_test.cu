@@ -22,8 +22,20 @@
 #pragma once
 
 #include <photon/payload.cuh>
+#include <photon/reorder.cuh>
+#include <photon/ray_types.h>
+#include <photon/hit_attributes.cuh>
+#include "launch_params.h"
+
+struct PrimaryRay {};
+
+using RayTypes = pt::RayTypeTable<PrimaryRay>;
 
 using RayDirType = pt::Payload<float3, 0, 1, 2>;
+using NormalAttribute = pt::HitAttributes<pt::OctNormal, 0>;
+using UVAttribute = pt::HitAttributes<pt::Half2, 1>;
+
+__RT_CONSTANT__ ReorderParams reorderParams;
 
 /*********************************************************************************
 *********************************    kernels    **********************************
@@ -38,6 +50,23 @@ __RT_KERNEL__ void __raygen__()
 }
 
 
+__RT_KERNEL__ void __raygen__reorder()
+{
+	const unsigned int index = optixGetLaunchIndex().x;
+
+	//	Both rays miss, the miss program writes (0, 1, 0) whether the threads are reordered or not.
+	RayDirType rayDir0 = float3{ 0, 0, 0 };
+	pt::trace_reordered<RayTypes::Ray<PrimaryRay>>(reorderParams.enableReorder, index % 16, 4, reorderParams.handle, float3{ 0, 0, 0 }, float3{ 0, 0, 1 }, 0.0f, 1e16f, rayDir0);
+
+	RayDirType rayDir1 = float3{ 0, 0, 0 };
+	pt::traverse<RayTypes::Ray<PrimaryRay>>(reorderParams.handle, float3{ 0, 0, 0 }, float3{ 0, 0, 1 }, 0.0f, 1e16f, rayDir1);
+	pt::reorder();
+	pt::invoke(rayDir1);
+
+	reorderParams.results[index] = rayDir0.get().y + rayDir1.get().y;
+}
+
+
 __RT_KERNEL__ void __miss__()
 {
 	pt::set_payload<0>(0);
@@ -46,4 +75,18 @@ __RT_KERNEL__ void __miss__()
 	auto rayDir = pt::get_payload<RayDirType>();
 	rayDir = float3{ 0, 1, 0 };
 	pt::set_payload(rayDir);
+}
+
+
+__RT_KERNEL__ void __intersection__()
+{
+	pt::report_intersection(1.0f, 0, NormalAttribute(float3{ 0, 0, 1 }), UVAttribute(float2{ 0.5f, 0.5f }));
+}
+
+
+__RT_KERNEL__ void __closesthit__()
+{
+	float3 normal = pt::get_attributes<NormalAttribute>();
+	float2 uv = pt::get_attributes<pt::Half2, 1>();
+	pt::set_payload(RayDirType(float3{ normal.x * uv.x, normal.y * uv.y, normal.z }));
 }
\ No newline at end of file
@@ -69,6 +69,7 @@ void pipeline_test()
 	OptixBuiltinISOptions builtinISOptions = {};
 	builtinISOptions.builtinISModuleType = OPTIX_PRIMITIVE_TYPE_SPHERE;
 	auto program14 = context->getBuiltinISProgram(builtinISOptions, pipelineCompileOptions);
+	auto program15 = context->getBuiltinISProgram(builtinISOptions, pipelineCompileOptions);		//	cached
 
 	assert(program0 == nullptr);
 	assert(program1 == nullptr);
@@ -83,6 +84,7 @@ void pipeline_test()
 	assert(program10 != nullptr);
 	assert(program11 != nullptr);
 	assert(program14 != nullptr);
+	assert(program15 == program14);
 
 	assert(program2->type() == pt::Program::Raygen);
 	assert(program3->type() == pt::Program::Raygen);
@@ -109,4 +111,16 @@ void pipeline_test()
 
 	pt::Pipeline pipeline = pt::Pipeline(context, { program2, program9, program11, program14 }, pipelineCompileOptions);
 	pipeline.launch<LaunchParams>(stream, launchParams, sbt, 10, 1).sync();
+
+	//	Linking is cached for the same programs and options only.
+	{
+		pt::Pipeline samePipeline(context, { program2, program9, program11, program14 }, pipelineCompileOptions);
+		pt::Pipeline otherPipeline(context, { program2, program9, program11 }, pipelineCompileOptions);
+
+		assert(pipeline.handle() != nullptr);
+		assert(samePipeline.handle() == pipeline.handle());
+		assert(otherPipeline.handle() != pipeline.handle());
+	}
+
+	pipeline.launch<LaunchParams>(stream, launchParams, sbt, 10, 1).sync();
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/pipeline.h>
+#include <photon/profiler.h>
+#include <photon/denoiser.h>
+#include <photon/accel_struct.h>
+#include <photon/device_context.h>
+
+#include "launch_params.h"
+#include "rt_program.optixir.h"
+
+/*********************************************************************************
+******************************    profiler_test    *******************************
+*********************************************************************************/
+
+void profiler_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+	auto profiler = deviceContext->profiler();
+
+	assert(profiler != nullptr);
+
+	int object = 0;
+
+	profiler->setEnabled(false);
+	{
+		pt::Profiler::Scope scope(profiler, stream, "disabled", &object);
+	}
+	assert(profiler->stats().empty());
+
+	profiler->setEnabled(true);
+	profiler->setLabel(&object, "object");
+
+	for (int i = 0; i < 3; i++)
+	{
+		pt::Profiler::Scope scope(profiler, stream, "enabled", &object);
+	}
+
+	auto stats = profiler->stats();
+	assert(stats.size() == 1);
+	assert(stats[0].operation == "enabled");
+	assert(stats[0].object == "object");
+	assert(stats[0].count == 3);
+	assert(stats[0].minMs <= stats[0].meanMs() && stats[0].meanMs() <= stats[0].maxMs);
+	assert(profiler->writeChromeTrace("profiler_test.json"));
+
+	//	Operations recorded by the library itself: an accel build, a pipeline launch and a denoiser invoke.
+	profiler->reset();
+	{
+		std::vector<ns::float3_16a> vertices = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+		std::vector<ns::int3_16a> triangles = { { 0, 1, 2 } };
+
+		ns::Array<ns::float3_16a> devVertices(allocator, vertices.size());
+		ns::Array<ns::int3_16a> devTriangles(allocator, triangles.size());
+		stream.memcpy(devVertices.data(), vertices.data(), vertices.size());
+		stream.memcpy(devTriangles.data(), triangles.data(), triangles.size());
+
+		auto accelStruct = deviceContext->createAccelStructTriangle();
+
+		pt::AccelStructTriangle::BuildInput buildInput;
+		buildInput.vertexBuffer = devVertices;
+		buildInput.indexBuffer = devTriangles;
+		buildInput.numVertices = static_cast<unsigned int>(vertices.size());
+		buildInput.numIndexTriplets = static_cast<unsigned int>(triangles.size());
+		accelStruct->build(stream, allocator, buildInput, 0, false, false);
+
+		OptixPipelineCompileOptions pipelineCompileOptions = {};
+		pipelineCompileOptions.usesPrimitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_SPHERE;
+		pipelineCompileOptions.pipelineLaunchParamsVariableName = "chunkedParams";
+
+		auto module = deviceContext->createModule(rt_program_optixir, pipelineCompileOptions);
+		auto raygenProg = module->at("__raygen__chunked");
+		auto missProg = module->at("__miss__");
+
+		ns::Array<pt::EmptyRecord>		raygenRecord(allocator, 1);
+		ns::Array<pt::EmptyRecord>		missRecord(allocator, 1);
+		stream.memcpy<void>(raygenRecord.data(), raygenProg->header().storage, sizeof(pt::SbtHeader));
+		stream.memcpy<void>(missRecord.data(), missProg->header().storage, sizeof(pt::SbtHeader));
+
+		OptixShaderBindingTable sbt = {};
+		sbt.raygenRecord = CUdeviceptr(raygenRecord.data());
+		sbt.missRecordBase = CUdeviceptr(missRecord.data());
+		sbt.missRecordStrideInBytes = sizeof(pt::EmptyRecord);
+		sbt.missRecordCount = 1;
+
+		pt::Pipeline pipeline(deviceContext, { raygenProg, missProg }, pipelineCompileOptions);
+
+		profiler->setLabel(&pipeline, "pipeline");
+
+		const size_t count = 64;
+
+		ns::Array<unsigned int> counts(allocator, count + 1);
+		stream.memset(counts.data(), 0, counts.bytes());
+
+		ChunkedParams hostParams = {};
+		hostParams.chunk.offset = 0;
+		hostParams.chunk.count = count;
+		hostParams.counts = counts.data();
+		hostParams.count = count;
+
+		ns::Array<ChunkedParams> launchParams(allocator, 1);
+		stream.memcpy(launchParams.data(), &hostParams, 1);
+
+		pipeline.launch<ChunkedParams>(stream, launchParams, sbt, count);
+
+		const unsigned int width = 64, height = 64;
+
+		ns::Array<pt::Color4f> devImage(allocator, width * height);
+		ns::Array<pt::Color4f> devOutput(allocator, width * height);
+		stream.memset(devImage.data(), 0x3E, devImage.bytes());
+
+		pt::Denoiser::Image input, output;
+		input.data = devImage.data();
+		output.data = devOutput.data();
+		input.width = output.width = width;
+		input.height = output.height = height;
+		input.rowStrideInBytes = output.rowStrideInBytes = width * sizeof(pt::Color4f);
+		input.pixelStrideInBytes = output.pixelStrideInBytes = sizeof(pt::Color4f);
+
+		auto denoiser = deviceContext->createDenoiser();
+		denoiser->preallocate(allocator, pt::Denoiser::Normal, width, height, pt::Denoiser::GuideNone);
+		denoiser->launch(stream, output, input, nullptr, nullptr, nullptr, nullptr, nullptr, 0.0f);
+
+		auto stats = profiler->stats();
+
+		auto find = [&](const char * operation) -> const pt::Profiler::Stats *
+		{
+			auto iter = std::find_if(stats.begin(), stats.end(), [=](const pt::Profiler::Stats & s) { return s.operation == operation; });
+
+			return (iter != stats.end()) ? &*iter : nullptr;
+		};
+
+		assert((find("optixAccelBuild") != nullptr) && (find("optixAccelBuild")->count == 1));
+		assert((find("optixLaunch") != nullptr) && (find("optixLaunch")->count == 1));
+		assert(find("optixLaunch")->object == "pipeline");
+		assert((find("optixDenoiserComputeIntensity") != nullptr) && (find("optixDenoiserComputeIntensity")->count == 1));
+		assert((find("optixDenoiserInvoke") != nullptr) && (find("optixDenoiserInvoke")->count == 1));
+	}
+
+	profiler->reset();
+	profiler->setEnabled(false);
+	assert(profiler->stats().empty());
+
+	//	A trace written after a reset holds no entries, and no dangling separator.
+	assert(profiler->writeChromeTrace("profiler_test.json"));
+
+	std::ifstream file("profiler_test.json");
+	std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	assert(trace.find("\"traceEvents\":[\n]}") != std::string::npos);
+}
\ No newline at end of file
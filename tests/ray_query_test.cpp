@@ -0,0 +1,226 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/ray_query.h>
+#include <photon/accel_struct.h>
+#include <photon/device_context.h>
+
+/*********************************************************************************
+******************************    ray_query_test    ******************************
+*********************************************************************************/
+
+void ray_query_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	//	Unit square at z = 0, split along its diagonal.
+	std::vector<ns::float3_16a> vertices = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+	std::vector<ns::int3_16a> triangles = { { 0, 1, 2 }, { 0, 2, 3 } };
+
+	ns::Array<ns::float3_16a> devVertices(allocator, vertices.size());
+	ns::Array<ns::int3_16a> devTriangles(allocator, triangles.size());
+	stream.memcpy(devVertices.data(), vertices.data(), vertices.size());
+	stream.memcpy(devTriangles.data(), triangles.data(), triangles.size());
+
+	std::shared_ptr<pt::AccelStructTriangle> accelStruct = deviceContext->createAccelStructTriangle();
+
+	pt::AccelStructTriangle::BuildInput buildInput;
+	buildInput.vertexBuffer = devVertices;
+	buildInput.indexBuffer = devTriangles;
+	buildInput.numVertices = static_cast<unsigned int>(vertices.size());
+	buildInput.numIndexTriplets = static_cast<unsigned int>(triangles.size());
+	accelStruct->build(stream, allocator, buildInput, 0, true, false);
+
+	//	The same square translated by +2 along x, with an SBT offset so that two SBT entries are referenced.
+	pt::Mat4x4 transform = {};
+	transform.rows[0] = ns::float4{ 1.0f, 0.0f, 0.0f, 2.0f };
+	transform.rows[1] = ns::float4{ 0.0f, 1.0f, 0.0f, 0.0f };
+	transform.rows[2] = ns::float4{ 0.0f, 0.0f, 1.0f, 0.0f };
+	transform.rows[3] = ns::float4{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+	ns::Array<pt::Mat4x4> devTransform(allocator, 1);
+	stream.memcpy(devTransform.data(), &transform, 1);
+
+	auto instAccelStruct = deviceContext->createInstAccelStruct();
+
+	pt::InstAccelStruct::BuildInput instance;
+	instance.geomAccelStruct = accelStruct;
+	instance.transform = devTransform;
+	instance.instanceId = 7;
+	instance.sbtOffset = 1;
+	instAccelStruct->build(stream, allocator, instance, true, false);
+
+	//	A row of rays along x from -0.5 to 3.5 towards -z: hits inside [0, 1] and [2, 3] only.
+	const size_t count = 17;
+	std::vector<ns::float3> origins(count), directions(count, ns::float3{ 0.0f, 0.0f, -1.0f });
+	std::vector<float> tmaxs(count, 1e16f);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		origins[i] = ns::float3{ -0.5f + 0.25f * i + 0.01f, 0.3f, 1.0f };
+	}
+
+	//	Would hit the square at t = 1 (in the GAS and the IAS respectively), but it is out of range.
+	tmaxs[3] = tmaxs[11] = 0.5f;
+
+	auto expect = [&](size_t i, bool instanced, float t, unsigned int primIndex, unsigned int instanceId, ns::float2 barycentrics)
+	{
+		const float x = origins[i].x - (instanced ? 2.0f : 0.0f);
+		const float y = origins[i].y;
+		const bool hit = (x > 0.0f) && (x < 1.0f) && (tmaxs[i] > 1.0f);
+
+		if (!hit)
+		{
+			assert(t == pt::RayQueryEngine::missDistance);
+			assert(primIndex == pt::RayQueryEngine::invalidIndex);
+			assert(instanceId == pt::RayQueryEngine::invalidIndex);
+
+			return;
+		}
+
+		const ns::int3_16a triangle = triangles[primIndex];
+		const ns::float3_16a v0 = vertices[triangle.x], v1 = vertices[triangle.y], v2 = vertices[triangle.z];
+		const float w = 1.0f - barycentrics.x - barycentrics.y;
+
+		assert(std::abs(t - 1.0f) < 1e-5f);
+		assert(primIndex == ((y < x) ? 0u : 1u));
+		assert(instanceId == (instanced ? 7u : pt::RayQueryEngine::invalidIndex));
+		assert(std::abs(w * v0.x + barycentrics.x * v1.x + barycentrics.y * v2.x - x) < 1e-5f);
+		assert(std::abs(w * v0.y + barycentrics.x * v1.y + barycentrics.y * v2.y - y) < 1e-5f);
+	};
+
+	auto rayQueryEngine = deviceContext->createRayQueryEngine();
+
+	//	Device buffers, against the GAS and the IAS.
+	{
+		ns::Array<ns::float3> devOrigins(allocator, count);
+		ns::Array<ns::float3> devDirections(allocator, count);
+		ns::Array<float> devTmaxs(allocator, count);
+		ns::Array<float> devT(allocator, count);
+		ns::Array<unsigned int> devPrimIndices(allocator, count);
+		ns::Array<unsigned int> devInstanceIds(allocator, count);
+		ns::Array<ns::float2> devBarycentrics(allocator, count);
+		stream.memcpy(devOrigins.data(), origins.data(), count);
+		stream.memcpy(devDirections.data(), directions.data(), count);
+		stream.memcpy(devTmaxs.data(), tmaxs.data(), count);
+
+		pt::RayQueryEngine::Rays rays;
+		rays.origins = devOrigins;
+		rays.directions = devDirections;
+		rays.tmaxs = devTmaxs;
+		rays.count = count;
+
+		pt::RayQueryEngine::Hits hits;
+		hits.t = devT;
+		hits.primIndices = devPrimIndices;
+		hits.instanceIds = devInstanceIds;
+		hits.barycentrics = devBarycentrics;
+
+		for (bool instanced : { false, true })
+		{
+			if (instanced)		rayQueryEngine->query(stream, instAccelStruct->handle(), rays, hits, 2);
+			else				rayQueryEngine->query(stream, accelStruct->handle(), rays, hits);
+
+			std::vector<float> t(count);
+			std::vector<unsigned int> primIndices(count), instanceIds(count);
+			std::vector<ns::float2> barycentrics(count);
+			stream.memcpy(t.data(), devT.data(), count);
+			stream.memcpy(primIndices.data(), devPrimIndices.data(), count);
+			stream.memcpy(instanceIds.data(), devInstanceIds.data(), count);
+			stream.memcpy(barycentrics.data(), devBarycentrics.data(), count).sync();
+
+			for (size_t i = 0; i < count; i++)
+			{
+				expect(i, instanced, t[i], primIndices[i], instanceIds[i], barycentrics[i]);
+			}
+		}
+	}
+
+	//	Host buffers, streamed in several batches (the last one partial).
+	{
+		std::vector<float> t(count);
+		std::vector<unsigned int> primIndices(count), instanceIds(count);
+		std::vector<ns::float2> barycentrics(count);
+
+		pt::RayQueryEngine::HostRays rays;
+		rays.origins = origins.data();
+		rays.directions = directions.data();
+		rays.tmaxs = tmaxs.data();
+		rays.count = count;
+
+		pt::RayQueryEngine::HostHits hits;
+		hits.t = t.data();
+		hits.primIndices = primIndices.data();
+		hits.instanceIds = instanceIds.data();
+		hits.barycentrics = barycentrics.data();
+
+		for (size_t batchSize : { size_t(4), size_t(5), size_t(64) })
+		{
+			rayQueryEngine->setBatchSize(batchSize);
+			assert(rayQueryEngine->batchSize() == batchSize);
+
+			rayQueryEngine->queryHost(stream, instAccelStruct->handle(), rays, hits, 2);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				expect(i, true, t[i], primIndices[i], instanceIds[i], barycentrics[i]);
+			}
+		}
+
+		//	Unrequested attributes are left untouched.
+		std::fill(primIndices.begin(), primIndices.end(), 123u);
+		hits.primIndices = nullptr;
+
+		rayQueryEngine->queryHost(stream, accelStruct->handle(), rays, hits);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			expect(i, false, t[i], (t[i] == pt::RayQueryEngine::missDistance) ? pt::RayQueryEngine::invalidIndex : ((origins[i].y < origins[i].x) ? 0u : 1u), instanceIds[i], barycentrics[i]);
+
+			assert(primIndices[i] == 123u);
+		}
+	}
+
+	bool thrown = false;
+
+	try
+	{
+		rayQueryEngine->setBatchSize(0);
+	}
+	catch (OptixResult)
+	{
+		thrown = true;
+	}
+
+	assert(thrown);
+}
\ No newline at end of file
@@ -29,6 +29,8 @@
 
 __RT_CONSTANT__ LaunchParams launchParams;
 
+__RT_CONSTANT__ ChunkedParams chunkedParams;
+
 /*********************************************************************************
 *********************************    kernels    **********************************
 *********************************************************************************/
@@ -41,6 +43,15 @@ __RT_KERNEL__ void __raygen__()
 }
 
 
+__RT_KERNEL__ void __raygen__chunked()
+{
+	const unsigned long long index = chunkedParams.chunk.offset + optixGetLaunchIndex().x;
+	const bool valid = (optixGetLaunchDimensions().x == chunkedParams.chunk.count) && (index < chunkedParams.count);
+
+	atomicAdd(&chunkedParams.counts[valid ? index : chunkedParams.count], 1u);
+}
+
+
 __RT_KERNEL__ void __anyhit__()
 {
 
@@ -0,0 +1,148 @@
+/**
+ *	Copyright (c) 2025 Wenchao Huang <physhuangwenchao@gmail.com>
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <nucleus/device.h>
+#include <nucleus/stream.h>
+#include <nucleus/context.h>
+#include <nucleus/array_1d.h>
+
+#include <photon/aabb_utils.h>
+#include <photon/accel_struct.h>
+#include <photon/spatial_sort.h>
+#include <photon/device_context.h>
+
+/*********************************************************************************
+****************************    spatial_sort_test    *****************************
+*********************************************************************************/
+
+void spatial_sort_test()
+{
+	auto device = ns::Context::getInstance()->device(0);
+	auto deviceContext = pt::SharedContext(device);
+	auto allocator = device->defaultAllocator();
+	auto & stream = device->defaultStream();
+
+	const unsigned int count = 50000;
+	std::default_random_engine e;
+	std::uniform_real_distribution<float> d(-10.0f, 10.0f);
+	std::vector<ns::float3_16a> points(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		points[i] = ns::float3_16a{ d(e), d(e), d(e) };
+	}
+
+	ns::Array<ns::float3_16a>		devPoints(allocator, count);
+	ns::Array<ns::float3_16a>		devSorted(allocator, count);
+	ns::Array<ns::float3_16a>		devRestored(allocator, count);
+	stream.memcpy(devPoints.data(), points.data(), count);
+
+	auto spatialSort = deviceContext->createSpatialSort();
+
+	//	Mean distance between consecutive points, in input or in sorted order.
+	auto meanStep = [&](const std::vector<unsigned int> & order)
+	{
+		double sum = 0.0;
+
+		for (unsigned int i = 1; i < count; i++)
+		{
+			const auto & a = points[order[i - 1]];
+			const auto & b = points[order[i]];
+
+			sum += std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+		}
+
+		return sum / (count - 1);
+	};
+
+	std::vector<unsigned int> identity(count);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		identity[i] = i;
+	}
+
+	const double randomStep = meanStep(identity);
+
+	for (auto curve : { pt::SpatialSort::Morton, pt::SpatialSort::Hilbert })
+	{
+		spatialSort->sort(stream, allocator, devPoints, count, curve);
+		assert(spatialSort->size() == count);
+
+		std::vector<uint64_t> keys(count);
+		std::vector<unsigned int> permutation(count);
+		stream.memcpy(keys.data(), spatialSort->sortedKeys().data(), count);
+		stream.memcpy(permutation.data(), spatialSort->permutation().data(), count).sync();
+
+		assert(std::is_sorted(keys.begin(), keys.end()));
+
+		std::vector<unsigned int> sortedPermutation = permutation;
+		std::sort(sortedPermutation.begin(), sortedPermutation.end());
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			assert(sortedPermutation[i] == i);
+		}
+
+		//	Neighbors along the curve are close in space: ~0.5 apart on average, against ~10 in random order.
+		assert(meanStep(permutation) < 0.2 * randomStep);
+
+		//	gather + scatter is the identity.
+		spatialSort->gather(stream, devSorted.ptr(), devPoints.ptr());
+		spatialSort->scatter(stream, devRestored.ptr(), devSorted.ptr());
+
+		std::vector<ns::float3_16a> sorted(count), restored(count);
+		stream.memcpy(sorted.data(), devSorted.data(), count);
+		stream.memcpy(restored.data(), devRestored.data(), count).sync();
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			assert(sorted[i].x == points[permutation[i]].x);
+			assert(restored[i].x == points[i].x && restored[i].y == points[i].y && restored[i].z == points[i].z);
+		}
+	}
+
+	//	Remap stored in the GAS header.
+	ns::Array<pt::Aabb> devAabbs(allocator, count);
+	pt::AabbSource source;
+	source.vertexBuffer = devSorted;
+	source.radius = 1e-2f;
+	source.numPrimitives = count;
+	pt::computeAabbs(stream, devAabbs, source);
+
+	auto accelStruct = deviceContext->createAccelStructAabb();
+	pt::AccelStructAabb::BuildInput buildInput;
+	buildInput.aabbBuffer = devAabbs;
+	buildInput.numPrimitives = count;
+	accelStruct->build(stream, allocator, buildInput, pt::SpatialSort::remapHeaderSize(count), true, false);
+	spatialSort->writeRemap(stream, *accelStruct);
+
+	std::vector<unsigned int> header(count), permutation(count);
+	stream.memcpy(header.data(), reinterpret_cast<const unsigned int*>(accelStruct->headerBuffer().data()), count);
+	stream.memcpy(permutation.data(), spatialSort->permutation().data(), count).sync();
+
+	assert(header == permutation);
+}
\ No newline at end of file